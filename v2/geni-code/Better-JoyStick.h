@@ -1,13 +1,37 @@
+#pragma once
+
+#include "settings.h"
+#include "constants.h"
+
+// Set from the ADC continuous-mode ISR, cleared by poll()
+volatile bool jsAdcFrameReady = false;
+
+void ARDUINO_ISR_ATTR onJoystickAdcFrame() {
+  jsAdcFrameReady = true;
+}
+
 class BetterJoystick {
 private:
-  const int X_CENTER = 3250;
-  const int Y_CENTER = 3500;
   const int DEADZONE = 100;
 
   byte JS_SW = 0;
   byte JS_VRX = 0;
   byte JS_VRY = 0;
 
+  // Rest-position centers, Q4 fixed point (x16) so slow tracking doesn't round away
+  int32_t xCenterQ4 = JS_DEFAULT_X_CENTER << 4;
+  int32_t yCenterQ4 = JS_DEFAULT_Y_CENTER << 4;
+  int savedXCenter = JS_DEFAULT_X_CENTER;
+  int savedYCenter = JS_DEFAULT_Y_CENTER;
+  unsigned long lastCalibrationSave = 0;
+
+  // Filtered axis values (Q4), refreshed from the DMA frames
+  int32_t xFilteredQ4 = JS_DEFAULT_X_CENTER << 4;
+  int32_t yFilteredQ4 = JS_DEFAULT_Y_CENTER << 4;
+  bool continuousAdc = false;  // false -> fallback to blocking analogRead()
+
+  Settings* settings = nullptr;
+
   // Function to get more accurate mapped values
   int mapJoystick(int value, int center) {
     if (abs(value - center) < DEADZONE) return 0;
@@ -24,29 +48,104 @@ private:
     }
   }
 
+  // Center follows the filtered value only while the stick is at rest, so
+  // temperature / supply drift is tracked but a held deflection is not
+  void trackCenter(int32_t filteredQ4, int32_t& centerQ4) {
+    if (abs((filteredQ4 - centerQ4) >> 4) >= DEADZONE) return;
+    centerQ4 += (filteredQ4 - centerQ4) >> JS_CENTER_TRACK_SHIFT;
+  }
+
+  void applySample(int rawX, int rawY) {
+    xFilteredQ4 += ((rawX << 4) - xFilteredQ4) >> JS_FILTER_SHIFT;
+    yFilteredQ4 += ((rawY << 4) - yFilteredQ4) >> JS_FILTER_SHIFT;
+    trackCenter(xFilteredQ4, xCenterQ4);
+    trackCenter(yFilteredQ4, yCenterQ4);
+  }
+
+  // Persist the centers only once they've really moved, and not more than once per interval
+  void saveCalibrationIfDrifted() {
+    if (!settings) return;
+    int x = xCenterQ4 >> 4;
+    int y = yCenterQ4 >> 4;
+    if (abs(x - savedXCenter) < JS_CENTER_SAVE_DELTA && abs(y - savedYCenter) < JS_CENTER_SAVE_DELTA) return;
+    if (millis() - lastCalibrationSave < JS_CENTER_SAVE_INTERVAL) return;
+
+    lastCalibrationSave = millis();
+    savedXCenter = x;
+    savedYCenter = y;
+    settings->setJoystickCenter(x, y);
+  }
+
+  // Non-blocking: picks up the latest DMA frame if the ISR flagged one
+  void poll() {
+    if (!continuousAdc) {
+      applySample(analogRead(JS_VRX), analogRead(JS_VRY));
+      saveCalibrationIfDrifted();
+      return;
+    }
+    if (!jsAdcFrameReady) return;
+    jsAdcFrameReady = false;
+
+    adc_continuous_data_t* result = nullptr;
+    if (!analogContinuousRead(&result, 0)) return;
+
+    // avg_read_raw is already the mean of JS_ADC_OVERSAMPLE conversions per pin
+    int rawX = xFilteredQ4 >> 4;
+    int rawY = yFilteredQ4 >> 4;
+    for (int i = 0; i < 2; i++) {
+      if (result[i].pin == JS_VRX) rawX = result[i].avg_read_raw;
+      else if (result[i].pin == JS_VRY) rawY = result[i].avg_read_raw;
+    }
+    applySample(rawX, rawY);
+    saveCalibrationIfDrifted();
+  }
+
 
 public:
-  void begin(byte SW, byte VRX, byte VRY) {
+  void begin(byte SW, byte VRX, byte VRY, Settings* settingsStore = nullptr) {
     JS_SW = SW;
     JS_VRX = VRX;
     JS_VRY = VRY;
+    settings = settingsStore;
     pinMode(JS_SW, INPUT_PULLUP);
+
+    if (settings) {
+      savedXCenter = settings->get().jsCenterX;
+      savedYCenter = settings->get().jsCenterY;
+    }
+    xCenterQ4 = xFilteredQ4 = (int32_t)savedXCenter << 4;
+    yCenterQ4 = yFilteredQ4 = (int32_t)savedYCenter << 4;
+
+    // Both axes sampled back-to-back into the ADC DMA buffer; one ISR per frame
+    uint8_t pins[] = { JS_VRX, JS_VRY };
+    analogContinuousSetWidth(12);
+    continuousAdc = analogContinuous(pins, 2, JS_ADC_OVERSAMPLE, JS_ADC_SAMPLE_RATE_HZ, &onJoystickAdcFrame)
+                    && analogContinuousStart();
   }
 
-  // Raw analog values
+  // Raw analog values (latest filtered snapshot)
   int getRawX() {
-    return analogRead(JS_VRX);
+    poll();
+    return xFilteredQ4 >> 4;
   }
   int getRawY() {
-    return analogRead(JS_VRY);
+    poll();
+    return yFilteredQ4 >> 4;
+  }
+
+  int getXCenter() const {
+    return xCenterQ4 >> 4;
+  }
+  int getYCenter() const {
+    return yCenterQ4 >> 4;
   }
 
   // Mapped values
   int getMappedX() {
-    return mapJoystick(getRawX(), X_CENTER);
+    return mapJoystick(getRawX(), getXCenter());
   }
   int getMappedY() {
-    return mapJoystick(getRawY(), Y_CENTER);
+    return mapJoystick(getRawY(), getYCenter());
   }
 
   // Button press
@@ -54,11 +153,11 @@ public:
     return digitalRead(JS_SW) == LOW;
   }
 
-  // Get direction (1-8) or 0 if centered
   // Get direction (1-8) or 0 if centered
   byte getDirection() {
-    int x = getMappedX();
-    int y = getMappedY();
+    poll();
+    int x = mapJoystick(xFilteredQ4 >> 4, getXCenter());
+    int y = mapJoystick(yFilteredQ4 >> 4, getYCenter());
 
     // Diagonals first
     if (x == 100 && y == 100) return 5;    // TOP RIGHT
@@ -1,6 +1,7 @@
 #pragma once
 #include <Wire.h>
 #include "constants.h"
+#include "i2ctrace.h"
 
 #define MCP_IODIRA 0x00
 #define MCP_IODIRB 0x01
@@ -37,6 +38,8 @@
 #define HDLY_BIT_BL 5      // GPB5 - BL# (mindkét kijelző)
 
 class HDSPDisplay {
+  friend class Benchmark;  // bench.h - private hot paths are timed directly
+
 private:
   uint8_t mcpAddr;
   uint8_t gpaState;
@@ -45,12 +48,30 @@ private:
   bool displayInitialized;
   uint8_t clockType;  // 0 = HDLY2416, 1 = HDSP2111 - futásidőben váltható
 
+  // Nem blokkoló reset: a lépéseket update() lépteti DISPLAY_RESET_STEP_MS-enként,
+  // a közben érkező frame a pendingText-be kerül, és a reset végén íródik ki
+  byte resetStep;  // 0 = nincs folyamatban lévő reset
+  unsigned long resetStepStart;
+  char pendingText[9];
+  bool framePending;
+
+  // Az utolsó kiírt frame időzítése (micros) - a reakcióidő mérés ezzel korrigál
+  uint32_t flushStartUs;
+  uint32_t flushEndUs;
+
+  I2cTrace* trace;  // nullptr = nincs buszlog (I2C_TRACE_ENABLED)
+
+  void endWrite(const uint8_t* bytes, uint8_t len, uint32_t startUs) {
+    uint8_t status = Wire.endTransmission();
+    if (I2C_TRACE_ENABLED && trace) trace->recordWrite(mcpAddr, bytes, len, status, startUs);
+  }
+
   void writeRegisters() {
+    uint32_t startUs = I2C_TRACE_ENABLED ? micros() : 0;
+    uint8_t bytes[3] = { MCP_OLATA, gpaState, gpbState };
     Wire.beginTransmission(mcpAddr);
-    Wire.write(MCP_OLATA);
-    Wire.write(gpaState);
-    Wire.write(gpbState);
-    Wire.endTransmission();
+    Wire.write(bytes, 3);
+    endWrite(bytes, 3, startUs);
   }
 
   void setGPA(uint8_t bit, bool val) {
@@ -125,38 +146,84 @@ private:
     }
   }
 
-  void sendToDisplay(char* data) {
+  // Egy reset lépés kiadása a vonalakra; false = nincs több lépés, a reset kész
+  bool applyResetStep(byte step) {
     if (clockType == 1) {
-      for (int i = 0; i < 8; i++) {
-        char ch = (data[i] != '\0') ? data[i] : ' ';
-        writeChar(0, i, (uint8_t)ch);  // DIG0..DIG7 = addr 0..7, bal->jobb, nincs tükrözés
+      switch (step) {
+        case 1: setGPA(HDSP_BIT_RST, false); break;  // RST# low - reset assert
+        case 2: setGPA(HDSP_BIT_RST, true); break;   // RST# high - release (>=110us kell, 10ms bőven elég)
+        default: return false;
       }
     } else {
-      for (int i = 0; i < 8; i++) {
-        char ch = (data[i] != '\0') ? data[i] : ' ';
-        uint8_t disp = (i < 4) ? 0 : 1;
-        uint8_t addr = (disp == 0) ? (3 - i) : (7 - i);
-        writeChar(disp, addr, (uint8_t)ch);
+      switch (step) {
+        case 1:
+          setGPA(HDLY_BIT_CE1_D1, false);
+          setGPA(HDLY_BIT_CE1_D2, false);
+          setGPA(HDLY_BIT_CLR, false);
+          break;
+        case 2: setGPA(HDLY_BIT_CLR, true); break;
+        case 3:
+          setGPA(HDLY_BIT_CE1_D1, true);
+          setGPA(HDLY_BIT_CE1_D2, true);
+          break;
+        default: return false;
       }
     }
+    writeRegisters();
+    return true;
+  }
+
+  // Egy karakter a bal->jobb 'i' pozícióra
+  void writePosition(int i, char ch) {
+    if (ch == '\0') ch = ' ';
+    if (clockType == 1) {
+      writeChar(0, i, (uint8_t)ch);  // DIG0..DIG7 = addr 0..7, bal->jobb, nincs tükrözés
+    } else {
+      uint8_t disp = (i < 4) ? 0 : 1;
+      uint8_t addr = (disp == 0) ? (3 - i) : (7 - i);
+      writeChar(disp, addr, (uint8_t)ch);
+    }
+  }
+
+  void sendToDisplay(char* data) {
+    for (int i = 0; i < 8; i++) writePosition(i, data[i]);
+  }
+
+  // Csak az eltérő pozíciók - egy stopper tizedeknél ez 1-2 karakter a 8 helyett
+  // Visszaadja, hány karakter íródott ki
+  byte sendChangedChars(char* data) {
+    byte written = 0;
+    for (int i = 0; i < 8; i++) {
+      if (data[i] != lastDisplayedText[i]) {
+        writePosition(i, data[i]);
+        written++;
+      }
+    }
+    return written;
   }
 
 public:
   HDSPDisplay(uint8_t addr = MCP23017_ADDR, uint8_t type = 0)
-    : mcpAddr(addr), gpaState(0xFF), gpbState(0x20), displayInitialized(false), clockType(type) {
+    : mcpAddr(addr), gpaState(0xFF), gpbState(0x20), displayInitialized(false), clockType(type),
+      resetStep(0), resetStepStart(0), framePending(false), flushStartUs(0), flushEndUs(0), trace(nullptr) {
     for (int i = 0; i < 9; i++) lastDisplayedText[i] = '\0';
+    for (int i = 0; i < 9; i++) pendingText[i] = '\0';
   }
 
   void setClockType(uint8_t type) {
     clockType = type;
   }
 
+  void setTrace(I2cTrace* i2cTrace) {
+    trace = i2cTrace;
+  }
+
   void begin() {
+    uint32_t startUs = I2C_TRACE_ENABLED ? micros() : 0;
+    uint8_t bytes[3] = { MCP_IODIRA, 0x00, 0x00 };  // GPA, GPB all output
     Wire.beginTransmission(mcpAddr);
-    Wire.write(MCP_IODIRA);
-    Wire.write(0x00);  // GPA all output
-    Wire.write(0x00);  // GPB all output
-    Wire.endTransmission();
+    Wire.write(bytes, 3);
+    endWrite(bytes, 3, startUs);
 
     if (clockType == 1) {
       gpaState = 0x11;  // RST=1, WR/CE=1 (idle)
@@ -167,37 +234,59 @@ public:
     }
     writeRegisters();
     displayInitialized = false;
+    resetStep = 0;  // típusváltásnál egy félbehagyott reset már a régi bekötésre vonatkozna
+    framePending = false;
     delay(50);
   }
 
+  // Csak elindítja a resetet - a további lépéseket és a várakozásokat update() végzi
   void resetDisplay() {
-    if (clockType == 1) {
-      setGPA(HDSP_BIT_RST, false);  // RST# low - reset assert
-      writeRegisters();
-      delay(10);
+    resetStep = 1;
+    applyResetStep(resetStep);
+    resetStepStart = millis();
 
-      setGPA(HDSP_BIT_RST, true);  // RST# high - release (>=110us kell, 10ms bőven elég)
-      writeRegisters();
-      delay(10);
-    } else {
-      setGPA(HDLY_BIT_CE1_D1, false);
-      setGPA(HDLY_BIT_CE1_D2, false);
-      setGPA(HDLY_BIT_CLR, false);
-      writeRegisters();
-      delay(10);
+    for (int i = 0; i < 9; i++) lastDisplayedText[i] = '\0';
+    displayInitialized = true;
+  }
 
-      setGPA(HDLY_BIT_CLR, true);
-      writeRegisters();
-      delay(10);
+  bool isResetting() const {
+    return resetStep != 0;
+  }
 
-      setGPA(HDLY_BIT_CE1_D1, true);
-      setGPA(HDLY_BIT_CE1_D2, true);
-      writeRegisters();
-      delay(10);
+  // Ami most a panelen van (reset alatt a sorba állított frame még nem)
+  const char* getDisplayedText() const {
+    return lastDisplayedText;
+  }
+
+  // Mikor végzett az utolsó frame kiírása (micros), és mennyi ideig tartott -
+  // ekkor van TÉNYLEG a panelen, nem amikor displayText()-et hívták
+  uint32_t getLastFlushEndUs() const {
+    return flushEndUs;
+  }
+  uint32_t getLastFlushDurationUs() const {
+    return flushEndUs - flushStartUs;
+  }
+
+  // Display flush - minden loop() elején hívandó. Lépteti a resetet, és a
+  // reset alatt sorba állított frame-et a végén kiírja.
+  void update() {
+    if (resetStep != 0) {
+      if (millis() - resetStepStart < DISPLAY_RESET_STEP_MS) return;
+      resetStep++;
+      if (applyResetStep(resetStep)) {
+        resetStepStart = millis();
+        return;
+      }
+      resetStep = 0;
     }
 
-    for (int i = 0; i < 9; i++) lastDisplayedText[i] = '\0';
-    displayInitialized = true;
+    if (framePending) {
+      framePending = false;
+      flushStartUs = micros();
+      sendToDisplay(pendingText);
+      flushEndUs = micros();
+      for (int i = 0; i < 9; i++) lastDisplayedText[i] = pendingText[i];
+    }
   }
 
   void displayText(char* text) {
@@ -209,27 +298,28 @@ public:
     }
     buffer[8] = '\0';
 
-    bool contentChanged = !displayInitialized;
-    if (!contentChanged) {
-      for (int i = 0; i < 8; i++) {
-        if (buffer[i] != lastDisplayedText[i]) {
-          contentChanged = true;
-          break;
-        }
-      }
+    if (!displayInitialized) resetDisplay();
+
+    // Reset közben csak sorba állítjuk - mindig a legutolsó frame nyer
+    if (resetStep != 0) {
+      for (int i = 0; i < 9; i++) pendingText[i] = buffer[i];
+      framePending = true;
+      return;
     }
 
-    if (contentChanged) {
-      if (!displayInitialized) resetDisplay();
-      sendToDisplay(buffer);
-      for (int i = 0; i < 9; i++) lastDisplayedText[i] = buffer[i];
+    uint32_t startUs = micros();
+    if (sendChangedChars(buffer) > 0) {  // változatlan frame nem írja felül a flush időt
+      flushStartUs = startUs;
+      flushEndUs = micros();
     }
+    for (int i = 0; i < 9; i++) lastDisplayedText[i] = buffer[i];
   }
 
-  void displayTime(byte hour, byte minute, byte second, bool reversed = false) {
+  // separator: ':' normally, '.' marks a running background timer
+  void displayTime(byte hour, byte minute, byte second, bool reversed = false, char separator = ':') {
     char buffer[9];
-    if (reversed) sprintf(buffer, "%02d:%02d:%02d", second, minute, hour);
-    else sprintf(buffer, "%02d:%02d:%02d", hour, minute, second);
+    if (reversed) sprintf(buffer, "%02d%c%02d%c%02d", second, separator, minute, separator, hour);
+    else sprintf(buffer, "%02d%c%02d%c%02d", hour, separator, minute, separator, second);
     displayText(buffer);
   }
 
@@ -270,6 +360,7 @@ public:
     displayText(buffer);
   }
 
+  // Reset + frame sorba állítva, nem blokkol - a kiírás update()-ben történik
   void forceDisplayText(char* text) {
     resetDisplay();
     displayText(text);
@@ -1,117 +1,159 @@
 #pragma once
 
+#include <RTClib.h>
 #include "HDSPDisplay.h"
+#include "audio.h"
+#include "melodies.h"
 #include "constants.h"
-#include <Preferences.h>
+#include "settings.h"
+
+// Selectable weekday patterns (SET DAYS), bit 0 = Sunday. 0 = one-shot.
+struct AlarmDayPreset {
+  uint8_t days;
+  const char* label;  // pontosan 8 karakter
+};
+
+const AlarmDayPreset ALARM_DAY_PRESETS[] = {
+  { ALARM_DAYS_DAILY, " DAILY  " },
+  { 0x3E, "MON-FRI " },
+  { 0x41, "SAT-SUN " },
+  { 0x00, "  ONCE  " },
+  { 0x02, "ONLY MON" },
+  { 0x04, "ONLY TUE" },
+  { 0x08, "ONLY WED" },
+  { 0x10, "ONLY THU" },
+  { 0x20, "ONLY FRI" },
+  { 0x40, "ONLY SAT" },
+  { 0x01, "ONLY SUN" },
+};
+const byte ALARM_DAY_PRESET_COUNT = sizeof(ALARM_DAY_PRESETS) / sizeof(ALARM_DAY_PRESETS[0]);
 
 class Alarm {
 private:
   // Alarm state
   bool settingAlarm;
-  bool alarmEnabled;
-  bool alarmTriggered;
-  byte currentSetting;  // 0=hours, 1=minutes, 2=enable/disable
-
-  // Alarm values
-  int alarmHours;
-  int alarmMinutes;
-
-  // Alarm sound
+  byte currentSetting;  // 0=slot, 1=hours, 2=minutes, 3=days, 4=enable/disable, 5=tune
+  byte editSlot;
+  AlarmSlot editBackup;  // the selected slot as it was - double CANCEL puts it back
+  bool editBackupValid;
+
+  // Alarm values (RAM copy of the Settings slots)
+  AlarmSlot slots[ALARM_SLOT_COUNT];
+
+  // Schedule - the next instant any slot (or the snooze) is due, as a
+  // DateTime::unixtime() of the local RTC time. 0 = nothing scheduled.
+  uint32_t nextFireEpoch;
+  byte nextSlot;
+  uint32_t snoozeEpoch;
+  byte snoozeSlot;
+  uint32_t nowEpoch;       // last time seen by setNow()
+  uint32_t scheduleDay;    // nowEpoch / SECONDS_PER_DAY when the schedule was computed
+  uint32_t lastFired[ALARM_SLOT_COUNT];  // occurrence each slot last rang for - never re-armed
+
+  // Alarm sound (the melody itself is stepped by the AudioSequencer)
   bool alarmPlaying;
-  unsigned long alarmStartTime;
-  byte alarmStep;
-  unsigned long alarmCycleGap;
-  unsigned long noteStartTime;  // Track individual note timing
+  byte ringingSlot;
 
   // Setting display state
   bool showingSettingTitle;
   unsigned long settingTitleStartTime;
 
-  // Cancel button tracking
-  unsigned long lastCancelPress;
-  byte cancelPressCount;
-  bool cancelSingleProcessed;
-
   // Reference to external components
   HDSPDisplay* display;
-  byte buzzerPin;
-  Preferences* preferences;
+  AudioSequencer* audio;
+  Settings* settings;
 
   // Exit flag
   bool exitAlarmMode;
 
 public:
-  Alarm(HDSPDisplay* hdspDisplay, byte buzzer, Preferences* prefs)
-    : display(hdspDisplay), buzzerPin(buzzer), preferences(prefs) {
+  Alarm(HDSPDisplay* hdspDisplay, AudioSequencer* audioSequencer, Settings* settingsStore)
+    : nextFireEpoch(0), nextSlot(0), snoozeEpoch(0), snoozeSlot(0), nowEpoch(0), scheduleDay(UINT32_MAX),
+      alarmPlaying(false), ringingSlot(0), display(hdspDisplay), audio(audioSequencer), settings(settingsStore) {
+    memset(slots, 0, sizeof(slots));
+    memset(lastFired, 0, sizeof(lastFired));
     reset();
-    loadAlarmSettings();
   }
 
   void reset() {
+    if (alarmPlaying) audio->stop(SOUND_ALARM);
     settingAlarm = true;
-    alarmTriggered = false;
     currentSetting = 0;
+    editSlot = 0;
+    editBackupValid = false;
     alarmPlaying = false;
-    alarmStartTime = 0;
-    alarmStep = 0;
-    alarmCycleGap = 0;
-    noteStartTime = 0;
     showingSettingTitle = true;
     settingTitleStartTime = millis();
-    cancelPressCount = 0;
-    lastCancelPress = 0;
-    cancelSingleProcessed = false;
     exitAlarmMode = false;
   }
 
-  // Load alarm settings from preferences
+  // Load alarm settings from the settings cache (call from setup(), after settings.begin())
   void loadAlarmSettings() {
-    alarmHours = preferences->getInt("alarmHours", 0);
-    alarmMinutes = preferences->getInt("alarmMins", 0);
-    alarmEnabled = preferences->getBool("alarmOn", false);
+    const SettingsData& data = settings->get();
+    for (byte i = 0; i < ALARM_SLOT_COUNT; i++) {
+      slots[i] = data.alarms[i];
+      if (slots[i].hour > 23) slots[i].hour = 0;
+      if (slots[i].minute > 59) slots[i].minute = 0;
+      if (slots[i].tune >= MELODY_LIBRARY_SIZE) slots[i].tune = DEFAULT_ALARM_TUNE;
+    }
+    scheduleDay = UINT32_MAX;  // recompute on the next tick
   }
 
-  // Save alarm settings to preferences
-  void saveAlarmSettings() {
-    preferences->putInt("alarmHours", alarmHours);
-    preferences->putInt("alarmMins", alarmMinutes);
-    preferences->putBool("alarmOn", alarmEnabled);
+  // Save one slot - RAM only, the settings cache commits to NVS later
+  void saveAlarmSlot(byte index) {
+    AlarmSlot& slot = slots[index];
+    if (slot.days == 0) {
+      // One-shot: pin it to the next occurrence of HH:MM. Without a valid
+      // clock there's nothing to pin it to - setNow() does it later.
+      if (nowEpoch != 0) pinOneShot(slot, nowEpoch);
+      else slot.month = 0;
+    }
+    settings->setAlarmSlot(index, slot);
+    reschedule(nowEpoch);
   }
 
-  // Check if alarm should trigger
-  void checkAlarmTrigger(int currentHour, int currentMinute, int currentSecond) {
-    if (!alarmEnabled || alarmTriggered || alarmPlaying) return;
-
-    // Check if it's alarm time (trigger at 0 seconds)
-    if (currentHour == alarmHours && currentMinute == alarmMinutes && currentSecond == 0) {
-      triggerAlarm();
+  // Per-tick time feed. The schedule is only recomputed when the date
+  // changes, a slot is saved, an alarm / snooze fired or the clock jumped.
+  // Firing itself is up to the ClockScheduler (getNextFireEpoch() crossed).
+  void setNow(uint32_t currentEpoch) {
+    bool firstValid = nowEpoch == 0 && currentEpoch != 0;
+    nowEpoch = currentEpoch;
+    if (firstValid) {
+      // One-shot slots saved before the clock was valid get their date now
+      for (byte i = 0; i < ALARM_SLOT_COUNT; i++) {
+        if (slots[i].days == 0 && slots[i].enabled && slots[i].month == 0) {
+          pinOneShot(slots[i], nowEpoch);
+          settings->setAlarmSlot(i, slots[i]);
+        }
+      }
     }
+    if (nowEpoch / SECONDS_PER_DAY != scheduleDay) reschedule(nowEpoch);
+  }
 
-    // Reset alarm triggered flag at the start of a new day (00:00:00)
-    if (currentHour == 0 && currentMinute == 0 && currentSecond == 0) {
-      alarmTriggered = false;
-    }
+  // ClockScheduler saw getNextFireEpoch() crossed
+  void fire() {
+    if (nextFireEpoch == 0) return;
+    triggerAlarm();
+  }
+
+  // RTC was set / resynced: a pending snooze keeps its remaining time, the
+  // slots are rescheduled from the new time. A backward jump re-arms them,
+  // but never an occurrence that already rang (a GPS resync a few seconds
+  // back right after the alarm would ring it again).
+  void clockChanged(uint32_t currentEpoch, int32_t jumpSeconds) {
+    nowEpoch = currentEpoch;
+    if (snoozeEpoch != 0) snoozeEpoch += jumpSeconds;
+    reschedule(nowEpoch);
   }
 
   // Handle alarm updates (call this in main loop when in alarm mode)
   void update() {
-    // Handle cancel button timeout and single press processing
-    if (cancelPressCount > 0 && (millis() - lastCancelPress > ALARM_CANCEL_DOUBLE_PRESS_WINDOW)) {
-      if (cancelPressCount == 1 && !cancelSingleProcessed) {
-        // Process single press - reset current setting to 0
-        handleCancelSinglePress();
-        cancelSingleProcessed = true;
-      }
-      cancelPressCount = 0;
-    }
-
     // Handle setting title timeout
     if (showingSettingTitle && (millis() - settingTitleStartTime >= ALARM_SETTING_TITLE_DURATION)) {
       showingSettingTitle = false;
     }
 
     if (alarmPlaying) {
-      handleAlarmSound();
       updateAlarmDisplay();
       return;
     }
@@ -125,12 +167,10 @@ public:
     settingTitleStartTime = millis();
   }
 
-  // Button handlers - FIXED: Any button press stops the alarm
+  // Button handlers - any joystick direction dismisses a ringing alarm
   void handleConfirmButton() {
     if (alarmPlaying) {
-      // Stop alarm completely
       stopAlarm();
-      alarmTriggered = true;  // Prevent retriggering today
       return;
     }
 
@@ -141,64 +181,55 @@ public:
 
   void handleAddButton() {
     if (alarmPlaying) {
-      // Stop alarm completely
       stopAlarm();
-      alarmTriggered = true;  // Prevent retriggering today
       return;
     }
 
     if (settingAlarm && !showingSettingTitle) {
-      if (currentSetting == 2) {
-        // Enable/disable setting - ADD turns alarm ON
-        alarmEnabled = true;
-        saveAlarmSettings();
-      } else {
-        handleAdd();
-      }
+      handleAdd();
     }
   }
 
   void handleSubtractButton() {
     if (alarmPlaying) {
-      // Stop alarm completely
       stopAlarm();
-      alarmTriggered = true;  // Prevent retriggering today
       return;
     }
 
     if (settingAlarm && !showingSettingTitle) {
-      if (currentSetting == 2) {
-        // Enable/disable setting - SUBTRACT turns alarm OFF
-        alarmEnabled = false;
-        saveAlarmSettings();
-      } else {
-        handleSubtract();
-      }
+      handleSubtract();
     }
   }
 
+  // JS button while ringing - ring again in ALARM_SNOOZE_SECONDS
+  void snooze() {
+    if (!alarmPlaying) return;
+    stopAlarm();
+    snoozeEpoch = nowEpoch + ALARM_SNOOZE_SECONDS;
+    snoozeSlot = ringingSlot;
+    reschedule(nowEpoch);
+  }
+
+  // Single CANCEL (the gesture engine already waited out the double-press window)
   void handleCancelButton() {
     if (alarmPlaying) {
-      // Stop alarm completely
       stopAlarm();
-      alarmTriggered = true;  // Prevent retriggering today
       return;
     }
 
-    unsigned long currentTime = millis();
+    handleCancelSinglePress();
+  }
 
-    // Check for double press
-    if (currentTime - lastCancelPress <= ALARM_CANCEL_DOUBLE_PRESS_WINDOW && cancelPressCount == 1) {
-      // Double press detected - exit alarm mode
-      cancelPressCount = 0;
-      exitAlarmMode = true;
-      return;
+  // Double CANCEL - exit alarm mode, unconfirmed edits are dropped. The
+  // enable step saves at once, so the slot is also put back in Settings.
+  void handleCancelDoublePress() {
+    loadAlarmSettings();
+    if (editBackupValid) {
+      slots[editSlot] = editBackup;
+      settings->setAlarmSlot(editSlot, editBackup);
+      reschedule(nowEpoch);
     }
-
-    // Record the press
-    cancelPressCount = 1;
-    lastCancelPress = currentTime;
-    cancelSingleProcessed = false;
+    exitAlarmMode = true;
   }
 
   // Get current state for display purposes
@@ -206,68 +237,142 @@ public:
     return exitAlarmMode;
   }
   bool isAlarmEnabled() const {
-    return alarmEnabled;
+    return nextFireEpoch != 0;
   }
 
   bool isAlarmActive() const {
     return alarmPlaying;
   }
 
+  bool isSnoozed() const {
+    return snoozeEpoch != 0;
+  }
+
+  // Next fire instant (local RTC time, unixtime), 0 = none
+  uint32_t getNextFireEpoch() const {
+    return nextFireEpoch;
+  }
+
   // Reset exit flag (call from main code after handling exit)
   void clearExitFlag() {
     exitAlarmMode = false;
   }
 
 private:
-  // Handle single cancel press - reset current setting to 0
+  // First HH:MM at or after 'from', ignoring the weekday mask
+  static uint32_t nextDailyOccurrence(const AlarmSlot& slot, uint32_t from) {
+    DateTime day(from);
+    DateTime candidate(day.year(), day.month(), day.day(), slot.hour, slot.minute, 0);
+    if (candidate.unixtime() < from) candidate = candidate + TimeSpan(1, 0, 0, 0);
+    return candidate.unixtime();
+  }
+
+  static void pinOneShot(AlarmSlot& slot, uint32_t from) {
+    DateTime when(nextDailyOccurrence(slot, from));
+    slot.year = when.year() - 2000;
+    slot.month = when.month();
+    slot.day = when.day();
+  }
+
+  // First instant at or after 'from' this slot is due, 0 = never
+  static uint32_t nextOccurrence(const AlarmSlot& slot, uint32_t from) {
+    if (!slot.enabled) return 0;
+
+    if (slot.days == 0) {
+      if (slot.month == 0) return 0;  // one-shot waiting for a valid clock
+      uint32_t when = DateTime(2000 + slot.year, slot.month, slot.day, slot.hour, slot.minute, 0).unixtime();
+      return when >= from ? when : 0;
+    }
+
+    DateTime today(from);
+    for (byte d = 0; d <= 7; d++) {
+      DateTime day = today + TimeSpan(d, 0, 0, 0);
+      DateTime candidate(day.year(), day.month(), day.day(), slot.hour, slot.minute, 0);
+      if ((slot.days & (1 << candidate.dayOfTheWeek())) && candidate.unixtime() >= from) {
+        return candidate.unixtime();
+      }
+    }
+    return 0;
+  }
+
+  void reschedule(uint32_t from) {
+    nextFireEpoch = 0;
+    scheduleDay = nowEpoch / SECONDS_PER_DAY;
+    if (from == 0) return;  // no valid clock - DateTime(0) would underflow the 2000 epoch
+    for (byte i = 0; i < ALARM_SLOT_COUNT; i++) {
+      uint32_t when = nextOccurrence(slots[i], from > lastFired[i] ? from : lastFired[i] + 1);
+      if (when != 0 && (nextFireEpoch == 0 || when < nextFireEpoch)) {
+        nextFireEpoch = when;
+        nextSlot = i;
+      }
+    }
+    if (snoozeEpoch != 0 && (nextFireEpoch == 0 || snoozeEpoch <= nextFireEpoch)) {
+      nextFireEpoch = snoozeEpoch;
+      nextSlot = snoozeSlot;
+    }
+  }
+
+  // Handle single cancel press - reset current setting to its default
   void handleCancelSinglePress() {
     if (!settingAlarm || showingSettingTitle) return;
 
+    AlarmSlot& slot = slots[editSlot];
     switch (currentSetting) {
-      case 0:  // Hours
-        alarmHours = 0;
+      case 0:  // Slot
+        editSlot = 0;
+        break;
+      case 1:  // Hours
+        slot.hour = 0;
+        break;
+      case 2:  // Minutes
+        slot.minute = 0;
         break;
-      case 1:  // Minutes
-        alarmMinutes = 0;
+      case 3:  // Days - back to every day
+        slot.days = ALARM_DAYS_DAILY;
         break;
-      case 2:  // Enable/disable - toggle
-        alarmEnabled = !alarmEnabled;
-        saveAlarmSettings();
+      case 4:  // Enable/disable - toggle
+        slot.enabled = !slot.enabled;
+        saveAlarmSlot(editSlot);
+        break;
+      case 5:  // Tune - back to the default
+        slot.tune = DEFAULT_ALARM_TUNE;
+        previewTune();
         break;
     }
   }
 
-  // Format alarm values with leading zeros
-  String formatAlarmValue(int value) const {
-    if (value < 10) {
-      return "0" + String(value);
+  byte dayPresetIndex(uint8_t days) const {
+    for (byte i = 0; i < ALARM_DAY_PRESET_COUNT; i++) {
+      if (ALARM_DAY_PRESETS[i].days == days) return i;
     }
-    return String(value);
-  }
-
-  // Get formatted alarm time string
-  String getAlarmTimeString() const {
-    return " " + formatAlarmValue(alarmHours) + ":" + formatAlarmValue(alarmMinutes) + "  ";
+    return 0;
   }
 
   // Get current setting title
-  String getCurrentSettingTitle() const {
+  const char* getCurrentSettingTitle() const {
     switch (currentSetting) {
-      case 0: return "SET HRS ";
-      case 1: return "SET MINS";
-      case 2: return "SET ALRM";
+      case 0: return "SEL ALRM";
+      case 1: return "SET HRS ";
+      case 2: return "SET MINS";
+      case 3: return "SET DAYS";
+      case 4: return "SET ALRM";
+      case 5: return "SET TUNE";
       default: return "";
     }
   }
 
-  // Handle value confirmation (hours -> minutes -> enable/disable -> done)
+  // Handle value confirmation (slot -> hours -> minutes -> days -> enable/disable -> tune -> done)
   void handleValueConfirm() {
     if (showingSettingTitle) return;
 
+    if (currentSetting == 0) {
+      editBackup = slots[editSlot];
+      editBackupValid = true;
+    }
     currentSetting++;
-    if (currentSetting >= 3) {
+    if (currentSetting >= 6) {
       // All values set, save and exit setting mode
-      saveAlarmSettings();
+      saveAlarmSlot(editSlot);
       settingAlarm = false;
       exitAlarmMode = true;
     } else {
@@ -279,127 +384,127 @@ private:
 
   // Handle adding to current setting
   void handleAdd() {
+    AlarmSlot& slot = slots[editSlot];
     switch (currentSetting) {
-      case 0:  // Hours
-        alarmHours++;
-        if (alarmHours > 23) {
-          alarmHours = 0;
-        }
+      case 0:  // Slot
+        editSlot = (editSlot + 1) % ALARM_SLOT_COUNT;
         break;
-      case 1:  // Minutes
-        alarmMinutes++;
-        if (alarmMinutes > 59) {
-          alarmMinutes = 0;
-        }
+      case 1:  // Hours
+        slot.hour = (slot.hour + 1) % 24;
+        break;
+      case 2:  // Minutes
+        slot.minute = (slot.minute + 1) % 60;
+        break;
+      case 3:  // Days
+        slot.days = ALARM_DAY_PRESETS[(dayPresetIndex(slot.days) + 1) % ALARM_DAY_PRESET_COUNT].days;
+        break;
+      case 4:  // Enable/disable setting - ADD turns alarm ON
+        slot.enabled = 1;
+        saveAlarmSlot(editSlot);
+        break;
+      case 5:  // Tune
+        slot.tune = (slot.tune + 1) % MELODY_LIBRARY_SIZE;
+        previewTune();
         break;
     }
   }
 
   // Handle subtracting from current setting
   void handleSubtract() {
+    AlarmSlot& slot = slots[editSlot];
     switch (currentSetting) {
-      case 0:  // Hours
-        alarmHours--;
-        if (alarmHours < 0) {
-          alarmHours = 23;
-        }
+      case 0:  // Slot
+        editSlot = (editSlot == 0) ? ALARM_SLOT_COUNT - 1 : editSlot - 1;
         break;
-      case 1:  // Minutes
-        alarmMinutes--;
-        if (alarmMinutes < 0) {
-          alarmMinutes = 59;
-        }
+      case 1:  // Hours
+        slot.hour = (slot.hour == 0) ? 23 : slot.hour - 1;
+        break;
+      case 2:  // Minutes
+        slot.minute = (slot.minute == 0) ? 59 : slot.minute - 1;
+        break;
+      case 3: {  // Days
+        byte preset = dayPresetIndex(slot.days);
+        slot.days = ALARM_DAY_PRESETS[(preset == 0) ? ALARM_DAY_PRESET_COUNT - 1 : preset - 1].days;
+        break;
+      }
+      case 4:  // Enable/disable setting - SUBTRACT turns alarm OFF
+        slot.enabled = 0;
+        saveAlarmSlot(editSlot);
+        break;
+      case 5:  // Tune
+        slot.tune = (slot.tune == 0) ? MELODY_LIBRARY_SIZE - 1 : slot.tune - 1;
+        previewTune();
         break;
     }
   }
 
-  // Trigger the alarm
+  // One pass of the selected tune, at key-beep priority so it never masks a real ring
+  void previewTune() {
+    const MelodyEntry& tune = MELODY_LIBRARY[slots[editSlot].tune];
+    audio->play(SOUND_KEY_BEEP, tune.notes, tune.length);
+  }
+
+  // Trigger the alarm - loops forever (trailing rest in the table = gap between passes).
+  // Another slot due while one is still ringing just restarts the melody.
   void triggerAlarm() {
-    alarmTriggered = true;
-    alarmPlaying = true;
-    alarmStartTime = millis();
-    noteStartTime = millis();
-    alarmStep = 0;
-    alarmCycleGap = 0;
-
-    // Stop any existing tone and play first tone WITHOUT duration parameter
-    noTone(buzzerPin);
-    delay(10);                               // Small delay to ensure clean start
-    tone(buzzerPin, TIMER_ALARM_MELODY[0]);  // NO duration parameter!
-  }
-
-  // Handle alarm sound progression - loops forever (gap between melody passes)
-  void handleAlarmSound() {
-    unsigned long currentMillis = millis();
-
-    // Handle gap between melody repeats
-    if (alarmCycleGap > 0) {
-      if (currentMillis - alarmCycleGap >= TIMER_ALARM_CYCLE_GAP_DURATION) {
-        alarmCycleGap = 0;
-        alarmStep = 0;
-        noteStartTime = currentMillis;
-
-        noTone(buzzerPin);
-        delay(5);
-        tone(buzzerPin, TIMER_ALARM_MELODY[0]);
+    uint32_t firedAt = nextFireEpoch;
+    ringingSlot = nextSlot;
+    if (snoozeEpoch != 0 && firedAt == snoozeEpoch) {
+      snoozeEpoch = 0;
+    } else {
+      lastFired[ringingSlot] = firedAt;
+      if (slots[ringingSlot].days == 0) {
+        // One-shot alarm rang - it's done
+        slots[ringingSlot].enabled = 0;
+        settings->setAlarmSlot(ringingSlot, slots[ringingSlot]);
       }
-      return;
     }
+    reschedule(firedAt + 1);
 
-    // Check if current note duration has elapsed
-    if (currentMillis - noteStartTime >= TIMER_ALARM_STEP_DURATION) {
-      alarmStep++;
-
-      if (alarmStep < TIMER_ALARM_MELODY_LENGTH) {
-        // Play next tone in melody
-        noteStartTime = currentMillis;
-        noTone(buzzerPin);
-        delay(5);
-        tone(buzzerPin, TIMER_ALARM_MELODY[alarmStep]);
-      } else {
-        // Melody finished - brief gap, then repeat (forever, until stopped)
-        noTone(buzzerPin);
-        alarmCycleGap = currentMillis;
-      }
-    }
+    alarmPlaying = true;
+    const MelodyEntry& tune = MELODY_LIBRARY[slots[ringingSlot].tune];
+    audio->play(SOUND_ALARM, tune.notes, tune.length, true);
   }
 
   // Stop the alarm completely
   void stopAlarm() {
     alarmPlaying = false;
-    noTone(buzzerPin);
+    audio->stop(SOUND_ALARM);
   }
 
   // Update display based on current state
   void updateDisplay() {
-    if (settingAlarm) {
-      if (showingSettingTitle) {
-        // Show setting title (SET HRS, SET MINS, SET ALRM)
-        String titleStr = getCurrentSettingTitle();
-        char buffer[9];
-        titleStr.toCharArray(buffer, 9);
-        display->displayText(buffer);
-      } else {
-        if (currentSetting == 2) {
-          // Show alarm status (ALRM ON / ALRM OFF)
-          String statusStr = alarmEnabled ? "ALRM ON " : "ALRM OFF";
-          char buffer[9];
-          statusStr.toCharArray(buffer, 9);
-          display->displayText(buffer);
+    const AlarmSlot& slot = slots[editSlot];
+    char buffer[9];
+
+    if (settingAlarm && showingSettingTitle) {
+      // Show setting title (SEL ALRM, SET HRS, SET MINS, ...)
+      display->displayText((char*)getCurrentSettingTitle());
+      return;
+    }
+
+    switch (settingAlarm ? currentSetting : 0) {
+      case 0:  // Slot overview - A1 07:30 / A1  OFF
+        if (slot.enabled) {
+          snprintf(buffer, sizeof(buffer), "A%u %02u:%02u", editSlot + 1, slot.hour, slot.minute);
         } else {
-          // Show current alarm time
-          String alarmStr = getAlarmTimeString();
-          char buffer[9];
-          alarmStr.toCharArray(buffer, 9);
-          display->displayText(buffer);
+          snprintf(buffer, sizeof(buffer), "A%u  OFF ", editSlot + 1);
         }
-      }
-    } else {
-      // Show alarm time when not in setting mode
-      String alarmStr = getAlarmTimeString();
-      char buffer[9];
-      alarmStr.toCharArray(buffer, 9);
-      display->displayText(buffer);
+        display->displayText(buffer);
+        break;
+      case 3:  // Weekday pattern
+        display->displayText((char*)ALARM_DAY_PRESETS[dayPresetIndex(slot.days)].label);
+        break;
+      case 4:  // Alarm status (ALRM ON / ALRM OFF)
+        display->displayText(slot.enabled ? (char*)"ALRM ON " : (char*)"ALRM OFF");
+        break;
+      case 5:  // Selected tune name
+        display->displayText((char*)MELODY_LIBRARY[slot.tune].name);
+        break;
+      default:  // Alarm time
+        snprintf(buffer, sizeof(buffer), " %02u:%02u  ", slot.hour, slot.minute);
+        display->displayText(buffer);
+        break;
     }
   }
 
@@ -408,4 +513,4 @@ private:
     // Show "WAKE UP " continuously without flashing
     display->displayText("WAKE UP ");
   }
-};
\ No newline at end of file
+};
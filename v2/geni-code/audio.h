@@ -0,0 +1,152 @@
+#pragma once
+
+#include <esp_timer.h>
+#include "constants.h"
+
+// Buzzer sources, lowest to highest priority. A higher source preempts a
+// lower one; the lower one keeps its position and resumes (restarting the
+// interrupted note) once every higher source has stopped.
+enum SoundPriority : byte {
+  SOUND_KEY_BEEP = 0,
+  SOUND_CHIME,
+  SOUND_TIMER,
+  SOUND_ALARM,
+  SOUND_PRIORITY_COUNT
+};
+
+// Plays Note tables on the LEDC channel of the buzzer pin. Note steps are
+// driven by a one-shot esp_timer (timer task context), so timing does not
+// depend on loop() latency. play()/stop() only change the channel table under
+// the spinlock and kick the timer - the LEDC itself is only touched from the
+// timer callback, so the two sides never race on the pin.
+class AudioSequencer {
+private:
+  struct Channel {
+    const Note* notes;
+    byte length;
+    byte pos;
+    bool loop;
+    bool active;
+  };
+
+  byte pin;
+  esp_timer_handle_t noteTimer;
+  portMUX_TYPE mux;
+
+  Channel channels[SOUND_PRIORITY_COUNT];
+  int8_t current;     // channel whose note is on the pin, -1 = silent
+  int64_t noteEndUs;  // esp_timer_get_time() when the current note ends
+  uint8_t restarted;  // bit per channel: play() since the last callback
+
+  int8_t highestActive() const {
+    for (int8_t p = SOUND_PRIORITY_COUNT - 1; p >= 0; p--) {
+      if (channels[p].active) return p;
+    }
+    return -1;
+  }
+
+  static void onNoteTimer(void* arg) {
+    static_cast<AudioSequencer*>(arg)->step();
+  }
+
+  void step() {
+    bool startNote = false;
+    uint16_t freq = 0;
+    int64_t waitUs = 0;
+
+    portENTER_CRITICAL(&mux);
+    int64_t now = esp_timer_get_time();
+    bool advanced = false;
+
+    // Current note over -> next note of that channel (loop / finish)
+    if (current >= 0 && channels[current].active && now >= noteEndUs) {
+      Channel& ch = channels[current];
+      ch.pos++;
+      if (ch.pos >= ch.length) {
+        if (ch.loop) ch.pos = 0;
+        else ch.active = false;
+      }
+      advanced = true;
+    }
+
+    // A lower source queued / withdrawn under the current one leaves its note alone
+    int8_t best = highestActive();
+    if (best != current || advanced || (best >= 0 && (restarted >> best) & 1)) {
+      startNote = true;
+      current = best;
+      if (best >= 0) {
+        const Note& note = channels[best].notes[channels[best].pos];
+        freq = note.freq;
+        noteEndUs = now + (int64_t)note.durationMs * 1000;
+      }
+    }
+    restarted = 0;
+    if (current >= 0) waitUs = noteEndUs - now;
+    portEXIT_CRITICAL(&mux);
+
+    if (startNote) ledcWriteTone(pin, freq);  // freq 0 = rest / silence
+    if (current >= 0) esp_timer_start_once(noteTimer, waitUs > 0 ? waitUs : 1);
+  }
+
+  // Let the timer callback reconcile right away
+  void kick() {
+    esp_timer_stop(noteTimer);
+    esp_timer_start_once(noteTimer, 1);
+  }
+
+public:
+  AudioSequencer()
+    : pin(0), noteTimer(nullptr), mux(portMUX_INITIALIZER_UNLOCKED), current(-1), noteEndUs(0), restarted(0) {
+    for (byte p = 0; p < SOUND_PRIORITY_COUNT; p++) {
+      channels[p].notes = nullptr;
+      channels[p].length = 0;
+      channels[p].pos = 0;
+      channels[p].loop = false;
+      channels[p].active = false;
+    }
+  }
+
+  void begin(byte buzzerPin) {
+    pin = buzzerPin;
+    ledcAttach(pin, 2000, 10);
+    ledcWriteTone(pin, 0);
+
+    esp_timer_create_args_t args = {};
+    args.callback = &AudioSequencer::onNoteTimer;
+    args.arg = this;
+    args.dispatch_method = ESP_TIMER_TASK;
+    args.name = "audio";
+    esp_timer_create(&args, &noteTimer);
+  }
+
+  // Starts (or restarts) a source from its first note
+  void play(SoundPriority priority, const Note* notes, byte length, bool loop = false) {
+    if (length == 0) return;
+    portENTER_CRITICAL(&mux);
+    Channel& ch = channels[priority];
+    ch.notes = notes;
+    ch.length = length;
+    ch.pos = 0;
+    ch.loop = loop;
+    ch.active = true;
+    restarted |= 1 << priority;
+    portEXIT_CRITICAL(&mux);
+    kick();
+  }
+
+  void stop(SoundPriority priority) {
+    portENTER_CRITICAL(&mux);
+    bool wasActive = channels[priority].active;
+    channels[priority].active = false;
+    portEXIT_CRITICAL(&mux);
+    if (wasActive) kick();
+  }
+
+  // Still has notes left (also true while preempted by a higher source)
+  bool isPlaying(SoundPriority priority) {
+    portENTER_CRITICAL(&mux);
+    bool active = channels[priority].active;
+    portEXIT_CRITICAL(&mux);
+    return active;
+  }
+};
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <TinyGPSPlus.h>
+#include "HDSPDisplay.h"
+#include "gps.h"
+#include "Better-JoyStick.h"
+#include "constants.h"
+
+// Canned NMEA for the parser benchmark (valid checksums)
+const char* const BENCH_NMEA[] = {
+  "$GPRMC,123519,A,4807.038,N,01131.000,E,022.4,084.4,230394,003.1,W*6A\r\n",
+  "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47\r\n",
+};
+const byte BENCH_NMEA_COUNT = sizeof(BENCH_NMEA) / sizeof(BENCH_NMEA[0]);
+
+volatile int32_t benchSink;  // results go here so the loops aren't optimized away
+
+// Microbenchmarks of the hot paths. On the board (BENCHMARK_AT_BOOT in
+// constants.h) they run once at the end of setup(); the host build runs the
+// same cases from bench_host. One CSV row per case, so two firmware
+// versions can be diffed:
+//   BENCH,<case>,<iterations>,<total us>,<ns/op>
+// The display cases really drive the panel; it's re-initialized afterwards.
+class Benchmark {
+public:
+  // Time source (ns). micros() on the board; on the host micros() is the
+  // virtual clock, which only I2C transfers and delays move, so bench_host
+  // plugs in the wall clock.
+  static inline uint64_t (*nowNs)() = [] { return (uint64_t)micros() * 1000; };
+
+private:
+  static void report(const char* name, uint32_t iterations, uint64_t startNs) {
+    uint64_t totalNs = nowNs() - startNs;
+    Serial.printf("BENCH,%s,%lu,%lu,%lu\n", name, (unsigned long)iterations, (unsigned long)(totalNs / 1000),
+                  (unsigned long)(totalNs / iterations));
+  }
+
+  // HH:MM:SS format + changed-character write, a new second every call
+  static void displayTime(HDSPDisplay& display) {
+    uint64_t start = nowNs();
+    for (uint32_t i = 0; i < BENCH_DISPLAY_ITERATIONS; i++) {
+      display.displayTime(12, 34, i % 60);
+    }
+    report("displayTime", BENCH_DISPLAY_ITERATIONS, start);
+  }
+
+  // Full 8-character frame encoding + MCP23017 writes, per panel type
+  static void sendToDisplay(HDSPDisplay& display, uint8_t type, const char* name) {
+    char frame[9] = "12:34:56";
+    display.setClockType(type);
+    uint64_t start = nowNs();
+    for (uint32_t i = 0; i < BENCH_DISPLAY_ITERATIONS; i++) {
+      frame[7] = '0' + i % 10;
+      display.sendToDisplay(frame);
+    }
+    report(name, BENCH_DISPLAY_ITERATIONS, start);
+  }
+
+  static void convertToHungarianTime(GPS& gps) {
+    uint64_t start = nowNs();
+    for (uint32_t i = 0; i < BENCH_CALC_ITERATIONS; i++) {
+      // Walks through the year so the DST branches (March / October) are all taken
+      int year = 2025, month = i % 12 + 1, day = i % 28 + 1, hour = i % 24, minute = 0, second = 0;
+      gps.convertToHungarianTime(year, month, day, hour, minute, second);
+      benchSink = hour;
+    }
+    report("convertToHungarianTime", BENCH_CALC_ITERATIONS, start);
+  }
+
+  static void calculateDayOfWeek(GPS& gps) {
+    uint64_t start = nowNs();
+    for (uint32_t i = 0; i < BENCH_CALC_ITERATIONS; i++) {
+      benchSink = gps.calculateDayOfWeek(2000 + i % 100, i % 12 + 1, i % 28 + 1);
+    }
+    report("calculateDayOfWeek", BENCH_CALC_ITERATIONS, start);
+  }
+
+  // Per sentence - a private parser, the live GPS state isn't touched
+  static void nmeaEncode() {
+    TinyGPSPlus parser;
+    uint32_t sentences = 0;
+    uint64_t start = nowNs();
+    for (uint32_t i = 0; i < BENCH_NMEA_ITERATIONS; i++) {
+      for (const char* c = BENCH_NMEA[i % BENCH_NMEA_COUNT]; *c; c++) {
+        if (parser.encode(*c)) sentences++;
+      }
+    }
+    report("TinyGPSPlus::encode", BENCH_NMEA_ITERATIONS, start);
+    if (sentences != BENCH_NMEA_ITERATIONS) Serial.printf("BENCH nmea: %lu of %lu sentences parsed\n", (unsigned long)sentences, (unsigned long)BENCH_NMEA_ITERATIONS);
+  }
+
+  static void getDirection(BetterJoystick& joystick) {
+    uint64_t start = nowNs();
+    for (uint32_t i = 0; i < BENCH_CALC_ITERATIONS; i++) {
+      benchSink = joystick.getDirection();
+    }
+    report("getDirection", BENCH_CALC_ITERATIONS, start);
+  }
+
+  // The boot splash started a non-blocking reset; while it runs displayText()
+  // only queues into pendingText (no I2C) and the panel is held in reset
+  static void settleDisplay(HDSPDisplay& display) {
+    uint64_t start = nowNs();
+    while (display.isResetting()) display.update();
+    Serial.printf("BENCH display reset finished before timing (waited %lu us)\n", (unsigned long)((nowNs() - start) / 1000));
+  }
+
+public:
+  static void runAll(HDSPDisplay& display, GPS& gps, BetterJoystick& joystick, uint8_t clockType) {
+    settleDisplay(display);
+    Serial.println("BENCH,case,iterations,total_us,ns_per_op");
+    displayTime(display);
+    sendToDisplay(display, 0, "sendToDisplay_HDLY2416");
+    sendToDisplay(display, 1, "sendToDisplay_HDSP2111");
+    convertToHungarianTime(gps);
+    calculateDayOfWeek(gps);
+    nmeaEncode();
+    getDirection(joystick);
+
+    // Back to the real panel type, with a clean reset
+    display.setClockType(clockType);
+    display.begin();
+  }
+};
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "constants.h"
+
+// Boot milestones, in the order they normally happen
+enum BootMilestone : byte {
+  BOOT_PREFS_OPEN = 0,
+  BOOT_WIRE_BEGIN,
+  BOOT_PANEL_CONFIGURED,
+  BOOT_RTC_BEGIN,
+  BOOT_RTC_FIRST_VALID,
+  BOOT_GPS_UART_UP,
+  BOOT_GPS_FIRST_BYTE,
+  BOOT_GPS_FIRST_FIX,
+  BOOT_GPS_RTC_SYNC,
+  BOOT_MILESTONE_COUNT
+};
+
+const char *BOOT_MILESTONE_NAMES[] = {
+  "prefs open",
+  "Wire.begin",
+  "panel cfg",
+  "rtc.begin",
+  "rtc valid",
+  "gps uart",
+  "gps byte",
+  "gps fix",
+  "gps->rtc",
+};
+
+// One boot's worth of timestamps (micros() since reset, 0 = not reached)
+struct BootTimelineRecord {
+  uint32_t magic;
+  uint32_t bootCount;
+  uint32_t stamps[BOOT_MILESTONE_COUNT];
+};
+
+const uint32_t BOOT_TIMELINE_MAGIC = 0x47454E49;  // "GENI"
+
+// RTC_NOINIT memory survives soft resets / panics / deep sleep (not a power cut),
+// so the previous boot can be compared with the current one (warm vs cold GPS start).
+// [0] = current boot, [1] = previous boot
+RTC_NOINIT_ATTR BootTimelineRecord bootTimelineRecords[2];
+
+class BootTimeline {
+private:
+  BootTimelineRecord *current;
+  BootTimelineRecord *previous;
+  bool reported;
+
+  void printRecord(const BootTimelineRecord &rec) {
+    Serial.printf("BOOT #%lu timeline (us since reset):\n", (unsigned long)rec.bootCount);
+    for (byte i = 0; i < BOOT_MILESTONE_COUNT; i++) {
+      if (rec.stamps[i] != 0) Serial.printf("  %-10s %10lu\n", BOOT_MILESTONE_NAMES[i], (unsigned long)rec.stamps[i]);
+      else Serial.printf("  %-10s %10s\n", BOOT_MILESTONE_NAMES[i], "-");
+    }
+  }
+
+public:
+  BootTimeline()
+    : current(&bootTimelineRecords[0]), previous(&bootTimelineRecords[1]), reported(false) {}
+
+  // Call first thing in setup() - rotates the last boot's record into the 'previous' slot
+  void begin() {
+    uint32_t bootCount = 1;
+    if (current->magic == BOOT_TIMELINE_MAGIC) {
+      *previous = *current;
+      bootCount = current->bootCount + 1;
+    } else {
+      previous->magic = 0;  // power-on: RTC memory is garbage, nothing to compare with
+    }
+
+    current->magic = BOOT_TIMELINE_MAGIC;
+    current->bootCount = bootCount;
+    for (byte i = 0; i < BOOT_MILESTONE_COUNT; i++) current->stamps[i] = 0;
+    reported = false;
+  }
+
+  // Only the first occurrence of each milestone is kept
+  void mark(BootMilestone milestone) {
+    if (current->stamps[milestone] != 0) return;
+    uint32_t now = micros();
+    current->stamps[milestone] = now ? now : 1;
+  }
+
+  bool isMarked(BootMilestone milestone) const {
+    return current->stamps[milestone] != 0;
+  }
+
+  bool isComplete() const {
+    for (byte i = 0; i < BOOT_MILESTONE_COUNT; i++) {
+      if (current->stamps[i] == 0) return false;
+    }
+    return true;
+  }
+
+  // Prints once, when every milestone is in or the boot window has run out
+  // (no GPS wired / no fix indoors -> the window closes it instead)
+  void update() {
+    if (reported) return;
+    if (!isComplete() && millis() < BOOT_TIMELINE_WINDOW_MS) return;
+
+    reported = true;
+    print();
+  }
+
+  void print() {
+    printRecord(*current);
+    if (previous->magic == BOOT_TIMELINE_MAGIC) printRecord(*previous);
+  }
+};
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <soc/gpio_reg.h>
+#include "constants.h"
+
+// Raw edge captured by the GPIO ISR
+struct ButtonEdge {
+  uint32_t us;   // micros() at the interrupt
+  bool pressed;  // level after the edge (active low already resolved)
+};
+
+// Long press / multi-click are classified from these by GestureEngine (gesture.h)
+enum ButtonEventType : byte {
+  BTN_NONE = 0,
+  BTN_PRESS,    // debounced press, emitted right at the press edge
+  BTN_RELEASE,  // debounced release
+};
+
+struct ButtonEvent {
+  ButtonEventType type;
+  uint32_t edgeUs;  // edge that produced the event (latency reference)
+};
+
+// Single-producer (ISR) / single-consumer (loop) ring - only the ISR writes
+// head, only poll() writes tail, so no locking is needed. The entries are
+// volatile too, so the compiler can't move their stores past the head update.
+const byte BUTTON_EDGE_RING_SIZE = 32;  // power of two
+volatile ButtonEdge buttonEdgeRing[BUTTON_EDGE_RING_SIZE];
+volatile byte buttonEdgeHead = 0;
+volatile byte buttonEdgeTail = 0;
+volatile uint16_t buttonEdgeOverflows = 0;
+byte buttonIsrPin = 0;
+
+void IRAM_ATTR onButtonEdge() {
+  byte head = buttonEdgeHead;
+  byte next = (head + 1) & (BUTTON_EDGE_RING_SIZE - 1);
+  if (next == buttonEdgeTail) {
+    buttonEdgeOverflows++;  // bounce storm - poll() resyncs from the pin level
+    return;
+  }
+  buttonEdgeRing[head].us = micros();
+  // Straight from the input register - digitalRead() isn't in IRAM
+  buttonEdgeRing[head].pressed = !(REG_READ(GPIO_IN_REG) & (1UL << buttonIsrPin));
+  buttonEdgeHead = next;
+}
+
+class ButtonInput {
+private:
+  byte pin;
+
+  // Debounced state
+  bool stablePressed;
+  uint32_t lastAcceptedUs;
+
+  // Decoded events waiting for the UI (oldest dropped when full)
+  ButtonEvent events[BUTTON_EVENT_QUEUE_SIZE];
+  byte eventHead;
+  byte eventTail;
+
+  // Input-to-handler latency
+  uint32_t latencyCount;
+  uint32_t latencySumUs;
+  uint32_t latencyMaxUs;
+
+  void pushEvent(ButtonEventType type, uint32_t edgeUs) {
+    events[eventHead].type = type;
+    events[eventHead].edgeUs = edgeUs;
+    eventHead = (eventHead + 1) % BUTTON_EVENT_QUEUE_SIZE;
+    if (eventHead == eventTail) eventTail = (eventTail + 1) % BUTTON_EVENT_QUEUE_SIZE;
+  }
+
+  // Lockout debounce: the first edge that changes the stable level wins, the
+  // bounce edges right after it are ignored
+  void acceptEdge(bool pressed, uint32_t us) {
+    if (pressed == stablePressed) return;
+    if (us - lastAcceptedUs < DEBOUNCE_DELAY * 1000UL) return;
+
+    stablePressed = pressed;
+    lastAcceptedUs = us;
+
+    pushEvent(pressed ? BTN_PRESS : BTN_RELEASE, us);
+  }
+
+public:
+  ButtonInput()
+    : pin(0), stablePressed(false), lastAcceptedUs(0), eventHead(0), eventTail(0),
+      latencyCount(0), latencySumUs(0), latencyMaxUs(0) {}
+
+  void begin(byte buttonPin) {
+    pin = buttonPin;
+    buttonIsrPin = buttonPin;
+    pinMode(pin, INPUT_PULLUP);
+    stablePressed = (digitalRead(pin) == LOW);
+    lastAcceptedUs = micros();
+    attachInterrupt(digitalPinToInterrupt(pin), onButtonEdge, CHANGE);
+  }
+
+  // Drains the ISR ring and decodes it into events - call once per loop()
+  void poll() {
+    while (buttonEdgeTail != buttonEdgeHead) {
+      byte tail = buttonEdgeTail;
+      acceptEdge(buttonEdgeRing[tail].pressed, buttonEdgeRing[tail].us);
+      buttonEdgeTail = (tail + 1) & (BUTTON_EDGE_RING_SIZE - 1);
+    }
+
+    uint32_t now = micros();
+
+    // A bounce inside the lockout window can leave the debounced level stale
+    // (or the ring overflowed) - once it's over, trust the pin itself
+    if (now - lastAcceptedUs >= DEBOUNCE_DELAY * 1000UL) {
+      bool level = (digitalRead(pin) == LOW);
+      if (level != stablePressed) acceptEdge(level, now);
+    }
+  }
+
+  bool nextEvent(ButtonEvent& event) {
+    if (eventTail == eventHead) return false;
+    event = events[eventTail];
+    eventTail = (eventTail + 1) % BUTTON_EVENT_QUEUE_SIZE;
+    return true;
+  }
+
+  // The event's edge on the millis() timeline of 'now' (this loop's millis()).
+  // Not edgeUs / 1000: micros() wraps every ~72 min, millis() doesn't.
+  static unsigned long edgeMillis(const ButtonEvent& event, unsigned long now) {
+    return now - (uint32_t)(micros() - event.edgeUs) / 1000;
+  }
+
+  bool isPressed() const {
+    return stablePressed;
+  }
+
+  // Drops everything pending (e.g. while another owner of the button is active)
+  void clear() {
+    eventTail = eventHead;
+  }
+
+  // Call from the handler that acted on the press at edgeUs - edge -> handler latency
+  void noteHandled(uint32_t edgeUs) {
+    uint32_t latency = micros() - edgeUs;
+    latencyCount++;
+    latencySumUs += latency;
+    if (latency > latencyMaxUs) {
+      latencyMaxUs = latency;
+      if (BUTTON_LATENCY_LOG) {
+        Serial.printf("BTN latency new max: %lu us (avg %lu us over %lu)\n",
+                      (unsigned long)latencyMaxUs, (unsigned long)(latencySumUs / latencyCount), (unsigned long)latencyCount);
+      }
+    }
+  }
+
+  uint32_t getMaxLatencyUs() const {
+    return latencyMaxUs;
+  }
+  uint32_t getAvgLatencyUs() const {
+    return latencyCount ? latencySumUs / latencyCount : 0;
+  }
+  uint16_t getOverflowCount() const {
+    return buttonEdgeOverflows;
+  }
+};
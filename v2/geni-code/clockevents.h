@@ -0,0 +1,146 @@
+#pragma once
+
+#include "constants.h"
+
+// Wall-clock events of the main loop
+enum ClockEventId : byte {
+  CLOCK_EVENT_ALARM = 0,   // target supplied by Alarm (next fire instant)
+  CLOCK_EVENT_HOUR_CHIME,  // every full hour
+  CLOCK_EVENT_POMODORO,    // target supplied by Pomodoro (end of the current phase)
+  CLOCK_EVENT_REMINDER,    // target supplied by Reminders (earliest next-fire instant)
+  CLOCK_EVENT_COUNT
+};
+
+// Fires an event when the clock CROSSES its target (last < target <= now),
+// so a loop() stall or a skipped RTC read can't make it miss the exact
+// second. Time is the local DateTime::unixtime() of the RTC.
+//
+// Time jumps (GPS resync, manual SetTime, anything where the RTC moved
+// more than the millis() clock did) are detected and handled explicitly:
+//  - forward: a crossed event still fires if it's no more than its
+//    catch-up window late, otherwise it's dropped (logged with CLOCK_EVENT_LOG);
+//  - backward: nothing fires, periodic targets are re-armed from the new
+//    time (except the one that just fired); advance() reports the jump so
+//    owners can recompute theirs.
+class ClockScheduler {
+private:
+  struct Event {
+    uint32_t target;    // 0 = not scheduled
+    uint32_t period;    // >0: periodic, target kept by the scheduler
+    uint32_t catchUpS;  // max lateness after a forward jump
+    uint32_t lastFired;  // periodic: the target that fired last, 0 = none
+  };
+
+  Event events[CLOCK_EVENT_COUNT];
+  uint32_t lastEpoch;  // 0 = no valid time seen yet
+  unsigned long lastMillis;
+  bool adjusted;       // noteTimeAdjusted() since the last advance()
+  int32_t lastJump;
+  uint8_t firedMask;
+
+  // Next multiple of the period after 'now', but never the one that just
+  // fired - a resync a second back over the full hour would chime it again
+  void armPeriodic(Event& ev, uint32_t now) {
+    if (ev.period == 0) return;
+    ev.target = (now / ev.period + 1) * ev.period;
+    if (ev.target == ev.lastFired) ev.target += ev.period;
+  }
+
+public:
+  ClockScheduler()
+    : lastEpoch(0), lastMillis(0), adjusted(false), lastJump(0), firedMask(0) {
+    for (byte i = 0; i < CLOCK_EVENT_COUNT; i++) {
+      events[i].target = 0;
+      events[i].period = 0;
+      events[i].catchUpS = 0;
+      events[i].lastFired = 0;
+    }
+  }
+
+  // One-shot event, the owner re-supplies the target (0 = none)
+  void setTarget(ClockEventId id, uint32_t target, uint32_t catchUpS) {
+    events[id].target = target;
+    events[id].period = 0;
+    events[id].catchUpS = catchUpS;
+  }
+
+  // Periodic event at every multiple of period (e.g. 3600 = full hours)
+  void setPeriodic(ClockEventId id, uint32_t period, uint32_t catchUpS) {
+    events[id].period = period;
+    events[id].catchUpS = catchUpS;
+    events[id].target = 0;
+    events[id].lastFired = 0;
+    if (lastEpoch != 0) armPeriodic(events[id], lastEpoch);
+  }
+
+  void disable(ClockEventId id) {
+    events[id].target = 0;
+    events[id].period = 0;
+  }
+
+  // Call right after rtc.adjust() - the next advance() is treated as a jump
+  // even if the correction was within the stall tolerance
+  void noteTimeAdjusted() {
+    adjusted = true;
+  }
+
+  // Feed the current time (every loop). Returns true if the clock jumped;
+  // getLastJump() then tells by how much (seconds, beyond the elapsed time).
+  bool advance(uint32_t now, unsigned long nowMs) {
+    if (now == 0) return false;  // no valid time yet
+
+    if (lastEpoch == 0) {
+      // First valid time - nothing is "crossed" at boot
+      lastEpoch = now;
+      lastMillis = nowMs;
+      for (byte i = 0; i < CLOCK_EVENT_COUNT; i++) armPeriodic(events[i], now);
+      return false;
+    }
+    if (now == lastEpoch && !adjusted) return false;
+
+    int64_t delta = (int64_t)now - (int64_t)lastEpoch;
+    int64_t elapsed = (nowMs - lastMillis) / 1000;
+    int64_t drift = delta - elapsed;
+    bool jumped = adjusted || delta < 0 || drift > (int64_t)CLOCK_JUMP_TOLERANCE_S || drift < -(int64_t)CLOCK_JUMP_TOLERANCE_S;
+    lastJump = jumped ? (int32_t)drift : 0;
+    if (jumped && CLOCK_EVENT_LOG) Serial.printf("Clock jump: %+ld s\n", (long)lastJump);
+
+    for (byte i = 0; i < CLOCK_EVENT_COUNT; i++) {
+      Event& ev = events[i];
+      if (ev.target == 0) continue;
+
+      if (delta > 0 && ev.target > lastEpoch && ev.target <= now) {
+        // Crossed - a plain stall always fires, a forward jump only within the catch-up window
+        if (!jumped || now - ev.target <= ev.catchUpS) {
+          firedMask |= 1 << i;
+          ev.lastFired = ev.target;
+        } else if (CLOCK_EVENT_LOG) {
+          Serial.printf("Clock event %u skipped by jump\n", i);
+        }
+      }
+
+      if (ev.period > 0 && (jumped || (firedMask & (1 << i)))) armPeriodic(ev, now);
+    }
+
+    lastEpoch = now;
+    lastMillis = nowMs;
+    adjusted = false;
+    return jumped;
+  }
+
+  // Fired events, in ClockEventId order
+  bool nextEvent(ClockEventId& id) {
+    for (byte i = 0; i < CLOCK_EVENT_COUNT; i++) {
+      if (firedMask & (1 << i)) {
+        firedMask &= ~(1 << i);
+        id = (ClockEventId)i;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  int32_t getLastJump() const {
+    return lastJump;
+  }
+};
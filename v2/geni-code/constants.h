@@ -13,32 +13,74 @@ const unsigned long DISPLAY_SETUP_CONFIRM_HOLD = 2000;  // ms - ennyi ideig nyom
 // MCP23017
 const uint8_t MCP23017_ADDR = 0x20;  // A0/A1/A2 = GND
 
+// DS3231 (fix cím - az RTClib a sajátját nem exportálja, csak az I2C trace használja)
+const uint8_t DS3231_ADDR = 0x68;
+
+// Display reset lépések közti várakozás (HDSP RST# / HDLY CLR# pulzus és recovery)
+const unsigned long DISPLAY_RESET_STEP_MS = 10;
+
 // Joystick
 const byte JS_X = 1;
 const byte JS_Y = 2;
 const byte JS_SW = 3;
+const int JS_DEFAULT_X_CENTER = 3250;              // gyári középállás, amíg nincs mentett kalibráció
+const int JS_DEFAULT_Y_CENTER = 3500;
+const uint32_t JS_ADC_SAMPLE_RATE_HZ = 8000;       // continuous ADC (DMA) konverziós ráta, mindkét tengely együtt
+const uint32_t JS_ADC_OVERSAMPLE = 16;             // konverzió / tengely / frame -> ~250 frame/s
+const byte JS_FILTER_SHIFT = 2;                    // IIR szűrő: 1/4 súly az új frame-nek
+const byte JS_CENTER_TRACK_SHIFT = 10;             // középpont követés nyugalmi helyzetben: 1/1024 / frame (~4 s)
+const int JS_CENTER_SAVE_DELTA = 40;               // ennyi eltolódás után mentjük újra a kalibrációt
+const unsigned long JS_CENTER_SAVE_INTERVAL = 60000;  // ms - legfeljebb ilyen gyakran ír NVS-be
 
 // Buzzer
 const byte BUZZER = 6;
-const int NOTIF_MELODY[] = { 523, 659, 783, 1047 };  // C5, E5, G5, C6
-const int NOTIF_MELODY_LENGTH = 4;
-const int STARTUP_MELODY[] = { 523, 659, 784, 1047, 1319, 1047 };  // C5 E5 G5 C6 E6 C6 - rise, peak, resolve
-const int STARTUP_MELODY_LENGTH = 6;
+
+// Hangok - audio.h AudioSequencer játssza le őket (freq 0 = szünet), a dallamok a melodies.h-ban
+struct Note {
+  uint16_t freq;
+  uint16_t durationMs;
+};
+
+// Display-típus setup visszajelzések
+const Note SETUP_CLICK_BEEP[] = { { 800, 30 } };
+const Note SETUP_CONFIRM_BEEP[] = { { 1500, 300 } };
 
 // GPS
 const byte GPS_TX = 7;
 const byte GPS_RX = 8;
 const uint16_t GPS_RATE_NORMAL_MS = 1000;  // 1 Hz - default GPS update rate
 const uint16_t GPS_RATE_HIGH_MS = 200;     // 5 Hz - boosted while SPEED mode is on screen
+const uint32_t GPS_MAX_STEP_S = 2;             // gpsfilter.h: ekkora RTC korrekció azonnal mehet (drift)
+const byte GPS_CONFIRM_FIXES = 3;              // nagyobb ugrást ennyi egymást követő, egyező fix erősít meg
+const uint32_t GPS_CONFIRM_TOLERANCE_S = 2;    // ... ennyi eltéréssel egymáshoz képest
+const unsigned long GPS_CONFIRM_RECHECK_MS = 2000;  // megerősítés alatt ilyen gyakran nézzük újra (nem percenként)
+const uint32_t GPS_BIG_STEP_S = 86400;           // érvényes RTC mellett ennél nagyobb ugrás ...
+const unsigned long GPS_BIG_STEP_CONFIRM_MS = 600000;  // ... csak ennyi ideig tartó egyezés után mehet
+const uint32_t GPS_FIX_MAX_AGE_MS = 3000;      // ennél régebbi mondat után nincs fix (a modul elhallgatott)
+const uint32_t GPS_SYNC_MAX_AGE_MS = 250;      // RTC szinkron csak friss mondat után: a fix ideje még az épp kezdődött másodperc
+const bool GPS_FILTER_LOG = false;             // true: elvetett / megerősítésre váró GPS fixek Serial-ra
 
 // RTC
 const byte I2C_SDA = 4;
 const byte I2C_SCL = 5;
+// DS3231 INT/SQW (-1 = nincs bekötve, csak szoftveres időzítés). NE strapping pin (C3: GPIO2/8/9):
+// az INT elemről is lent tartja a vonalat egy alarm match után, GPIO9-en a C3 download módba bootolna
+const int8_t RTC_INT_PIN = 10;
+const unsigned long RTC_INT_CHECK_DELAY = 3000;  // ms - egész óra után ennyivel nézzük, jött-e INT él
+const byte RTC_INT_MAX_MISSES = 2;           // ennyi elmaradt óránkénti él után szoftveres fallback
 
 // Button debounce delay
 const unsigned long DEBOUNCE_DELAY = 50;
 const unsigned long JOYSTICK_REPEAT_INTERVAL = 300;
 
+// JS gomb (GPIO interrupt + event queue, buttoninput.h)
+const byte BUTTON_EVENT_QUEUE_SIZE = 8;
+const bool BUTTON_LATENCY_LOG = false;  // true: minden új max. él -> kezelő latencia Serial-ra
+
+// Gesture engine (gesture.h)
+const byte GESTURE_EVENT_QUEUE_SIZE = 8;
+const unsigned long CANCEL_DOUBLE_PRESS_WINDOW = 500;  // timer/alarm/settime: dupla CANCEL = kilépés
+
 // Short day names based on day index
 const char *DAYS_OF_WEEK[] = { "Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat" };
 
@@ -46,6 +88,8 @@ const char *DAYS_OF_WEEK[] = { "Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat" }
 const unsigned long RTC_READ_INTERVAL = 1000;          // 1 second
 const unsigned long TEMPERATURE_READ_INTERVAL = 2000;  // 2 seconds
 const unsigned long GPS_RTC_SYNC_INTERVAL = 60000;
+const unsigned long BOOT_TIMELINE_WINDOW_MS = 120000;  // boot timeline is printed by now at the latest (cold GPS start)
+const unsigned long SETTINGS_IDLE_COMMIT_MS = 10000;  // settings.h: dirty cache is flushed after this much quiet
 
 // Mode titles
 char *MODE_TITLES[] = {
@@ -55,52 +99,103 @@ char *MODE_TITLES[] = {
   "- TEMP -",  // 3 - 25.6 C
   " TIMER  ",  // 4 - Timer mode
   " ALARM  ",  // 5 - Alarm mode
-  "SPEED KM"   // 8 - 0 km/h
+  "SPEED KM",  // 6 - 0 km/h
+  "STOPWTCH",  // 7 - Stopwatch mode
+  "POMODORO",  // 8 - Pomodoro mode
+  "REMINDER",  // 9 - Reminder mode
+  "REACTION",  // 10 - Reaction time tester
+  "STOP 10S"   // 11 - "Stop at 10.00 s" game
 };
 
 // Modes
 const byte MIN_MODE = 0;
-const byte MAX_MODE = 6;
+const byte MAX_MODE = 11;
 
 // Durations
 const int TITLE_SHOW_TIME = 2000;                // 2 seconds
 const unsigned long STATUS_MSG_DURATION = 3000;  // 3 seconds
-const unsigned long NOTIF_STEP_DURATION = 200;   // milliseconds
-const int STARTUP_NOTE_DURATIONS[] = {
-  90,   // C5 - quick
-  90,   // E5 - quick
-  90,   // G5 - quick
-  160,  // C6 - arrival, slight hold
-  240,  // E6 - peak / shimmer
-  320   // C6 - resolve, held longest
-};
 
 // GPS timezone and time conversion constants
 const unsigned long GPS_CACHE_VALIDITY_MS = 500;  // Cache valid for 500ms
 
 // Timer state and timing constants
-const unsigned long TIMER_COUNTDOWN_INTERVAL = 1000;         // 1 second
+const unsigned long TIMER_TENTHS_BELOW_MS = 60000;           // last minute: SS.t display
+const byte TIMER_POOL_SIZE = 4;                              // párhuzamosan futó visszaszámlálók (timerpool.h)
+const char* const TIMER_NAMES[TIMER_POOL_SIZE] = { "TIMER 1 ", "TIMER 2 ", "TIMER 3 ", "TIMER 4 " };  // pontosan 8 karakter
 const unsigned long TIMER_SETTING_TITLE_DURATION = 2000;     // 2 seconds
-const unsigned long TIMER_CANCEL_DOUBLE_PRESS_WINDOW = 500;  // 500ms for double press detection
-
-// Timer + Alarm sound constants (shared - both ring with the same melody until
-// the user interacts, per request; there's no cycle limit anymore)
-const int TIMER_ALARM_MELODY[] = { 1200, 1400, 1600, 1400, 1600, 1800 };
-const int TIMER_ALARM_MELODY_LENGTH = 6;
-const unsigned long TIMER_ALARM_STEP_DURATION = 100;       // 100ms per note
-const unsigned long TIMER_ALARM_CYCLE_GAP_DURATION = 300;  // 300ms gap between melody repeats
 
 // Alarm constants
 const unsigned long ALARM_SETTING_TITLE_DURATION = 2000;     // 2 seconds
-const unsigned long ALARM_CANCEL_DOUBLE_PRESS_WINDOW = 500;  // 500ms for double press detection
+const byte ALARM_SLOT_COUNT = 4;                             // független ébresztések (settings.h AlarmSlot)
+const unsigned long ALARM_SNOOZE_SECONDS = 9 * 60;           // JS gomb csengés közben = szundi
+
+// Wall-clock events (clockevents.h)
+const uint32_t CLOCK_JUMP_TOLERANCE_S = 2;  // RTC vs millis() eltérés, ami felett órát állítottak (GPS / SetTime)
+const uint32_t ALARM_CATCHUP_S = 600;       // előre ugrásnál ennyi késéssel még megszólal az ébresztő
+const uint32_t CHIME_CATCHUP_S = 60;        // ... és az óránkénti csengetés
+const uint32_t REMINDER_CATCHUP_S = 86400;  // emlékeztető: alvás / előre ugrás után egy napig még pótolja (egyszer)
+const uint32_t POMODORO_CATCHUP_S = 0;      // pomodoro fázis: ugrásnál nem sül el, a fázisvég tolódik (pomodoro.h)
+const bool CLOCK_EVENT_LOG = false;         // true: minden óraugrás / átugrott esemény Serial-ra
 
 // Button beep frequencies for unique press effects
-const int BUTTON_BEEP_FREQS[] = { 800, 1000, 1200, 600 };  // CONFIRM, CANCEL, ADD, SUBTRACT
-const int BUTTON_BEEP_DURATION = 50;
+const Note BUTTON_BEEPS[] = { { 800, 50 }, { 1000, 50 }, { 1200, 50 }, { 600, 50 } };  // CONFIRM, CANCEL, ADD, SUBTRACT
 
 // Triple press detection (JOYSTICK UP x3) - enters manual time set mode
-const unsigned long TRIPLE_PRESS_WINDOW = 3000;  // 3 seconds
-
-// Manual time set (settime.h reuses ALARM_SETTING_TITLE_DURATION / ALARM_CANCEL_DOUBLE_PRESS_WINDOW above)
+const unsigned long TRIPLE_PRESS_WINDOW = 3000;  // 3 seconds - all three presses, counted from the first
+
+// Böngészés: FEL duplán, ennyin belül = óránkénti csengetés dallamának váltása. A FEL sorozat
+// (hármas nyomás) ablaka végén jön, így a LE (csengetés ki/be) továbbra is azonnal hat.
+const unsigned long CHIME_TUNE_DOUBLE_PRESS_WINDOW = 400;
+
+// Stopwatch (stopwatch.h)
+const byte STOPWATCH_LAP_COUNT = 16;                 // ennyi legutóbbi kört tart meg (ring)
+const unsigned long STOPWATCH_LAP_LABEL_MS = 800;    // "LAP  n" ennyi ideig a köridő előtt
+
+// Pomodoro (pomodoro.h, beállítások a Settings blobban)
+const uint8_t POMODORO_DEFAULT_WORK = 25;           // perc
+const uint8_t POMODORO_DEFAULT_BREAK = 5;           // perc
+const uint8_t POMODORO_DEFAULT_LONG_EVERY = 4;      // minden 4. szünet hosszú ...
+const uint8_t POMODORO_DEFAULT_LONG_FACTOR = 4;     // ... és 4x olyan hosszú
+const uint8_t POMODORO_STEP_MINUTES = 5;
+const uint8_t POMODORO_MAX_MINUTES = 90;
+const unsigned long POMODORO_SETTING_TITLE_DURATION = 2000;
+const unsigned long POMODORO_MESSAGE_MS = 3000;     // fázisváltás üzenet ennyi ideig takarja az aktuális módot
+
+// Interval reminders (reminders.h, beállítások a Settings blobban)
+const byte REMINDER_SLOT_COUNT = 8;
+const char REMINDER_DEFAULT_LABEL[] = "REMINDER";     // pontosan 8 karakter
+const uint16_t REMINDER_DEFAULT_MINUTES = 60;
+const uint16_t REMINDER_MAX_MINUTES = 24 * 60;
+const char REMINDER_LABEL_CHARS[] = " ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789-!?";
+const unsigned long REMINDER_SCROLL_STEP_MS = 150;   // felirat futtatás: ennyi ms / karakter
+const unsigned long REMINDER_SETTING_TITLE_DURATION = 2000;
+const unsigned long REMINDER_CURSOR_BLINK_MS = 300;  // felirat szerkesztés: a kurzor alatti karakter villog
+
+// Reaction time tester (reaction.h)
+char *REACTION_WAIT_TEXT = "  WAIT  ";             // pontosan 8 karakter
+char *REACTION_GO_TEXT = "   GO   ";
+const unsigned long REACTION_MIN_DELAY_MS = 1500;   // WAIT -> GO véletlen késleltetés
+const unsigned long REACTION_MAX_DELAY_MS = 5000;
+const unsigned long REACTION_TIMEOUT_MS = 3000;     // GO után eddig várunk a nyomásra (TOO SLOW)
+const unsigned long REACTION_RESULT_TOGGLE_MS = 1000;  // eredmény <-> BEST #n váltogatás
+const byte REACTION_BEST_COUNT = 5;                 // legjobb eredmények a Settings blobban
+
+// "Stop at 10.00 s" game (stopgame.h)
+const unsigned long STOPGAME_TARGET_MS = 10000;
+const unsigned long STOPGAME_MAX_MS = 20000;          // eddig fut, ha senki nem nyomja meg
+const unsigned long STOPGAME_RESULT_TOGGLE_MS = 1500; // eredmény <-> eltérés váltogatás
+
+// Microbenchmarks (bench.h) - true: a CSV table of the hot paths on Serial at the end of setup()
+const bool BENCHMARK_AT_BOOT = false;
+const uint32_t BENCH_DISPLAY_ITERATIONS = 200;  // I2C-bound, ~ms each
+const uint32_t BENCH_CALC_ITERATIONS = 10000;
+const uint32_t BENCH_NMEA_ITERATIONS = 200;
+
+// I2C bus trace (i2ctrace.h) - true: every HDSP write and the RTC reads go to Serial as a binary trace
+const bool I2C_TRACE_ENABLED = false;
+const uint16_t I2C_TRACE_CAPACITY = I2C_TRACE_ENABLED ? 256 : 1;  // rekord (12 byte) - kikapcsolva ne foglaljon RAM-ot
+const unsigned long I2C_TRACE_REPORT_MS = 10000;                  // ennyi időnként / teli ringnél kiírás
+
+// Manual time set (settime.h reuses ALARM_SETTING_TITLE_DURATION above)
 const int SETTIME_MIN_YEAR = 2024;
 const int SETTIME_MAX_YEAR = 2099;
\ No newline at end of file
@@ -1,28 +1,70 @@
 #include "constants.h"
 #include "HDSPDisplay.h"
+#include "i2ctrace.h"
 #include "gps.h"
+#include "gpsfilter.h"
 #include <Wire.h>
 #include <RTClib.h>
 #include <Preferences.h>
 #include "timer.h"
+#include "stopwatch.h"
+#include "pomodoro.h"
+#include "reminders.h"
+#include "reaction.h"
+#include "stopgame.h"
 #include "alarm.h"
 #include "settime.h"
 #include "Better-JoyStick.h"
+#include "boottimeline.h"
+#include "buttoninput.h"
+#include "gesture.h"
+#include "audio.h"
+#include "melodies.h"
+#include "settings.h"
+#include "clockevents.h"
+#include "rtcalarms.h"
+#include "bench.h"
 
 // Joystick
 BetterJoystick joystick;
 
+// JS gomb - interruptos élfigyelés, debounce + események a buttoninput.h-ban
+ButtonInput buttonInput;
+
 // Joystick állapot (debounce + edge detect)
 byte lastJsDirection = 0;
 unsigned long lastJsDebounceTime = 0;
 bool jsDirFired = false;
-unsigned long lastJsBtnDebounceTime = 0;
-bool jsButtonState = false;
-bool lastJsButtonState = false;
 
-// Triple press (confirm = JS gomb)
-unsigned long firstConfirmPress = 0;
-byte confirmPressCount = 0;
+// Gestures - egy spec tábla kontextusonként, a GestureEngine ebből osztályoz
+GestureEngine gestures;
+
+enum AppGesture : byte {
+  GESTURE_CANCEL_SINGLE = 1,  // timer/alarm/settime/stopper: mező reset
+  GESTURE_CANCEL_DOUBLE,      // timer/alarm/settime/stopper: kilépés
+  GESTURE_SETTIME_ENTRY,      // böngészés: FEL 3x
+  GESTURE_SETUP_SWITCH,       // display setup: JS gomb 5x -> típusváltás
+  GESTURE_SETUP_CONFIRM,      // display setup: JS gomb nyomva tartva -> confirm
+  GESTURE_CHIME_TUNE,         // böngészés: FEL 2x gyorsan -> csengetés dallam váltás
+};
+
+const GestureSpec BROWSE_GESTURES[] = {
+  { GESTURE_SETTIME_ENTRY, GIN_ADD, 3, TRIPLE_PRESS_WINDOW, TRIPLE_PRESS_WINDOW },
+  { GESTURE_CHIME_TUNE, GIN_ADD, 2, TRIPLE_PRESS_WINDOW, CHIME_TUNE_DOUBLE_PRESS_WINDOW },
+};
+const byte BROWSE_GESTURES_COUNT = 2;
+
+const GestureSpec EDIT_GESTURES[] = {
+  { GESTURE_CANCEL_SINGLE, GIN_CANCEL, 1, CANCEL_DOUBLE_PRESS_WINDOW },
+  { GESTURE_CANCEL_DOUBLE, GIN_CANCEL, 2, CANCEL_DOUBLE_PRESS_WINDOW },
+};
+const byte EDIT_GESTURES_COUNT = 2;
+
+const GestureSpec SETUP_GESTURES[] = {
+  { GESTURE_SETUP_SWITCH, GIN_BUTTON, DISPLAY_SETUP_SWITCH_PRESSES, DISPLAY_SETUP_PRESS_WINDOW },
+  { GESTURE_SETUP_CONFIRM, GIN_BUTTON, 0, DISPLAY_SETUP_CONFIRM_HOLD },
+};
+const byte SETUP_GESTURES_COUNT = 2;
 
 struct timeData {
   int year;
@@ -32,6 +74,7 @@ struct timeData {
   byte hour;
   byte minute;
   byte second;
+  uint32_t epoch;  // DateTime::unixtime() of the fields above (local time)
 };
 
 // Time & Date values storage
@@ -46,6 +89,11 @@ byte currentMode = 0;  // Start with HH:MM:SS mode
 4 -> timer
 5 -> alarm
 6 -> GPS speed
+7 -> stopwatch
+8 -> pomodoro
+9 -> reminders
+10 -> reaction time tester
+11 -> stop at 10.00 s game
 */
 
 // Per-mode display format toggles (JS button click while browsing, modes 0-3)
@@ -71,6 +119,8 @@ unsigned long statusMessageStart = 0;
 
 // Timing for RTC / GPS sync
 unsigned long lastGpsRtcSync = 0;
+int gpsUtcOffset = 0;     // UTC offset (h) of the last fix, 0 = none yet
+int32_t gpsDstStepS = 0;  // DST changed on the fix - this step is due in the RTC
 unsigned long lastRtcRead = 0;
 unsigned long lastDisplayUpdate = 0;
 
@@ -82,16 +132,12 @@ float currentTemperature = 0.0;
 unsigned long displayUpdateInterval = 500;  // milliseconds
 
 // Hour notification variables
-byte lastHour = 255;  // Initialize to invalid value to avoid notification on startup
 bool hourNotificationEnabled = true;
 bool playingHourNotification = false;
-unsigned long notificationStartTime = 0;
-byte notificationStep = 0;
+byte chimeTune = DEFAULT_CHIME_TUNE;  // MELODY_LIBRARY index, persisted by Settings
 
 // Startup sound variables
 bool playingStartupSound = false;
-unsigned long startupSoundStartTime = 0;
-byte startupSoundStep = 0;
 
 // Manual time set mode (triggered by triple UP-press)
 bool inSetTimeMode = false;
@@ -99,33 +145,88 @@ bool inSetTimeMode = false;
 // Display
 HDSPDisplay HDSP;  // default 0x20
 
+// I2C bus trace (I2C_TRACE_ENABLED) - HDSP writes + periodic RTC reads
+I2cTrace i2cTrace;
+
 // GPS
 GPS gps;
+GpsTimeFilter gpsTimeFilter;  // plausibility gate before rtc.adjust()
 
 // RTC
 RTC_DS3231 rtc;
 
-// Preferences for persistent storage
+// DS3231 Alarm 1/2 + INT line (falls back to polling if not wired)
+RtcAlarmLink rtcAlarms;
+
+// Preferences for persistent storage - only Settings talks to it
 Preferences preferences;
 
-// Timer
-Timer timer(&HDSP, BUZZER);
+// Write-back cache of every persisted parameter (coalesced NVS commits)
+Settings settings;
+
+// Boot milestone timestamps (RTC-retained, printed to Serial after boot)
+BootTimeline bootTimeline;
+
+// Buzzer - every melody / beep goes through the sequencer (priority arbitration)
+AudioSequencer audio;
+
+// Countdown timers (run in the background) + the timer mode UI over them
+TimerPool timerPool(&audio);
+Timer timer(&HDSP, &timerPool);
+
+// Stopwatch (keeps running and keeps its laps across mode switches)
+Stopwatch stopwatch(&HDSP);
 
 // Alarm - RENAMED from 'alarm' to 'alarmClock' to avoid conflict with system alarm() function
-Alarm alarmClock(&HDSP, BUZZER, &preferences);
+Alarm alarmClock(&HDSP, &audio, &settings);
+
+// Pomodoro cycle - phase ends are clock events, runs in every mode
+Pomodoro pomodoro(&HDSP, &audio, &settings);
+
+// Interval reminders - next-fire instants are clock events, label scrolls over any mode
+Reminders reminders(&HDSP, &audio, &settings);
+
+// Reaction time tester (ISR press timestamp vs. confirmed GO flush)
+Reaction reaction(&HDSP, &settings);
+
+// "Stop at 10.00 s" game (ISR press timestamps, changed-digit refresh)
+StopGame stopGame(&HDSP);
+
+// Alarm + hourly chime + pomodoro phases + reminders fire on crossing their instant (stalls / time jumps safe)
+ClockScheduler clockEvents;
 
 // Manual time set (writes into the DS3231 - no GPS wiring required)
 SetTime setTime(&HDSP, BUZZER);
 
 void setup() {
+  bootTimeline.begin();
+  Serial.begin(115200);
+
   // Initialize preferences
   preferences.begin("geniClock", false);
+  bootTimeline.mark(BOOT_PREFS_OPEN);
+
+  settings.begin(&preferences, DEFAULT_ALARM_TUNE, DEFAULT_CHIME_TUNE);
+  alarmClock.loadAlarmSettings();
+  reminders.loadReminderSettings();
+  clockEvents.setPeriodic(CLOCK_EVENT_HOUR_CHIME, 3600, CHIME_CATCHUP_S);
+  chimeTune = settings.get().chimeTune;
+  if (chimeTune >= MELODY_LIBRARY_SIZE) chimeTune = DEFAULT_CHIME_TUNE;
+  printMelodyLibrary();
 
   // I2C init
   Wire.begin(I2C_SDA, I2C_SCL);
+  bootTimeline.mark(BOOT_WIRE_BEGIN);
+  HDSP.setTrace(&i2cTrace);
+
+  // JS gomb interrupt és buzzer - már a display setup is ezeket használja
+  buttonInput.begin(JS_SW);
+  audio.begin(BUZZER);
+  timerPool.begin();
 
   // Display
   runDisplayTypeSetup();
+  bootTimeline.mark(BOOT_PANEL_CONFIGURED);
   HDSP.displayText("- GENI -");
 
   // Initialize time structure to prevent 00:00:00 display
@@ -136,22 +237,23 @@ void setup() {
   currentTime.hour = 0;
   currentTime.minute = 0;
   currentTime.second = 0;
+  currentTime.epoch = 0;
 
   // Joystick
-  joystick.begin(JS_SW, JS_X, JS_Y);
-
-  // Buzzer
-  pinMode(BUZZER, OUTPUT);
+  joystick.begin(JS_SW, JS_X, JS_Y, &settings);
 
   // GPS
   gpsInitPending = true;
 
   if (rtc.begin()) {
     rtcAvailable = true;
+    bootTimeline.mark(BOOT_RTC_BEGIN);
+    rtcAlarms.begin(&rtc, RTC_INT_PIN);
 
     // Immediately read RTC time to avoid 00:00:00 display
     DateTime now = rtc.now();
     if (now.isValid()) {
+      bootTimeline.mark(BOOT_RTC_FIRST_VALID);
       currentTime.year = now.year();
       currentTime.month = now.month();
       currentTime.day = now.day();
@@ -159,6 +261,7 @@ void setup() {
       currentTime.hour = now.hour();
       currentTime.minute = now.minute();
       currentTime.second = now.second();
+      currentTime.epoch = now.unixtime();
 
       // Initialize lastRtcRead so updateTimeSource doesn't wait
       lastRtcRead = millis();
@@ -167,20 +270,36 @@ void setup() {
   // RTC FAIL will be shown after startup sequence
 
   // Start startup sound and display sequence
+  // GENI is already shown
   playingStartupSound = true;
-  startupSoundStartTime = millis();
-  startupSoundStep = 0;
+  audio.play(SOUND_CHIME, STARTUP_MELODY.notes, STARTUP_MELODY.length);
+
+  // Benchmark build - the panel is re-initialized by runAll(), GENI goes back on
+  if (BENCHMARK_AT_BOOT) {
+    Benchmark::runAll(HDSP, gps, joystick, settings.get().clockType);
+    HDSP.forceDisplayText("- GENI -");
+  }
 
-  // GENI is already shown, play first startup tone
-  tone(BUZZER, STARTUP_MELODY[0], STARTUP_NOTE_DURATIONS[0]);
+  // Boot I2C traffic as one block (MCP setup, panel reset, first RTC read)
+  i2cTrace.report("boot");
 
   // Initialize display update timer
   lastDisplayUpdate = millis();
 }
 
 void loop() {
+  // Display flush (nem blokkoló reset lépések + sorba állított frame)
+  HDSP.update();
+  bootTimeline.update();
+  buttonInput.poll();
+  settings.update();
+  i2cTrace.update();
+  timerPool.tick();  // nearest deadline only - the countdowns run in every mode
+
   if (!playingStartupSound && alarmClock.isAlarmActive()) {
     alarmClock.update();
+  } else if (!playingStartupSound && !inSetTimeMode && isTimerRingingInBackground()) {
+    timer.update();  // TIME UP over whatever mode is on screen
   }
 
   // Handle manual time-set mode (entered via triple UP-press, see handleJoystick())
@@ -202,6 +321,7 @@ void loop() {
 
       if (commit && rtcAvailable) {
         rtc.adjust(DateTime(newYear, newMonth, newDay, newHour, newMinute, 0));
+        clockEvents.noteTimeAdjusted();
         lastRtcRead = 0;  // force an immediate re-read so the display reflects it right away
         showStatusMessage("TIME SET");
       }
@@ -209,25 +329,24 @@ void loop() {
     return;
   }
 
-  // Reset confirm press counter if timeout exceeded
-  if (confirmPressCount > 0 && (millis() - firstConfirmPress > TRIPLE_PRESS_WINDOW)) {
-    confirmPressCount = 0;
-    firstConfirmPress = 0;
-  }
-
-  // Handle startup sound first
+  // Startup melody plays in the background - time sources come up meanwhile
   if (playingStartupSound) {
     handleStartupSound();
-    return;  // Don't do anything else during startup sound
   }
 
   // GPS init deferred here so a bad GPS_TX/GPS_RX config can't block the boot melody
   if (gpsInitPending) {
     gpsInitPending = false;
     gps.begin(GPS_RX, GPS_TX);
+    bootTimeline.mark(BOOT_GPS_UART_UP);
   }
 
-  handleJoystick();
+  // Input stays ignored until the melody ends, so button beeps can't cut into it
+  if (!playingStartupSound) {
+    handleJoystick();
+  } else {
+    buttonInput.clear();
+  }
 
   // Check if timer wants to exit to main mode
   if (currentMode == 4 && timer.shouldExitTimerMode()) {
@@ -237,6 +356,38 @@ void loop() {
     return;
   }
 
+  // Check if pomodoro wants to exit to main mode
+  if (currentMode == 8 && pomodoro.shouldExitPomodoroMode()) {
+    pomodoro.clearExitFlag();
+    currentMode = 0;
+    startModeSwitch(0);
+    return;
+  }
+
+  // Check if reminders want to exit to main mode
+  if (currentMode == 9 && reminders.shouldExitReminderMode()) {
+    reminders.clearExitFlag();
+    currentMode = 0;
+    startModeSwitch(0);
+    return;
+  }
+
+  // Check if the reaction tester wants to exit to main mode
+  if (currentMode == 10 && reaction.shouldExitReactionMode()) {
+    reaction.clearExitFlag();
+    currentMode = 0;
+    startModeSwitch(0);
+    return;
+  }
+
+  // Check if the stop game wants to exit to main mode
+  if (currentMode == 11 && stopGame.shouldExitGameMode()) {
+    stopGame.clearExitFlag();
+    currentMode = 0;
+    startModeSwitch(0);
+    return;
+  }
+
   // Check if alarm wants to exit to main mode
   if (currentMode == 5 && alarmClock.shouldExitAlarmMode()) {
     alarmClock.clearExitFlag();
@@ -253,14 +404,18 @@ void loop() {
     updateTemperature();
   }
 
-  // Check for alarm trigger (always check when alarm is enabled)
-  if (alarmClock.isAlarmEnabled()) {
-    alarmClock.checkAlarmTrigger(currentTime.hour, currentTime.minute, currentTime.second);
-  }
+  // Alarm / hourly chime - fired when the clock crosses their instant
+  handleClockEvents();
 
-  // Handle hour notification
+  // Hour notification end
   handleHourNotification();
 
+  // Pomodoro phase change message end
+  if (pomodoro.updateAnnouncement()) lastDisplayUpdate = 0;
+
+  // Reminder label scroll
+  if (reminders.updateScroll()) lastDisplayUpdate = 0;
+
   // Check if mode title should auto-confirm
   if (showingModeTitle && (millis() - modeTitleStartTime >= TITLE_SHOW_TIME)) {
     showingModeTitle = false;
@@ -275,6 +430,14 @@ void loop() {
       alarmClock.forceShowSettingTitle();
     }
 
+    if (currentMode == 8) {
+      pomodoro.forceShowSettingTitle();
+    }
+
+    if (currentMode == 9) {
+      reminders.forceShowSettingTitle();
+    }
+
     // Set appropriate update interval for selected mode
     switch (currentMode) {
       case 1: displayUpdateInterval = 1000; break;  // year+month updates every 1s
@@ -294,7 +457,7 @@ void loop() {
   }
 
   // Update display based on current state
-  if (!showingModeTitle && !playingHourNotification) {
+  if (!showingModeTitle && !playingHourNotification && !pomodoro.isAnnouncing() && !reminders.isScrolling()) {
     // In normal mode - update display based on current mode
     updateTDDisplay();
   }
@@ -304,79 +467,79 @@ void updateTemperature() {
   // Read temperature from RTC
   if (rtcAvailable && (millis() - lastTemperatureRead >= TEMPERATURE_READ_INTERVAL)) {
     lastTemperatureRead = millis();
+    uint32_t traceStart = I2C_TRACE_ENABLED ? micros() : 0;
     currentTemperature = rtc.getTemperature();
+    i2cTrace.recordRead(DS3231_ADDR, 2, traceStart);
   }
 }
 
 void handleStartupSound() {
-  // Check if it's time to play the next note
-  if (millis() - startupSoundStartTime >= STARTUP_NOTE_DURATIONS[startupSoundStep]) {
-    startupSoundStep++;
-
-    if (startupSoundStep < STARTUP_MELODY_LENGTH) {
-      // Play next note in startup melody
-      startupSoundStartTime = millis();
-      tone(BUZZER, STARTUP_MELODY[startupSoundStep], STARTUP_NOTE_DURATIONS[startupSoundStep]);
-    } else {
-      // Startup sound finished
-      playingStartupSound = false;
-      noTone(BUZZER);
+  // The sequencer plays the notes - only watch for the end of the melody
+  if (audio.isPlaying(SOUND_CHIME)) return;
 
-      // Show status messages after startup sound
-      if (rtcAvailable) {
-        showStatusMessage(" RTC OK ");
-      } else {
-        showStatusMessage("RTC FAIL");  // Show RTC FAIL after startup
-      }
+  playingStartupSound = false;
 
-      // Wait a bit before starting normal operation
-      delay(500);
+  // The clock is already running by now - only a missing RTC is worth
+  // interrupting it for
+  if (!rtcAvailable) {
+    showStatusMessage("RTC FAIL");
+  }
+}
 
-      // Force immediate display update
-      lastDisplayUpdate = 0;
+void handleClockEvents() {
+  clockEvents.setTarget(CLOCK_EVENT_ALARM, alarmClock.getNextFireEpoch(), ALARM_CATCHUP_S);
+  clockEvents.setTarget(CLOCK_EVENT_POMODORO, pomodoro.getPhaseEndEpoch(), POMODORO_CATCHUP_S);
+  clockEvents.setTarget(CLOCK_EVENT_REMINDER, reminders.getNextFireEpoch(), REMINDER_CATCHUP_S);
+  pomodoro.setNow(currentTime.epoch);
+  reminders.setNow(currentTime.epoch);
+  bool jumped = clockEvents.advance(currentTime.epoch, millis());
+
+  ClockEventId ev;
+  while (clockEvents.nextEvent(ev)) {
+    if (ev == CLOCK_EVENT_ALARM) {
+      alarmClock.fire();
+    } else if (ev == CLOCK_EVENT_HOUR_CHIME) {
+      rtcAlarms.noteHourPassed();
+      startHourNotification();
+    } else if (ev == CLOCK_EVENT_POMODORO) {
+      pomodoro.phaseEnded();
+    } else if (ev == CLOCK_EVENT_REMINDER) {
+      reminders.fireDue(currentTime.epoch);
     }
   }
-}
 
-void handleHourNotification() {
-  // Check if we should start a new hour notification
-  if (hourNotificationEnabled && !playingHourNotification && lastHour != 255 && currentTime.hour != lastHour && currentTime.minute == 0 && currentTime.second == 0) {
+  // Reschedule after the events, so a forward jump can still catch up on the skipped alarm
+  if (jumped) {
+    alarmClock.clockChanged(currentTime.epoch, clockEvents.getLastJump());
+    pomodoro.clockChanged(clockEvents.getLastJump());
+    reminders.clockChanged(currentTime.epoch, clockEvents.getLastJump());
+  }
+  alarmClock.setNow(currentTime.epoch);
 
-    // Start hour notification
-    playingHourNotification = true;
-    notificationStartTime = millis();
-    notificationStep = 0;
+  // Next alarm instant into DS3231 Alarm 1 (I2C only when it changed)
+  rtcAlarms.setAlarm1(alarmClock.getNextFireEpoch());
+}
 
-    // Play first tone
-    tone(BUZZER, NOTIF_MELODY[0], NOTIF_STEP_DURATION);
+void startHourNotification() {
+  if (!hourNotificationEnabled || playingHourNotification) return;
 
-    // Show hour notification on display
-    char hourMsg[9];
-    sprintf(hourMsg, " %02d:00  ", currentTime.hour);
-    HDSP.forceDisplayText(hourMsg);
-  }
+  playingHourNotification = true;
+  audio.play(SOUND_CHIME, MELODY_LIBRARY[chimeTune].notes, MELODY_LIBRARY[chimeTune].length);
 
-  // Handle notification progression
-  if (playingHourNotification) {
-    if (millis() - notificationStartTime >= (notificationStep + 1) * NOTIF_STEP_DURATION) {
-      notificationStep++;
+  // Show hour notification on display
+  char hourMsg[9];
+  sprintf(hourMsg, " %02d:00  ", currentTime.hour);
+  HDSP.forceDisplayText(hourMsg);
+}
 
-      if (notificationStep < NOTIF_MELODY_LENGTH) {
-        // Play next tone
-        tone(BUZZER, NOTIF_MELODY[notificationStep], NOTIF_STEP_DURATION);
-      } else {
-        // Notification finished
-        playingHourNotification = false;
-        noTone(BUZZER);
+void handleHourNotification() {
+  // Notification finished once the sequencer ran out of chime notes
+  if (playingHourNotification && !audio.isPlaying(SOUND_CHIME)) {
+    playingHourNotification = false;
 
-        // Force display update by resetting timer
-        lastDisplayUpdate = 0;
-      }
-    }
+    // Force display update by resetting timer
+    lastDisplayUpdate = 0;
   }
-
-  // Update lastHour for next comparison
-  lastHour = currentTime.hour;
 }
 
 // Simplified status message function
@@ -395,240 +558,462 @@ void startModeSwitch(byte newMode) {
     gps.setUpdateRate(GPS_RATE_NORMAL_MS);
   }
 
+  // Mode exit - flush whatever the previous mode changed in one go
+  settings.commit();
+
   currentMode = newMode;
   showingModeTitle = true;
   modeTitleStartTime = millis();
 
+  // UI only - the countdowns themselves stay in timerPool
   if (newMode == 4) {
     timer.reset();
   }
 
+  if (newMode == 7) {
+    stopwatch.showLive();
+  }
+
   if (newMode == 5) {
     alarmClock.reset();
   }
 
+  if (newMode == 8) {
+    pomodoro.reset();
+  }
+
+  if (newMode == 9) {
+    reminders.reset();
+  }
+
+  if (newMode == 10) {
+    reaction.reset();
+  }
+
+  if (newMode == 11) {
+    stopGame.reset();
+  }
+
   HDSP.displayText(MODE_TITLES[currentMode]);
 }
 
 void playButtonBeep(byte buttonIndex) {
-  tone(BUZZER, BUTTON_BEEP_FREQS[buttonIndex], BUTTON_BEEP_DURATION);
+  audio.play(SOUND_KEY_BEEP, &BUTTON_BEEPS[buttonIndex], 1);
 }
 
-void handleJoystick() {
-  unsigned long now = millis();
-
-  if (alarmClock.isAlarmActive()) {
-    byte dir = joystick.getDirection();
-    bool btnRaw = joystick.getButtonPress();
-    if ((dir != 0 || btnRaw) && (now - lastJsDebounceTime >= DEBOUNCE_DELAY)) {
-      lastJsDebounceTime = now;
-      alarmClock.handleConfirmButton();
-    }
-    lastJsDirection = dir;
-    jsButtonState = btnRaw;
-    lastJsButtonState = btnRaw;
-    return;
+// getDirection() számozás -> logikai bemenet (lásd a fizikai irány megjegyzést lent)
+byte dirToGestureInput(byte dir) {
+  switch (dir) {
+    case 4: return GIN_CONFIRM;   // fizikai JOBBRA
+    case 3: return GIN_CANCEL;    // fizikai BALRA
+    case 2: return GIN_ADD;       // fizikai FEL
+    default: return GIN_SUBTRACT; // fizikai LE (dir == 1)
   }
+}
 
+// Joystick irányok (debounce + auto-repeat) és a JS gomb eseményei -> GestureEngine
+void feedGestureInputs(unsigned long now) {
   // A joystick VRX/VRY bekötése fizikailag fel-le/balra-jobbra van cserélve a
   // getDirection() elnevezéséhez képest: fizikai JOBBRA -> dir==4 (kód "UP"),
   // fizikai FEL -> dir==2 (kód "RIGHT"), fizikai BALRA -> dir==3 (kód "DOWN"),
   // fizikai LE -> dir==1 (kód "LEFT"). A kommentek ezért a FIZIKAI irányt írják,
-  // a dir==N csak a getDirection() belső számozása.
+  // a dir==N csak a getDirection() belső számozása. Az átlók (5-8) nem csinálnak semmit.
   byte dir = joystick.getDirection();
   if (dir != lastJsDirection) {
+    if (lastJsDirection >= 1 && lastJsDirection <= 4) gestures.release(dirToGestureInput(lastJsDirection), now);
     lastJsDebounceTime = now;
     lastJsDirection = dir;
     jsDirFired = false;
   }
-  if (dir != 0) {
+  if (dir >= 1 && dir <= 4) {
     unsigned long requiredWait = jsDirFired ? JOYSTICK_REPEAT_INTERVAL : DEBOUNCE_DELAY;
     if (now - lastJsDebounceTime >= requiredWait) {
       lastJsDebounceTime = now;
       jsDirFired = true;
 
-      if (dir == 4) {  // fizikai JOBBRA → CONFIRM (timer/alarm) / mode forward (böngészés)
-        if (currentMode == 4 && !showingModeTitle) {
-          timer.handleConfirmButton();
-          return;
-        }
-        if (currentMode == 5 && !showingModeTitle) {
-          alarmClock.handleConfirmButton();
-          return;
-        }
+      byte input = dirToGestureInput(dir);
+      if (input == GIN_CANCEL) playButtonBeep(1);  // azonnali visszajelzés, a dupla-nyomás ablak ne késleltesse
+      gestures.press(input, now);
+    }
+  }
+
+  // The button is timed from its ISR edge, not from when this loop got to it
+  ButtonEvent bev;
+  while (buttonInput.nextEvent(bev)) {
+    unsigned long edgeMs = ButtonInput::edgeMillis(bev, now);
+    if (bev.type == BTN_PRESS) {
+      gestures.press(GIN_BUTTON, edgeMs, bev.edgeUs);
+    } else {
+      gestures.release(GIN_BUTTON, edgeMs);
+    }
+  }
+
+  gestures.update(now);
+}
+
+// Ringing timer: every CANCEL must stop it at once, so no double-press window then
+void selectGestureTable() {
+  bool editing = (currentMode == 4 || currentMode == 5 || currentMode == 7 || currentMode == 8 || currentMode == 9 || currentMode == 10 || currentMode == 11) && !showingModeTitle;
+  if (editing && currentMode == 4 && timer.isRinging()) {
+    gestures.setSpecs(nullptr, 0);
+  } else if (editing) {
+    gestures.setSpecs(EDIT_GESTURES, EDIT_GESTURES_COUNT);
+  } else {
+    gestures.setSpecs(BROWSE_GESTURES, BROWSE_GESTURES_COUNT);
+  }
+}
+
+bool isTimerRingingInBackground() {
+  return timer.isRinging() && currentMode != 4;
+}
+
+void handleJoystick() {
+  unsigned long now = millis();
+
+  if (alarmClock.isAlarmActive()) {
+    byte dir = joystick.getDirection();
+    bool btnPressed = false;
+    ButtonEvent ev;
+    while (buttonInput.nextEvent(ev)) {
+      if (ev.type == BTN_PRESS) btnPressed = true;
+    }
+    if ((dir != 0 || btnPressed) && (now - lastJsDebounceTime >= DEBOUNCE_DELAY)) {
+      lastJsDebounceTime = now;
+      if (btnPressed) {
+        // JS gomb = szundi, bármelyik joystick irány = kikapcsolás
+        alarmClock.snooze();
+        showStatusMessage(" SNOOZE ");
+      } else {
+        alarmClock.handleConfirmButton();
+      }
+    }
+    lastJsDirection = dir;
+    gestures.reset();  // a csengés alatti nyomások ne folytassanak egy korábbi sorozatot
+    return;
+  }
+
+  // Background timer ran out while another mode is shown - any input stops it
+  if (isTimerRingingInBackground()) {
+    byte dir = joystick.getDirection();
+    bool btnPressed = false;
+    ButtonEvent ev;
+    while (buttonInput.nextEvent(ev)) {
+      if (ev.type == BTN_PRESS) btnPressed = true;
+    }
+    if ((dir != 0 || btnPressed) && (now - lastJsDebounceTime >= DEBOUNCE_DELAY)) {
+      lastJsDebounceTime = now;
+      timer.handleConfirmButton();
+      lastDisplayUpdate = 0;
+    }
+    lastJsDirection = dir;
+    gestures.reset();
+    return;
+  }
+
+  selectGestureTable();
+  feedGestureInputs(now);
+
+  GestureEvent ev;
+  while (gestures.nextEvent(ev)) {
+    bool timerEditing = currentMode == 4 && !showingModeTitle;
+    bool alarmEditing = currentMode == 5 && !showingModeTitle;
+    bool stopwatchActive = currentMode == 7 && !showingModeTitle;
+
+    bool pomodoroActive = currentMode == 8 && !showingModeTitle;
+    bool remindersEditing = currentMode == 9 && !showingModeTitle;
+    bool reactionActive = currentMode == 10 && !showingModeTitle;
+    bool stopGameActive = currentMode == 11 && !showingModeTitle;
+
+    if (stopwatchActive) {
+      handleStopwatchGesture(ev);
+      continue;
+    }
+    if (pomodoroActive) {
+      handlePomodoroGesture(ev);
+      continue;
+    }
+    if (remindersEditing) {
+      handleReminderGesture(ev);
+      continue;
+    }
+    if (reactionActive) {
+      handleReactionGesture(ev);
+      continue;
+    }
+    if (stopGameActive) {
+      handleStopGameGesture(ev);
+      continue;
+    }
+
+    if (ev.input == GIN_CONFIRM) {  // fizikai JOBBRA → CONFIRM (timer/alarm) / mode forward (böngészés)
+      if (timerEditing) {
+        timer.handleConfirmButton();
+      } else if (alarmEditing) {
+        alarmClock.handleConfirmButton();
+      } else {
         playButtonBeep(2);
         byte newMode = (currentMode + 1 > MAX_MODE) ? MIN_MODE : currentMode + 1;
         startModeSwitch(newMode);
-      } else if (dir == 3) {  // fizikai BALRA → CANCEL (timer/alarm) / mode backward (böngészés)
-        playButtonBeep(1);
-        if (currentMode == 4 && !showingModeTitle) {
-          timer.handleCancelButton();
-          if (timer.shouldExitTimerMode()) {
-            timer.clearExitFlag();
-            currentMode = 0;
-            startModeSwitch(0);
-          }
-          return;
+      }
+    } else if (ev.input == GIN_CANCEL) {  // fizikai BALRA → CANCEL (timer/alarm) / mode backward (böngészés)
+      if (timerEditing) {
+        if (ev.id == GESTURE_CANCEL_DOUBLE) timer.handleCancelDoublePress();
+        else timer.handleCancelButton();
+        if (timer.shouldExitTimerMode()) {
+          timer.clearExitFlag();
+          currentMode = 0;
+          startModeSwitch(0);
         }
-        if (currentMode == 5 && !showingModeTitle) {
-          alarmClock.handleCancelButton();
-          if (alarmClock.shouldExitAlarmMode()) {
-            alarmClock.clearExitFlag();
-            currentMode = 0;
-            startModeSwitch(0);
-          }
-          return;
+      } else if (alarmEditing) {
+        if (ev.id == GESTURE_CANCEL_DOUBLE) alarmClock.handleCancelDoublePress();
+        else alarmClock.handleCancelButton();
+        if (alarmClock.shouldExitAlarmMode()) {
+          alarmClock.clearExitFlag();
+          currentMode = 0;
+          startModeSwitch(0);
         }
+      } else if (ev.id == GESTURE_CLICK) {
         byte newMode = (currentMode == MIN_MODE) ? MAX_MODE : currentMode - 1;
         startModeSwitch(newMode);
-      } else if (dir == 2) {  // fizikai FEL → ADD (timer/alarm) / hármas nyomás (SetTime belépő)
-        if (currentMode == 4 && !showingModeTitle) {
-          playButtonBeep(2);
-          timer.handleAddButton();
-          return;
-        }
-        if (currentMode == 5 && !showingModeTitle) {
-          playButtonBeep(2);
-          alarmClock.handleAddButton();
-          return;
-        }
-        // Triple press → manual time set (FEL 3x) - szándékosan néma, hogy a
-        // számolgatás közben ne csippanjon minden egyes próbálkozásnál
-        if (now - firstConfirmPress <= TRIPLE_PRESS_WINDOW) {
-          confirmPressCount++;
-          if (confirmPressCount >= 3) {
-            enterSetTimeMode();
-            confirmPressCount = 0;
-            firstConfirmPress = 0;
-          }
-        } else {
-          confirmPressCount = 1;
-          firstConfirmPress = now;
-        }
-      } else if (dir == 1) {  // fizikai LE → SUBTRACT (timer/alarm) / óránkénti csengetés ki/be
-        if (currentMode == 4 && !showingModeTitle) {
-          playButtonBeep(3);
-          timer.handleSubtractButton();
-          return;
-        }
-        if (currentMode == 5 && !showingModeTitle) {
-          playButtonBeep(3);
-          alarmClock.handleSubtractButton();
-          return;
-        }
+      }
+    } else if (ev.input == GIN_ADD) {  // fizikai FEL → ADD (timer/alarm) / hármas nyomás (SetTime belépő), duplán dallam
+      if (ev.id == GESTURE_SETTIME_ENTRY) {
+        // szándékosan néma, hogy a számolgatás közben ne csippanjon minden egyes próbálkozásnál
+        enterSetTimeMode();
+        return;
+      }
+      if (ev.id == GESTURE_CHIME_TUNE) {
+        // Next tune, one pass as preview (key-beep priority, never masks a real ring)
+        chimeTune = (chimeTune + 1) % MELODY_LIBRARY_SIZE;
+        settings.setChimeTune(chimeTune);
+        showStatusMessage(MELODY_LIBRARY[chimeTune].name);
+        audio.play(SOUND_KEY_BEEP, MELODY_LIBRARY[chimeTune].notes, MELODY_LIBRARY[chimeTune].length);
+        return;
+      }
+      if (timerEditing) {
+        playButtonBeep(2);
+        timer.handleAddButton();
+      } else if (alarmEditing) {
+        playButtonBeep(2);
+        alarmClock.handleAddButton();
+      }
+    } else if (ev.input == GIN_SUBTRACT) {  // fizikai LE → SUBTRACT (timer/alarm) / óránkénti csengetés ki/be
+      if (timerEditing) {
+        playButtonBeep(3);
+        timer.handleSubtractButton();
+      } else if (alarmEditing) {
+        playButtonBeep(3);
+        alarmClock.handleSubtractButton();
+      } else {
         playButtonBeep(3);
         hourNotificationEnabled = !hourNotificationEnabled;
         showStatusMessage(hourNotificationEnabled ? "CHM ON" : "CHM OFF");
         if (!hourNotificationEnabled && playingHourNotification) {
           playingHourNotification = false;
-          noTone(BUZZER);
+          audio.stop(SOUND_CHIME);
         }
       }
+    } else if (ev.input == GIN_BUTTON) {  // JS gomb → CONFIRM (timer/alarm) / formátum váltás (módok 0-3)
+      playButtonBeep(0);
+      if (timerEditing) {
+        timer.handleConfirmButton();
+      } else if (alarmEditing) {
+        alarmClock.handleConfirmButton();
+      } else if (currentMode == 0) {
+        timeDisplayReversed = !timeDisplayReversed;
+        lastDisplayUpdate = 0;
+      } else if (currentMode == 1) {
+        dateDisplayReversed = !dateDisplayReversed;
+        lastDisplayUpdate = 0;
+      } else if (currentMode == 2) {
+        dayDisplayReversed = !dayDisplayReversed;
+        lastDisplayUpdate = 0;
+      } else if (currentMode == 3) {
+        tempFahrenheit = !tempFahrenheit;
+        lastDisplayUpdate = 0;
+      }
+      buttonInput.noteHandled(ev.edgeUs);
     }
   }
+}
 
-  // --- Gomb (JS SW) debounce ---
-  bool btnRaw = joystick.getButtonPress();
-  if (btnRaw != lastJsButtonState) lastJsBtnDebounceTime = now;
-  if ((now - lastJsBtnDebounceTime) > DEBOUNCE_DELAY) {
-    if (btnRaw != jsButtonState) {
-      jsButtonState = btnRaw;
-      if (jsButtonState) {
-        playButtonBeep(0);
-        if (currentMode == 4 && !showingModeTitle) {
-          timer.handleConfirmButton();
-        } else if (currentMode == 5 && !showingModeTitle) {
-          alarmClock.handleConfirmButton();
-        } else if (currentMode == 0) {
-          timeDisplayReversed = !timeDisplayReversed;
-          lastDisplayUpdate = 0;
-        } else if (currentMode == 1) {
-          dateDisplayReversed = !dateDisplayReversed;
-          lastDisplayUpdate = 0;
-        } else if (currentMode == 2) {
-          dayDisplayReversed = !dayDisplayReversed;
-          lastDisplayUpdate = 0;
-        } else if (currentMode == 3) {
-          tempFahrenheit = !tempFahrenheit;
-          lastDisplayUpdate = 0;
-        }
-      }
+// Stopwatch: JOBBRA / JS gomb = start-stop / kör, FEL-LE = körök lapozása,
+// BALRA egyszer = kör nézet vége / leállított stopper nullázása, duplán = kilépés
+void handleStopwatchGesture(const GestureEvent &ev) {
+  if (ev.input == GIN_CONFIRM) {
+    playButtonBeep(0);
+    stopwatch.handleStartStop();
+  } else if (ev.input == GIN_BUTTON) {
+    playButtonBeep(0);
+    if (stopwatch.isRunning()) stopwatch.handleLap();
+    else stopwatch.handleStartStop();
+    buttonInput.noteHandled(ev.edgeUs);
+  } else if (ev.input == GIN_ADD) {
+    playButtonBeep(2);
+    stopwatch.handleNextLap();
+  } else if (ev.input == GIN_SUBTRACT) {
+    playButtonBeep(3);
+    stopwatch.handlePreviousLap();
+  } else if (ev.input == GIN_CANCEL) {
+    if (ev.id == GESTURE_CANCEL_DOUBLE) {
+      currentMode = 0;
+      startModeSwitch(0);
+    } else {
+      stopwatch.handleCancelButton();
     }
   }
-  lastJsButtonState = btnRaw;
 }
 
-void enterSetTimeMode() {
-  inSetTimeMode = true;
-  setTime.reset(currentTime.year, currentTime.month, currentTime.day, currentTime.hour, currentTime.minute);
+// Pomodoro: JOBBRA / JS gomb = következő beállítás / indítás, FEL-LE = perc,
+// BALRA egyszer = futó ciklus leállítása / vissza a munka percre, duplán = kilépés
+void handlePomodoroGesture(const GestureEvent &ev) {
+  if (ev.input == GIN_CONFIRM || ev.input == GIN_BUTTON) {
+    playButtonBeep(0);
+    pomodoro.handleConfirmButton();
+    if (ev.input == GIN_BUTTON) buttonInput.noteHandled(ev.edgeUs);
+  } else if (ev.input == GIN_ADD) {
+    playButtonBeep(2);
+    pomodoro.handleAddButton();
+  } else if (ev.input == GIN_SUBTRACT) {
+    playButtonBeep(3);
+    pomodoro.handleSubtractButton();
+  } else if (ev.input == GIN_CANCEL) {
+    if (ev.id == GESTURE_CANCEL_DOUBLE) pomodoro.handleCancelDoublePress();
+    else pomodoro.handleCancelButton();
+  }
 }
 
-// Same debounce pattern as handleJoystick(), routed to the SetTime instance instead of mode/timer/alarm
-void handleSetTimeJoystick() {
-  unsigned long now = millis();
+// Reminders: JOBBRA / JS gomb = következő mező (felirat: következő karakter),
+// FEL-LE = érték / karakter, BALRA egyszer = mező reset, duplán = kilépés mentés nélkül
+void handleReminderGesture(const GestureEvent &ev) {
+  if (ev.input == GIN_CONFIRM || ev.input == GIN_BUTTON) {
+    playButtonBeep(0);
+    reminders.handleConfirmButton();
+    if (ev.input == GIN_BUTTON) buttonInput.noteHandled(ev.edgeUs);
+  } else if (ev.input == GIN_ADD) {
+    playButtonBeep(2);
+    reminders.handleAddButton();
+  } else if (ev.input == GIN_SUBTRACT) {
+    playButtonBeep(3);
+    reminders.handleSubtractButton();
+  } else if (ev.input == GIN_CANCEL) {
+    if (ev.id == GESTURE_CANCEL_DOUBLE) reminders.handleCancelDoublePress();
+    else reminders.handleCancelButton();
+  }
+}
 
-  byte dir = joystick.getDirection();
-  if (dir != lastJsDirection) {
-    lastJsDebounceTime = now;
-    lastJsDirection = dir;
-    jsDirFired = false;
+// Reaction tester: JS gomb = indítás / reakció (az ISR időbélyegével), FEL-LE =
+// legjobb idők, BALRA egyszer = kör megszakítása, duplán = kilépés.
+// Nincs gombnyomás-csippanás: a reakció közben zavarna, és a mérést sem késleltetheti.
+void handleReactionGesture(const GestureEvent &ev) {
+  if (ev.input == GIN_BUTTON) {
+    reaction.handlePress(ev.edgeUs);
+    buttonInput.noteHandled(ev.edgeUs);
+  } else if (ev.input == GIN_ADD) {
+    reaction.handleNextBest();
+  } else if (ev.input == GIN_SUBTRACT) {
+    reaction.handlePreviousBest();
+  } else if (ev.input == GIN_CANCEL) {
+    if (ev.id == GESTURE_CANCEL_DOUBLE) reaction.handleCancelDoublePress();
+    else reaction.handleCancelButton();
   }
-  if (dir != 0) {
-    unsigned long requiredWait = jsDirFired ? JOYSTICK_REPEAT_INTERVAL : DEBOUNCE_DELAY;
-    if (now - lastJsDebounceTime >= requiredWait) {
-      lastJsDebounceTime = now;
-      jsDirFired = true;
+}
 
-      if (dir == 4) {  // fizikai JOBBRA → CONFIRM
-        playButtonBeep(0);
-        setTime.handleConfirmButton();
-      } else if (dir == 3) {  // fizikai BALRA → CANCEL (egyszer = mező reset, duplán = megszakít)
-        playButtonBeep(1);
-        setTime.handleCancelButton();
-      } else if (dir == 2) {  // fizikai FEL → ADD
-        playButtonBeep(2);
-        setTime.handleAddButton();
-      } else if (dir == 1) {  // fizikai LE → SUBTRACT
-        playButtonBeep(3);
-        setTime.handleSubtractButton();
-      }
-    }
+// Stop game: JS gomb = start / stop (az ISR időbélyegével), BALRA egyszer =
+// kör megszakítása, duplán = kilépés. Csippanás nincs, ne zavarja a számolást.
+void handleStopGameGesture(const GestureEvent &ev) {
+  if (ev.input == GIN_BUTTON) {
+    stopGame.handlePress(ev.edgeUs);
+    buttonInput.noteHandled(ev.edgeUs);
+  } else if (ev.input == GIN_CANCEL) {
+    if (ev.id == GESTURE_CANCEL_DOUBLE) stopGame.handleCancelDoublePress();
+    else stopGame.handleCancelButton();
   }
+}
 
-  // JS button (SW) - also CONFIRM
-  bool btnRaw = joystick.getButtonPress();
-  if (btnRaw != lastJsButtonState) lastJsBtnDebounceTime = now;
-  if ((now - lastJsBtnDebounceTime) > DEBOUNCE_DELAY) {
-    if (btnRaw != jsButtonState) {
-      jsButtonState = btnRaw;
-      if (jsButtonState) {
-        playButtonBeep(0);
-        setTime.handleConfirmButton();
-      }
+void enterSetTimeMode() {
+  inSetTimeMode = true;
+  setTime.reset(currentTime.year, currentTime.month, currentTime.day, currentTime.hour, currentTime.minute);
+}
+
+// Same input path as handleJoystick(), routed to the SetTime instance instead of mode/timer/alarm
+void handleSetTimeJoystick() {
+  gestures.setSpecs(EDIT_GESTURES, EDIT_GESTURES_COUNT);
+  feedGestureInputs(millis());
+
+  GestureEvent ev;
+  while (gestures.nextEvent(ev)) {
+    if (ev.input == GIN_CONFIRM) {  // fizikai JOBBRA → CONFIRM
+      playButtonBeep(0);
+      setTime.handleConfirmButton();
+    } else if (ev.input == GIN_CANCEL) {  // fizikai BALRA → CANCEL (egyszer = mező reset, duplán = megszakít)
+      if (ev.id == GESTURE_CANCEL_DOUBLE) setTime.handleCancelDoublePress();
+      else setTime.handleCancelButton();
+    } else if (ev.input == GIN_ADD) {  // fizikai FEL → ADD
+      playButtonBeep(2);
+      setTime.handleAddButton();
+    } else if (ev.input == GIN_SUBTRACT) {  // fizikai LE → SUBTRACT
+      playButtonBeep(3);
+      setTime.handleSubtractButton();
+    } else if (ev.input == GIN_BUTTON) {  // JS button (SW) - also CONFIRM
+      playButtonBeep(0);
+      setTime.handleConfirmButton();
+      buttonInput.noteHandled(ev.edgeUs);
     }
   }
-  lastJsButtonState = btnRaw;
 }
 
 void updateTimeSource() {
   // Feed the NMEA parser (non-blocking - no-op if GPS isn't wired in at all)
   gps.update();
+  if (gps.charsProcessed() > 0) bootTimeline.mark(BOOT_GPS_FIRST_BYTE);
 
   if (gps.hasFix()) {
+    bootTimeline.mark(BOOT_GPS_FIRST_FIX);
+
     if (!gpsAvailable) {
       gpsAvailable = true;
       showStatusMessage(" GPS OK ");
     }
 
+    // DST started / ended on the fix: resync now, not up to a minute later
+    int utcOffset = gps.getUtcOffsetHours();
+    if (gpsUtcOffset != 0 && utcOffset != gpsUtcOffset) {
+      gpsDstStepS = (utcOffset - gpsUtcOffset) * 3600;
+      lastGpsRtcSync = 0;
+    }
+    gpsUtcOffset = utcOffset;
+
     // Periodically resync the RTC from GPS. If GPS is never wired in, hasFix()
     // just stays false forever and this block never runs - the RTC (or a
     // manual time set) is then the only time source, as intended.
-    if (rtcAvailable && (lastGpsRtcSync == 0 || millis() - lastGpsRtcSync >= GPS_RTC_SYNC_INTERVAL)) {
+    // While a big step is waiting for confirmation the fixes are checked
+    // every few seconds instead of once a minute.
+    // Only right after a sentence, against a fresh RTC read: then both
+    // seconds have just begun, and an RTC ticking a little after the GPS
+    // (one second behind) is in step - writing it would only restart its
+    // countdown at the same phase again.
+    unsigned long syncInterval = gpsTimeFilter.isConfirming() ? GPS_CONFIRM_RECHECK_MS : GPS_RTC_SYNC_INTERVAL;
+    if (rtcAvailable && gps.getFixAgeMs() < GPS_SYNC_MAX_AGE_MS && (lastGpsRtcSync == 0 || millis() - lastGpsRtcSync >= syncInterval)) {
       int year, month, day, dayIndex, hour, minute, second;
       gps.getHungarianTime(year, month, day, dayIndex, hour, minute, second);
 
-      if (year >= SETTIME_MIN_YEAR) {  // sanity guard against a bad/partial fix
-        rtc.adjust(DateTime(year, month, day, hour, minute, second));
+      uint32_t rtcEpoch = 0;  // RTC without a valid time yet
+      if (currentTime.epoch) {
+        uint32_t traceStart = I2C_TRACE_ENABLED ? micros() : 0;
+        rtcEpoch = rtc.now().unixtime();
+        i2cTrace.recordRead(DS3231_ADDR, 7, traceStart);
+      }
+      if (gpsTimeFilter.accept(year, month, day, hour, minute, second, rtcEpoch, gpsDstStepS)) {
+        DateTime fix(year, month, day, hour, minute, second);
+        int64_t rtcBehind = (int64_t)fix.unixtime() - rtcEpoch;
+        if (rtcEpoch == 0 || (rtcBehind != 0 && rtcBehind != 1)) {
+          rtc.adjust(fix);
+          clockEvents.noteTimeAdjusted();
+          lastRtcRead = 0;  // re-read below, so the scheduler sees the corrected time in this loop
+        }
+        gpsDstStepS = 0;
+        bootTimeline.mark(BOOT_GPS_RTC_SYNC);
       }
       lastGpsRtcSync = millis();
     }
@@ -636,12 +1021,18 @@ void updateTimeSource() {
     gpsAvailable = false;
   }
 
+  // DS3231 alarm matched - read the time right now instead of at the next poll
+  if (rtcAlarms.poll()) lastRtcRead = 0;
+
   // RTC is the single source of truth for the displayed time/date
-  if (rtcAvailable && (millis() - lastRtcRead >= RTC_READ_INTERVAL)) {
+  if (rtcAvailable && (lastRtcRead == 0 || millis() - lastRtcRead >= RTC_READ_INTERVAL)) {
     lastRtcRead = millis();
 
+    uint32_t traceStart = I2C_TRACE_ENABLED ? micros() : 0;
     DateTime now = rtc.now();
+    i2cTrace.recordRead(DS3231_ADDR, 7, traceStart);
     if (now.isValid()) {
+      bootTimeline.mark(BOOT_RTC_FIRST_VALID);
       currentTime.year = now.year();
       currentTime.month = now.month();
       currentTime.day = now.day();
@@ -649,6 +1040,7 @@ void updateTimeSource() {
       currentTime.hour = now.hour();
       currentTime.minute = now.minute();
       currentTime.second = now.second();
+      currentTime.epoch = now.unixtime();
     }
   }
 }
@@ -658,7 +1050,7 @@ void updateTDDisplay() {
   // display while it's ringing - don't let the normal per-mode logic below
   // race against it and flicker between "WAKE UP" and whatever mode is on
   // screen.
-  if (alarmClock.isAlarmActive()) return;
+  if (alarmClock.isAlarmActive() || isTimerRingingInBackground()) return;
 
   // Check if we're showing a status message
   if (showingStatusMessage) {
@@ -681,6 +1073,26 @@ void updateTDDisplay() {
     alarmClock.update();
     return;
   }
+  if (currentMode == 7) {
+    stopwatch.update();
+    return;
+  }
+  if (currentMode == 8) {
+    pomodoro.update();
+    return;
+  }
+  if (currentMode == 9) {
+    reminders.update();
+    return;
+  }
+  if (currentMode == 10) {
+    reaction.update();
+    return;
+  }
+  if (currentMode == 11) {
+    stopGame.update();
+    return;
+  }
 
   // Regular display updates (only when not showing mode title)
   if (millis() - lastDisplayUpdate >= displayUpdateInterval) {
@@ -691,7 +1103,7 @@ void updateTDDisplay() {
     } else {
       switch (currentMode) {
         case 0:
-          HDSP.displayTime(currentTime.hour, currentTime.minute, currentTime.second, timeDisplayReversed);
+          HDSP.displayTime(currentTime.hour, currentTime.minute, currentTime.second, timeDisplayReversed, timerPool.getRunningCount() > 0 ? '.' : ':');
           break;
         case 1:
           HDSP.displayYearMonth(currentTime.year, currentTime.month, dateDisplayReversed);
@@ -719,67 +1131,73 @@ void updateTDDisplay() {
 }
 
 void runDisplayTypeSetup() {
-  pinMode(BUZZER, OUTPUT);
   pinMode(JS_SW, INPUT_PULLUP);
 
-  uint8_t selectedType = preferences.getUChar("clockType", DEFAULT_CLOCK_TYPE);
+  uint8_t selectedType = settings.get().clockType;
   HDSP.setClockType(selectedType);
   HDSP.begin();
+
+  // Gyors boot: ha már van eltárolt típus és a gomb NINCS nyomva bekapcsoláskor,
+  // a setup képernyő kimarad. Setup csak első indításkor vagy nyomva tartott gombbal.
+  bool heldAtPowerOn = (digitalRead(JS_SW) == LOW);
+  if (heldAtPowerOn) {
+    delay(DEBOUNCE_DELAY);
+    heldAtPowerOn = (digitalRead(JS_SW) == LOW);  // zajszűrés
+  }
+  if (settings.hasClockType() && !heldAtPowerOn) return;
+
   HDSP.forceDisplayText(DISPLAY_TEST_TEXT);
 
-  bool wasPressed = false;
+  // A belépéshez nyomva tartott gombot előbb el kell engedni, különben a
+  // nyomva tartás rögtön confirm-nak számítana
+  while (digitalRead(JS_SW) == LOW) {
+    HDSP.update();
+    delay(5);
+  }
+  delay(DEBOUNCE_DELAY);
+  buttonInput.poll();
+  buttonInput.clear();
+
+  gestures.setSpecs(SETUP_GESTURES, SETUP_GESTURES_COUNT);
+  gestures.reset();
   unsigned long pressStart = 0;
-  byte pressCount = 0;
-  unsigned long lastReleaseTime = 0;
-  bool longPressHandled = false;
 
   while (true) {
-    bool isPressed = (digitalRead(JS_SW) == LOW);
-
-    // lenyomás (falling edge)
-    if (isPressed && !wasPressed) {
-      delay(DEBOUNCE_DELAY);
-      if (digitalRead(JS_SW) != LOW) continue;  // zajszűrés
-      wasPressed = true;
-      pressStart = millis();
-      longPressHandled = false;
+    HDSP.update();
+    buttonInput.poll();
+    unsigned long now = millis();
+
+    ButtonEvent bev;
+    while (buttonInput.nextEvent(bev)) {
+      unsigned long edgeMs = ButtonInput::edgeMillis(bev, now);
+      if (bev.type == BTN_PRESS) {
+        pressStart = edgeMs;
+        gestures.press(GIN_BUTTON, edgeMs);
+      } else {
+        if (edgeMs - pressStart < DISPLAY_SETUP_CONFIRM_HOLD) audio.play(SOUND_KEY_BEEP, SETUP_CLICK_BEEP, 1);  // rövid nyomás visszajelzés
+        gestures.release(GIN_BUTTON, edgeMs);
+      }
     }
-
-    // nyomva tartás - 2mp után confirm
-    if (isPressed && wasPressed && !longPressHandled) {
-      if (millis() - pressStart >= DISPLAY_SETUP_CONFIRM_HOLD) {
-        longPressHandled = true;
-        preferences.putUChar("clockType", selectedType);
-        tone(BUZZER, 1500, 300);
-        delay(300);
+    gestures.update(now);
+
+    GestureEvent ev;
+    while (gestures.nextEvent(ev)) {
+      if (ev.id == GESTURE_SETUP_CONFIRM) {
+        // nyomva tartás - 2mp után confirm
+        settings.setClockType(selectedType);
+        settings.commit();
+        audio.play(SOUND_KEY_BEEP, SETUP_CONFIRM_BEEP, 1);
+        delay(300);  // a startup dallam (magasabb prioritás) ne vágjon bele
         return;  // confirmed - az óra normálisan indul tovább
       }
-    }
-
-    // elengedés (rising edge)
-    if (!isPressed && wasPressed) {
-      delay(DEBOUNCE_DELAY);
-      if (digitalRead(JS_SW) == LOW) continue;  // zajszűrés
-      wasPressed = false;
-
-      if (!longPressHandled) {
-        if (millis() - lastReleaseTime > DISPLAY_SETUP_PRESS_WINDOW) {
-          pressCount = 0;  // túl nagy szünet, újrakezdjük a számlálást
-        }
-        pressCount++;
-        lastReleaseTime = millis();
-        tone(BUZZER, 800, 30);
-
-        if (pressCount >= DISPLAY_SETUP_SWITCH_PRESSES) {
-          selectedType = selectedType ? 0 : 1;
-          HDSP.setClockType(selectedType);
-          HDSP.begin();
-          HDSP.forceDisplayText(DISPLAY_TEST_TEXT);
-          pressCount = 0;
-        }
+      if (ev.id == GESTURE_SETUP_SWITCH) {
+        selectedType = selectedType ? 0 : 1;
+        HDSP.setClockType(selectedType);
+        HDSP.begin();
+        HDSP.forceDisplayText(DISPLAY_TEST_TEXT);
       }
     }
 
     delay(5);
   }
-}
\ No newline at end of file
+}
@@ -0,0 +1,219 @@
+#pragma once
+
+#include "constants.h"
+
+// Gesture classifier shared by every mode: multi-click series and long holds
+// on the logical inputs, driven by press/release edges with explicit
+// timestamps (no millis() inside, no allocation - the spec tables are const
+// arrays owned by the caller and swapped per context).
+
+enum GestureInput : byte {
+  GIN_CONFIRM = 0,  // fizikai JOBBRA
+  GIN_CANCEL,       // fizikai BALRA
+  GIN_ADD,          // fizikai FEL
+  GIN_SUBTRACT,     // fizikai LE
+  GIN_BUTTON,       // JS SW
+  GIN_COUNT
+};
+
+// Emitted for a press on an input that has no spec in the active table
+const byte GESTURE_CLICK = 0;
+
+struct GestureSpec {
+  byte id;            // application gesture id, != GESTURE_CLICK
+  byte input;         // GestureInput
+  byte clicks;        // N clicks in a series, or 0 = hold
+  uint16_t windowMs;  // clicks: max gap between two clicks of the series; hold: hold duration
+  uint16_t seriesMs;  // clicks: max time from the first to the last click, 0 = no limit
+};
+
+struct GestureEvent {
+  byte id;
+  byte input;
+  byte clicks;
+  uint32_t edgeUs;  // edgeUs given with the last press of the gesture
+};
+
+class GestureEngine {
+private:
+  struct InputState {
+    bool pressed;
+    bool holdFired;
+    byte clickCount;
+    unsigned long pressStart;
+    unsigned long lastClick;
+    unsigned long firstClick;
+    uint32_t pressEdgeUs;
+  };
+
+  const GestureSpec* specs;
+  byte specCount;
+  InputState inputs[GIN_COUNT];
+
+  GestureEvent events[GESTURE_EVENT_QUEUE_SIZE];
+  byte eventHead;
+  byte eventTail;
+
+  void push(byte id, byte input, byte clicks) {
+    events[eventHead].id = id;
+    events[eventHead].input = input;
+    events[eventHead].clicks = clicks;
+    events[eventHead].edgeUs = inputs[input].pressEdgeUs;
+    eventHead = (eventHead + 1) % GESTURE_EVENT_QUEUE_SIZE;
+    if (eventHead == eventTail) eventTail = (eventTail + 1) % GESTURE_EVENT_QUEUE_SIZE;
+  }
+
+  bool hasSpecs(byte input) const {
+    for (byte i = 0; i < specCount; i++) {
+      if (specs[i].input == input) return true;
+    }
+    return false;
+  }
+
+  const GestureSpec* findHold(byte input) const {
+    for (byte i = 0; i < specCount; i++) {
+      if (specs[i].input == input && specs[i].clicks == 0) return &specs[i];
+    }
+    return nullptr;
+  }
+
+  const GestureSpec* findClicks(byte input, byte clicks) const {
+    for (byte i = 0; i < specCount; i++) {
+      if (specs[i].input == input && specs[i].clicks == clicks) return &specs[i];
+    }
+    return nullptr;
+  }
+
+  byte maxClicks(byte input) const {
+    byte result = 0;
+    for (byte i = 0; i < specCount; i++) {
+      if (specs[i].input == input && specs[i].clicks > result) result = specs[i].clicks;
+    }
+    return result;
+  }
+
+  unsigned long clickWindow(byte input) const {
+    unsigned long result = 0;
+    for (byte i = 0; i < specCount; i++) {
+      if (specs[i].input == input && specs[i].clicks > 0 && specs[i].windowMs > result) result = specs[i].windowMs;
+    }
+    return result;
+  }
+
+  unsigned long seriesLimit(byte input) const {
+    unsigned long result = 0;
+    for (byte i = 0; i < specCount; i++) {
+      if (specs[i].input == input && specs[i].clicks > 0 && specs[i].seriesMs > result) result = specs[i].seriesMs;
+    }
+    return result;
+  }
+
+  // The series can't grow any more: gap too long, or past its total length
+  bool seriesExpired(byte input, unsigned long now) const {
+    const InputState& st = inputs[input];
+    unsigned long limit = seriesLimit(input);
+    return now - st.lastClick > clickWindow(input) || (limit > 0 && now - st.firstClick > limit);
+  }
+
+  // Series over: emit the spec for exactly this many clicks (if there is one
+  // and the series fit in its own seriesMs)
+  void closeSeries(byte input) {
+    InputState& st = inputs[input];
+    const GestureSpec* spec = findClicks(input, st.clickCount);
+    if (spec && (spec->seriesMs == 0 || st.lastClick - st.firstClick <= spec->seriesMs)) push(spec->id, input, st.clickCount);
+    st.clickCount = 0;
+  }
+
+  void registerClick(byte input, unsigned long now) {
+    InputState& st = inputs[input];
+    if (st.clickCount > 0 && seriesExpired(input, now)) closeSeries(input);
+
+    if (st.clickCount == 0) st.firstClick = now;
+    st.clickCount++;
+    st.lastClick = now;
+
+    // Nothing longer can match any more - no point waiting out the window
+    if (st.clickCount >= maxClicks(input)) closeSeries(input);
+  }
+
+public:
+  GestureEngine()
+    : specs(nullptr), specCount(0), eventHead(0), eventTail(0) {
+    reset();
+  }
+
+  // Swapping tables drops any half-finished series from the previous context
+  void setSpecs(const GestureSpec* table, byte count) {
+    if (table == specs && count == specCount) return;
+    specs = table;
+    specCount = count;
+    reset();
+  }
+
+  void reset() {
+    for (byte i = 0; i < GIN_COUNT; i++) {
+      inputs[i].pressed = false;
+      inputs[i].holdFired = false;
+      inputs[i].clickCount = 0;
+      inputs[i].pressStart = 0;
+      inputs[i].lastClick = 0;
+      inputs[i].firstClick = 0;
+      inputs[i].pressEdgeUs = 0;
+    }
+    eventTail = eventHead;
+  }
+
+  // Clicks are counted on press, unless the input also has a hold gesture -
+  // then only a release before the hold time makes it a click. edgeUs is
+  // handed back untouched on the gesture event (several presses may be fed
+  // before the events are drained).
+  void press(byte input, unsigned long now, uint32_t edgeUs = 0) {
+    InputState& st = inputs[input];
+    st.pressed = true;
+    st.pressEdgeUs = edgeUs;
+    st.holdFired = false;
+    st.pressStart = now;
+
+    if (!hasSpecs(input)) {
+      push(GESTURE_CLICK, input, 1);  // nothing to disambiguate - deliver right away
+      return;
+    }
+    if (!findHold(input)) registerClick(input, now);
+  }
+
+  void release(byte input, unsigned long now) {
+    InputState& st = inputs[input];
+    if (!st.pressed) return;
+    st.pressed = false;
+
+    if (st.holdFired || !findHold(input)) return;
+    registerClick(input, now);
+  }
+
+  // Hold timeouts and series timeouts - call every loop()
+  void update(unsigned long now) {
+    for (byte i = 0; i < GIN_COUNT; i++) {
+      InputState& st = inputs[i];
+
+      if (st.pressed && !st.holdFired) {
+        const GestureSpec* hold = findHold(i);
+        if (hold && now - st.pressStart >= hold->windowMs) {
+          st.holdFired = true;
+          st.clickCount = 0;
+          push(hold->id, i, 0);
+        }
+      }
+
+      if (st.clickCount > 0 && !st.pressed && seriesExpired(i, now)) {
+        closeSeries(i);
+      }
+    }
+  }
+
+  bool nextEvent(GestureEvent& event) {
+    if (eventTail == eventHead) return false;
+    event = events[eventTail];
+    eventTail = (eventTail + 1) % GESTURE_EVENT_QUEUE_SIZE;
+    return true;
+  }
+};
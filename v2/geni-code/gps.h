@@ -5,6 +5,8 @@
 #include "constants.h"
 
 class GPS {
+  friend class Benchmark;  // bench.h - private hot paths are timed directly
+
 private:
   HardwareSerial gpsSerial;
   TinyGPSPlus gps;
@@ -34,7 +36,7 @@ private:
 
     // Correct Zeller's result: 0=Saturday, 1=Sunday, 2=Monday, etc.
     // Convert to standard: 0=Sunday, 1=Monday, 2=Tuesday, ..., 6=Saturday
-    return (f + 1) % 7;
+    return (f + 6) % 7;
   }
 
   // Check if it's daylight saving time in Hungary (CEST)
@@ -170,6 +172,13 @@ private:
     int minute = gps.time.minute();
     int second = gps.time.second();
 
+    // A checksum-valid sentence can still carry a nonsense date - the
+    // month indexes daysInMonth[] in the conversion below
+    if (month < 1 || month > 12 || day < 1 || day > 31 || hour > 23 || minute > 59 || second > 59) {
+      timeCache.valid = false;
+      return;
+    }
+
     // Convert to Hungarian time
     convertToHungarianTime(year, month, day, hour, minute, second);
 
@@ -229,8 +238,27 @@ public:
     }
   }
 
+  // Number of NMEA bytes fed to the parser so far (0 = module silent / not wired)
+  uint32_t charsProcessed() {
+    return gps.charsProcessed();
+  }
+
+  // TinyGPSPlus keeps its last values valid forever - a module that went
+  // silent (unplugged, brown-out) would hand out an ever older time
   bool hasFix() {
-    return gps.location.isValid() && gps.date.isValid() && gps.time.isValid();
+    return gps.location.isValid() && gps.date.isValid() && gps.time.isValid() && gps.time.age() < GPS_FIX_MAX_AGE_MS;
+  }
+
+  // Milliseconds since the last sentence with a time in it. Right after one,
+  // the time is the second that has just begun.
+  uint32_t getFixAgeMs() {
+    return gps.time.age();
+  }
+
+  // Hungarian UTC offset (hours) at the current fix, 0 without a fix
+  int getUtcOffsetHours() {
+    if (!hasFix()) return 0;
+    return getHungarianTimezoneOffset(gps.date.year(), gps.date.month(), gps.date.day(), gps.time.hour());
   }
 
   double getLatitude() {
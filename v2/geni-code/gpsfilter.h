@@ -0,0 +1,106 @@
+#pragma once
+
+#include <RTClib.h>
+#include "constants.h"
+
+// Plausibility gate between a GPS fix and rtc.adjust(). A glitching
+// receiver can hand over a checksum-valid sentence with a garbage date, and
+// one bad write would move the RTC (and every alarm / reminder with it).
+//
+//  - the fix must be a real calendar time within SETTIME_MIN/MAX_YEAR;
+//  - a correction of at most GPS_MAX_STEP_S against the running RTC is
+//    normal drift and goes through at once;
+//  - anything bigger (RTC lost power, first sync, real error) needs
+//    GPS_CONFIRM_FIXES consecutive fixes agreeing on the same offset
+//    (within GPS_CONFIRM_TOLERANCE_S) - random garbage doesn't repeat;
+//  - a step of more than GPS_BIG_STEP_S against a running RTC also has to
+//    hold for GPS_BIG_STEP_CONFIRM_MS: a cold-starting module that reports
+//    a default date for a while is outwaited;
+//  - except the DST hour: when the caller saw the fix's UTC offset change,
+//    that step (within GPS_MAX_STEP_S) goes through at once too.
+//
+// Without a valid RTC time the offset is taken against millis(), which
+// advances at the same rate, so the consistency check still works.
+//
+// Limitation: a receiver that is consistently wrong - e.g. stuck on a GPS
+// week rollover date - agrees with itself, so its time wins once the
+// confirmation (or the big-step hold) is through. Only the year range
+// stops it; a rollover (1024 weeks back) lands before SETTIME_MIN_YEAR
+// until about 2043.
+class GpsTimeFilter {
+private:
+  int64_t candidateOffset;  // offset the pending confirmation is about
+  byte confirmations;       // consecutive fixes that agreed so far, 0 = none pending
+  unsigned long candidateSince;  // millis() of the first fix with candidateOffset
+  uint32_t rejected;
+
+public:
+  GpsTimeFilter()
+    : candidateOffset(0), confirmations(0), candidateSince(0), rejected(0) {}
+
+  // rtcEpoch = the RTC's current local unixtime, 0 if it has no valid time.
+  // expectedStepS = DST change on the fix (+3600 / -3600), 0 = none.
+  // True = fix may be written into the RTC.
+  bool accept(int year, int month, int day, int hour, int minute, int second, uint32_t rtcEpoch, int32_t expectedStepS = 0) {
+    DateTime fix(year >= 2000 ? year : 2000, month, day, hour, minute, second);
+    if (year < SETTIME_MIN_YEAR || year > SETTIME_MAX_YEAR || month < 1 || month > 12 || day < 1 || day > 31 ||
+        hour < 0 || hour > 23 || minute < 0 || minute > 59 || second < 0 || second > 59 || !fix.isValid()) {
+      confirmations = 0;
+      rejected++;
+      if (GPS_FILTER_LOG) {
+        Serial.printf("GPS time rejected: %d-%d-%d %d:%d:%d is not a valid date (%lu so far)\n",
+                      year, month, day, hour, minute, second, (unsigned long)rejected);
+      }
+      return false;
+    }
+
+    bool rtcValid = rtcEpoch != 0;
+    int64_t reference = rtcValid ? (int64_t)rtcEpoch : (int64_t)(millis() / 1000);
+    int64_t offset = (int64_t)fix.unixtime() - reference;
+
+    if (rtcValid && offset <= (int64_t)GPS_MAX_STEP_S && offset >= -(int64_t)GPS_MAX_STEP_S) {
+      confirmations = 0;
+      return true;
+    }
+
+    int64_t dstError = offset - expectedStepS;
+    if (rtcValid && expectedStepS != 0 && dstError <= (int64_t)GPS_MAX_STEP_S && dstError >= -(int64_t)GPS_MAX_STEP_S) {
+      Serial.printf("GPS time: %+lld s DST step\n", (long long)offset);
+      confirmations = 0;
+      return true;
+    }
+
+    int64_t diff = offset - candidateOffset;
+    if (confirmations == 0 || diff > (int64_t)GPS_CONFIRM_TOLERANCE_S || diff < -(int64_t)GPS_CONFIRM_TOLERANCE_S) {
+      candidateOffset = offset;
+      confirmations = 1;
+      candidateSince = millis();
+    } else if (confirmations < 255) {
+      confirmations++;
+    }
+
+    bool bigStep = rtcValid && (offset > (int64_t)GPS_BIG_STEP_S || offset < -(int64_t)GPS_BIG_STEP_S);
+    bool held = !bigStep || millis() - candidateSince >= GPS_BIG_STEP_CONFIRM_MS;
+    if (confirmations >= GPS_CONFIRM_FIXES && held) {
+      Serial.printf("GPS time: %+lld s step confirmed by %u fixes\n", (long long)offset, confirmations);
+      confirmations = 0;
+      return true;
+    }
+    if (GPS_FILTER_LOG && confirmations < GPS_CONFIRM_FIXES) {
+      Serial.printf("GPS time: %+lld s step, waiting for confirmation (%u/%u)\n", (long long)offset, confirmations, GPS_CONFIRM_FIXES);
+    } else if (GPS_FILTER_LOG && confirmations == GPS_CONFIRM_FIXES) {
+      Serial.printf("GPS time: %+lld s step against a running RTC, holding for %lu s\n", (long long)offset,
+                    (unsigned long)(GPS_BIG_STEP_CONFIRM_MS / 1000));
+    }
+    return false;
+  }
+
+  // A confirmation is in progress - the caller re-checks sooner
+  bool isConfirming() const {
+    return confirmations > 0;
+  }
+
+  uint32_t getRejectedCount() const {
+    return rejected;
+  }
+};
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <Arduino.h>
+#include "constants.h"
+
+// One I2C transaction. 12 bytes - I2C_TRACE_CAPACITY of them fit in a few KB.
+struct I2cTraceRecord {
+  uint32_t startUs;  // micros() at beginTransmission / before the read
+  uint16_t busUs;    // time spent in the Wire calls (saturates at 65535)
+  uint8_t addr;      // 7-bit device address
+  uint8_t len;       // bytes written (or read), only the first 3 are kept
+  uint8_t flags;     // I2C_TRACE_READ | Wire.endTransmission() status
+  uint8_t data[3];   // MCP23017: register, GPA, GPB
+};
+
+const uint8_t I2C_TRACE_READ = 0x80;  // opaque read (RTClib) - no payload recorded
+
+// Compact binary trace (.i2ct) - the board's report() and the host Wire
+// recorder (v2/host/sim/i2crecorder.h) write the same thing, the host's
+// i2ctrace tool dumps / compares it:
+//   "GI2T" <version>, then per transaction
+//   varint  us since the previous start (the first one: since boot)
+//   varint  bus us
+//   byte    7-bit address | 0x80 for a read
+//   byte    Wire.endTransmission() status, 0 = ACK
+//   varint  bytes transferred
+//   byte    bytes kept (the board: 3, reads none; the host: all), then them
+// An MCP23017 register write comes to about 10 bytes.
+const uint8_t I2C_TRACE_MAGIC[4] = { 'G', 'I', '2', 'T' };
+const uint8_t I2C_TRACE_VERSION = 1;
+const uint8_t I2C_TRACE_KEPT = 3;
+
+class I2cTraceFormat {
+public:
+  static uint8_t putVarint(uint8_t* out, uint32_t v) {
+    uint8_t n = 0;
+    while (v >= 0x80) {
+      out[n++] = (uint8_t)(v | 0x80);
+      v >>= 7;
+    }
+    out[n++] = (uint8_t)v;
+    return n;
+  }
+
+  // One transaction into out (room for 18 + kept bytes); returns its length
+  static uint16_t putRecord(uint8_t* out, uint32_t deltaUs, uint32_t busUs, uint8_t addr, bool read, uint8_t status,
+                            uint32_t len, const uint8_t* data, uint8_t kept) {
+    uint16_t n = putVarint(out, deltaUs);
+    n += putVarint(out + n, busUs);
+    out[n++] = (addr & 0x7F) | (read ? 0x80 : 0);
+    out[n++] = status;
+    n += putVarint(out + n, len);
+    out[n++] = kept;
+    for (uint8_t i = 0; i < kept; i++) out[n++] = data[i];
+    return n;
+  }
+};
+
+// I2C bus trace (I2C_TRACE_ENABLED in constants.h). HDSPDisplay and the
+// RTC reads record into a ring; report() prints a summary line and the
+// ring as a binary trace in base64 lines, so two firmware versions can be
+// compared on the same scenario (i2ctrace fromlog / delta on the host):
+//   I2CTRACE,<label>,<transactions>,<bytes>,<bus us>,<dropped>
+//   I2CB,<base64 of the .i2ct>   (repeated, 76 characters each)
+// With the flag off every record call is a constant-false branch.
+class I2cTrace {
+private:
+  I2cTraceRecord records[I2C_TRACE_CAPACITY];
+  uint16_t count;
+  uint32_t dropped;      // records that didn't fit before the last report
+  uint32_t totalBytes;
+  uint32_t totalBusUs;
+  unsigned long lastReport;
+
+  // Binary output, base64-encoded a line (57 bytes) at a time
+  uint8_t line[57];
+  uint8_t lineLen;
+
+  void add(uint8_t addr, const uint8_t* data, uint8_t len, uint8_t flags, uint32_t startUs) {
+    uint32_t busUs = micros() - startUs;
+    totalBytes += len;
+    totalBusUs += busUs;
+    if (count >= I2C_TRACE_CAPACITY) {
+      dropped++;
+      return;
+    }
+    I2cTraceRecord& r = records[count++];
+    r.startUs = startUs;
+    r.busUs = busUs > 0xFFFF ? 0xFFFF : busUs;
+    r.addr = addr;
+    r.len = len;
+    r.flags = flags;
+    for (byte i = 0; i < 3; i++) r.data[i] = (data && i < len) ? data[i] : 0;
+  }
+
+  void flushLine() {
+    static const char ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    if (lineLen == 0) return;
+    char text[77];
+    byte t = 0;
+    for (byte i = 0; i < lineLen; i += 3) {
+      uint32_t v = (uint32_t)line[i] << 16;
+      if (i + 1 < lineLen) v |= (uint32_t)line[i + 1] << 8;
+      if (i + 2 < lineLen) v |= line[i + 2];
+      text[t++] = ALPHABET[(v >> 18) & 0x3F];
+      text[t++] = ALPHABET[(v >> 12) & 0x3F];
+      text[t++] = i + 1 < lineLen ? ALPHABET[(v >> 6) & 0x3F] : '=';
+      text[t++] = i + 2 < lineLen ? ALPHABET[v & 0x3F] : '=';
+    }
+    text[t] = 0;
+    Serial.printf("I2CB,%s\n", text);
+    lineLen = 0;
+  }
+
+  void emit(const uint8_t* bytes, uint16_t len) {
+    for (uint16_t i = 0; i < len; i++) {
+      line[lineLen++] = bytes[i];
+      if (lineLen == sizeof(line)) flushLine();
+    }
+  }
+
+public:
+  I2cTrace()
+    : count(0), dropped(0), totalBytes(0), totalBusUs(0), lastReport(0), lineLen(0) {}
+
+  // Call right after Wire.endTransmission() - startUs = micros() before beginTransmission()
+  void recordWrite(uint8_t addr, const uint8_t* data, uint8_t len, uint8_t status, uint32_t startUs) {
+    if (!I2C_TRACE_ENABLED) return;
+    add(addr, data, len, status & 0x7F, startUs);
+  }
+
+  // Library call that reads len bytes (register pointer write included)
+  void recordRead(uint8_t addr, uint8_t len, uint32_t startUs) {
+    if (!I2C_TRACE_ENABLED) return;
+    add(addr, nullptr, len, I2C_TRACE_READ, startUs);
+  }
+
+  void report(const char* label) {
+    if (!I2C_TRACE_ENABLED) return;
+    Serial.printf("I2CTRACE,%s,%u,%lu,%lu,%lu\n", label, count, (unsigned long)totalBytes,
+                  (unsigned long)totalBusUs, (unsigned long)dropped);
+    uint8_t header[5] = { I2C_TRACE_MAGIC[0], I2C_TRACE_MAGIC[1], I2C_TRACE_MAGIC[2], I2C_TRACE_MAGIC[3],
+                          I2C_TRACE_VERSION };
+    emit(header, sizeof(header));
+    uint32_t previousUs = 0;
+    for (uint16_t i = 0; i < count; i++) {
+      const I2cTraceRecord& r = records[i];
+      bool read = r.flags & I2C_TRACE_READ;
+      uint8_t kept = read ? 0 : (r.len < I2C_TRACE_KEPT ? r.len : I2C_TRACE_KEPT);
+      uint8_t bytes[18 + I2C_TRACE_KEPT];
+      emit(bytes, I2cTraceFormat::putRecord(bytes, r.startUs - previousUs, r.busUs, r.addr, read, r.flags & 0x7F,
+                                            r.len, r.data, kept));
+      previousUs = r.startUs;
+    }
+    flushLine();
+    count = 0;
+    dropped = 0;
+    totalBytes = 0;
+    totalBusUs = 0;
+    lastReport = millis();
+  }
+
+  // From loop(): report when the ring is full or every I2C_TRACE_REPORT_MS
+  void update() {
+    if (!I2C_TRACE_ENABLED) return;
+    if (count >= I2C_TRACE_CAPACITY || (count > 0 && millis() - lastReport >= I2C_TRACE_REPORT_MS)) report("run");
+  }
+};
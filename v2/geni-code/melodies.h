@@ -0,0 +1,71 @@
+#pragma once
+
+#include "rtttl.h"
+
+// The library tunes are written as RTTTL and turned into a Note table by the
+// compiler (rtttl.h) - no parsing at runtime, only the packed table is in flash.
+// The tunes the clock always shipped with keep their original {Hz, ms} tables:
+// RTTTL would snap them to the tempered scale / a whole-note grid (the ring
+// tune's 1200..1800 Hz steps aren't notes at all) and they'd sound different.
+
+// C5 E5 G5 C6 E6 C6 - rise, peak, resolve
+constexpr Note STARTUP_NOTES[] = {
+  { 523, 90 },   // C5 - quick
+  { 659, 90 },   // E5 - quick
+  { 784, 90 },   // G5 - quick
+  { 1047, 160 }, // C6 - arrival, slight hold
+  { 1319, 240 }, // E6 - peak / shimmer
+  { 1047, 320 }  // C6 - resolve, held longest
+};
+constexpr auto STARTUP_MELODY = rawMelody(STARTUP_NOTES);
+
+// C5, E5, G5, C6 - hourly chime
+constexpr Note NOTIF_NOTES[] = { { 523, 200 }, { 659, 200 }, { 783, 200 }, { 1047, 200 } };
+constexpr auto NOTIF_MELODY = rawMelody(NOTIF_NOTES);
+
+// Timer + Alarm ring (shared - both ring until the user interacts, there's no
+// cycle limit). 100 ms per note, the trailing rest is the gap between repeats.
+constexpr Note RING_NOTES[] = {
+  { 1200, 100 }, { 1400, 100 }, { 1600, 100 }, { 1400, 100 }, { 1600, 100 }, { 1800, 100 }, { 0, 300 }
+};
+constexpr auto TIMER_ALARM_MELODY = rawMelody(RING_NOTES);
+
+// Further tunes for the alarm / chime library (trailing rest = gap when looped as an alarm)
+RTTTL_MELODY(BEEPBEEP_MELODY, "beep:d=8,o=7,b=200:c,p,c,p,c,p,2p");
+RTTTL_MELODY(ROOSTER_MELODY, "rooster:d=8,o=6,b=180:g,c7,e7,4g7,16p,e7,4g7,2p");
+RTTTL_MELODY(WESTMINSTER_MELODY, "westmin:d=4,o=5,b=120:e,g#,f#,2b4,e,f#,g#,2e,1p");
+RTTTL_MELODY(CUCKOO_MELODY, "cuckoo:d=8,o=6,b=140:e,4c,p,e,4c,2p");
+
+struct MelodyEntry {
+  const char* name;  // pontosan 8 karakter (kijelzőre megy)
+  const Note* notes;
+  byte length;
+};
+
+#define MELODY_ENTRY(title, m) \
+  { title, m.notes, m.length }
+
+// Selectable via Settings (alarmTune / chimeTune = index)
+const MelodyEntry MELODY_LIBRARY[] = {
+  MELODY_ENTRY(" RING   ", TIMER_ALARM_MELODY),
+  MELODY_ENTRY(" CHIME  ", NOTIF_MELODY),
+  MELODY_ENTRY("BEEPBEEP", BEEPBEEP_MELODY),
+  MELODY_ENTRY("ROOSTER ", ROOSTER_MELODY),
+  MELODY_ENTRY("WESTMIN ", WESTMINSTER_MELODY),
+  MELODY_ENTRY(" CUCKOO ", CUCKOO_MELODY),
+};
+const byte MELODY_LIBRARY_SIZE = sizeof(MELODY_LIBRARY) / sizeof(MELODY_LIBRARY[0]);
+const byte DEFAULT_ALARM_TUNE = 0;  // RING
+const byte DEFAULT_CHIME_TUNE = 1;  // CHIME
+
+// Flash cost of each tune (the Note table only - the RTTTL text isn't stored)
+void printMelodyLibrary() {
+  size_t total = STARTUP_MELODY.length * sizeof(Note);
+  Serial.printf("MELODY - startup  %2u notes %4u bytes\n", STARTUP_MELODY.length, (unsigned)total);
+  for (byte i = 0; i < MELODY_LIBRARY_SIZE; i++) {
+    size_t bytes = MELODY_LIBRARY[i].length * sizeof(Note);
+    total += bytes;
+    Serial.printf("MELODY %u %s %2u notes %4u bytes\n", i, MELODY_LIBRARY[i].name, MELODY_LIBRARY[i].length, (unsigned)bytes);
+  }
+  Serial.printf("MELODY library total %u bytes\n", (unsigned)total);
+}
@@ -0,0 +1,266 @@
+#pragma once
+
+#include "HDSPDisplay.h"
+#include "audio.h"
+#include "melodies.h"
+#include "constants.h"
+#include "settings.h"
+
+enum PomodoroPhase : byte {
+  POMO_WORK = 0,
+  POMO_BREAK,
+  POMO_LONG_BREAK,
+};
+
+// Pomodoro cycle running in the background. The end of the current phase
+// is an instant on the main clock (local RTC unixtime) - the
+// ClockScheduler fires CLOCK_EVENT_POMODORO when it's crossed and
+// phaseEnded() switches to the next phase, so nothing here is polled.
+// Every longEvery-th break is longFactor times longer.
+//
+// A phase is a duration, not a wall-clock time: clockChanged() shifts the
+// phase end by the jump, so a GPS resync / SetTime neither cuts a phase
+// short nor stretches it.
+class Pomodoro {
+private:
+  // Setting state (mode UI)
+  bool settingPomodoro;
+  byte currentSetting;  // 0=work minutes, 1=break minutes
+  uint8_t workMinutes;
+  uint8_t breakMinutes;
+
+  // Setting display state
+  bool showingSettingTitle;
+  unsigned long settingTitleStartTime;
+
+  // Cycle state
+  bool running;
+  PomodoroPhase phase;
+  uint32_t phaseEndEpoch;  // 0 = not running
+  uint16_t completedWork;  // work phases finished since start()
+  uint32_t nowEpoch;       // last time seen by setNow()
+
+  // Phase change announcement (preempts whatever mode is on screen)
+  bool announcing;
+  unsigned long announceStart;
+
+  HDSPDisplay* display;
+  AudioSequencer* audio;
+  Settings* settings;
+
+  bool exitPomodoroMode;
+
+  uint32_t phaseMinutes(PomodoroPhase p) const {
+    const SettingsData& data = settings->get();
+    switch (p) {
+      case POMO_WORK: return data.pomoWorkMinutes;
+      case POMO_BREAK: return data.pomoBreakMinutes;
+      default: return (uint32_t)data.pomoBreakMinutes * data.pomoLongFactor;
+    }
+  }
+
+  static const char* phaseLetter(PomodoroPhase p) {
+    switch (p) {
+      case POMO_WORK: return "W";
+      case POMO_BREAK: return "B";
+      default: return "L";
+    }
+  }
+
+  // WORK 25m / BREAK 5m / LONG 20m / LONG2h00 (a long break can be up to 90 x factor minutes)
+  void announce() {
+    char buffer[16];
+    unsigned minutes = phaseMinutes(phase);
+    switch (phase) {
+      case POMO_WORK: snprintf(buffer, sizeof(buffer), "WORK %2um", minutes); break;
+      case POMO_BREAK: snprintf(buffer, sizeof(buffer), "BREAK%2um", minutes); break;
+      default:
+        if (minutes >= 60) snprintf(buffer, sizeof(buffer), "LONG%uh%02u", minutes / 60 % 10, minutes % 60);
+        else snprintf(buffer, sizeof(buffer), "LONG %2um", minutes);
+        break;
+    }
+    display->forceDisplayText(buffer);
+    audio->play(SOUND_CHIME, NOTIF_MELODY.notes, NOTIF_MELODY.length);
+    announcing = true;
+    announceStart = millis();
+  }
+
+  void startPhase(PomodoroPhase p, uint32_t startEpoch) {
+    phase = p;
+    phaseEndEpoch = startEpoch + phaseMinutes(p) * 60;
+    Serial.printf("Pomodoro: %s %lu min, ends at %lu\n", phaseLetter(p), (unsigned long)phaseMinutes(p), (unsigned long)phaseEndEpoch);
+  }
+
+public:
+  Pomodoro(HDSPDisplay* hdspDisplay, AudioSequencer* audioSequencer, Settings* settingsStore)
+    : running(false), phase(POMO_WORK), phaseEndEpoch(0), completedWork(0), nowEpoch(0),
+      announcing(false), announceStart(0), display(hdspDisplay), audio(audioSequencer), settings(settingsStore) {
+    reset();
+  }
+
+  // UI only - a running cycle keeps running
+  void reset() {
+    const SettingsData& data = settings->get();
+    settingPomodoro = !running;
+    currentSetting = 0;
+    workMinutes = data.pomoWorkMinutes;
+    breakMinutes = data.pomoBreakMinutes;
+    showingSettingTitle = true;
+    settingTitleStartTime = millis();
+    exitPomodoroMode = false;
+  }
+
+  void forceShowSettingTitle() {
+    showingSettingTitle = true;
+    settingTitleStartTime = millis();
+  }
+
+  // Per-tick time feed (start() needs a valid clock)
+  void setNow(uint32_t currentEpoch) {
+    nowEpoch = currentEpoch;
+  }
+
+  // Next phase end for the ClockScheduler, 0 = not running
+  uint32_t getPhaseEndEpoch() const {
+    return running ? phaseEndEpoch : 0;
+  }
+
+  // ClockScheduler saw getPhaseEndEpoch() crossed. The next phase starts
+  // at the old phase end, not "now", so a late loop() doesn't add drift.
+  void phaseEnded() {
+    if (!running) return;
+    uint32_t start = phaseEndEpoch;
+    if (phase == POMO_WORK) {
+      completedWork++;
+      const SettingsData& data = settings->get();
+      bool longBreak = data.pomoLongEvery > 0 && completedWork % data.pomoLongEvery == 0;
+      startPhase(longBreak ? POMO_LONG_BREAK : POMO_BREAK, start);
+    } else {
+      startPhase(POMO_WORK, start);
+    }
+    if (phaseEndEpoch <= nowEpoch) startPhase(phase, nowEpoch);  // loop() was stalled for longer than a phase
+    announce();
+  }
+
+  // RTC was set / resynced - the current phase keeps its remaining time
+  void clockChanged(int32_t jumpSeconds) {
+    if (running) phaseEndEpoch += jumpSeconds;
+  }
+
+  // Phase change message on screen - the caller holds back its own display meanwhile
+  bool isAnnouncing() const {
+    return announcing;
+  }
+
+  // Returns true once when the announcement is over (caller redraws its mode)
+  bool updateAnnouncement() {
+    if (!announcing || millis() - announceStart < POMODORO_MESSAGE_MS) return false;
+    announcing = false;
+    return true;
+  }
+
+  bool isRunning() const {
+    return running;
+  }
+
+  // Handle pomodoro mode updates (call this in main loop when in pomodoro mode)
+  void update() {
+    if (showingSettingTitle && (millis() - settingTitleStartTime >= POMODORO_SETTING_TITLE_DURATION)) {
+      showingSettingTitle = false;
+    }
+
+    char buffer[16];
+    if (settingPomodoro) {
+      if (showingSettingTitle) {
+        strcpy(buffer, currentSetting == 0 ? "SET WORK" : "SET BRK ");
+      } else if (currentSetting == 0) {
+        sprintf(buffer, "WORK %2um", workMinutes);
+      } else {
+        sprintf(buffer, "BRK  %2um", breakMinutes);
+      }
+    } else {
+      // W1 24:59 - phase letter, work session within the set, time left;
+      // L1 1h59m from an hour up (MM:SS has no room for it)
+      uint32_t left = phaseEndEpoch > nowEpoch ? phaseEndEpoch - nowEpoch : 0;
+      byte every = settings->get().pomoLongEvery;
+      unsigned done = phase == POMO_WORK ? completedWork : completedWork - 1;
+      unsigned session = every > 0 ? done % every + 1 : 1;
+      if (left >= 3600) {
+        sprintf(buffer, "%s%u %uh%02um", phaseLetter(phase), session % 10, (unsigned)(left / 3600 % 10), (unsigned)(left / 60 % 60));
+      } else {
+        sprintf(buffer, "%s%u %02u:%02u", phaseLetter(phase), session % 10, (unsigned)(left / 60), (unsigned)(left % 60));
+      }
+    }
+    display->displayText(buffer);
+  }
+
+  // CONFIRM - next setting / start
+  void handleConfirmButton() {
+    if (!settingPomodoro || showingSettingTitle) return;
+    if (currentSetting == 0) {
+      currentSetting = 1;
+      forceShowSettingTitle();
+      return;
+    }
+    if (nowEpoch == 0) {
+      // No valid clock yet - the phase ends couldn't be scheduled
+      display->forceDisplayText(" NO T&D ");
+      announcing = true;
+      announceStart = millis();
+      return;
+    }
+    settings->setPomodoro(workMinutes, breakMinutes);
+    running = true;
+    completedWork = 0;
+    settingPomodoro = false;
+    startPhase(POMO_WORK, nowEpoch);
+    announce();
+  }
+
+  void handleAddButton() {
+    if (!settingPomodoro || showingSettingTitle) return;
+    if (currentSetting == 0) {
+      workMinutes = workMinutes + POMODORO_STEP_MINUTES > POMODORO_MAX_MINUTES ? POMODORO_STEP_MINUTES : workMinutes + POMODORO_STEP_MINUTES;
+    } else {
+      breakMinutes = breakMinutes + POMODORO_STEP_MINUTES > POMODORO_MAX_MINUTES ? POMODORO_STEP_MINUTES : breakMinutes + POMODORO_STEP_MINUTES;
+    }
+  }
+
+  void handleSubtractButton() {
+    if (!settingPomodoro || showingSettingTitle) return;
+    if (currentSetting == 0) {
+      workMinutes = workMinutes <= POMODORO_STEP_MINUTES ? POMODORO_MAX_MINUTES : workMinutes - POMODORO_STEP_MINUTES;
+    } else {
+      breakMinutes = breakMinutes <= POMODORO_STEP_MINUTES ? POMODORO_MAX_MINUTES : breakMinutes - POMODORO_STEP_MINUTES;
+    }
+  }
+
+  // Single CANCEL - stop the cycle / back to the work minutes
+  void handleCancelButton() {
+    if (running) {
+      running = false;
+      phaseEndEpoch = 0;
+      Serial.println("Pomodoro: stopped");
+      reset();
+      return;
+    }
+    if (showingSettingTitle) return;
+    if (currentSetting == 1) {
+      currentSetting = 0;
+      forceShowSettingTitle();
+    }
+  }
+
+  // Double CANCEL - exit pomodoro mode (a running cycle keeps running)
+  void handleCancelDoublePress() {
+    exitPomodoroMode = true;
+  }
+
+  bool shouldExitPomodoroMode() const {
+    return exitPomodoroMode;
+  }
+
+  void clearExitFlag() {
+    exitPomodoroMode = false;
+  }
+};
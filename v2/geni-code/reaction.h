@@ -0,0 +1,208 @@
+#pragma once
+
+#include "HDSPDisplay.h"
+#include "constants.h"
+#include "settings.h"
+
+enum ReactionState : byte {
+  REACT_IDLE = 0,  // PUSH BTN / browsing the best times
+  REACT_WAITING,   // WAIT shown, random delay running
+  REACT_GO,        // GO written, waiting for it to reach the panel / the press
+  REACT_RESULT,    // reaction time (or TOO SOON / TOO SLOW) shown
+};
+
+// Reaction-time tester. The random delay only starts once the WAIT frame
+// is confirmed on the panel, and the time is measured from the moment the
+// GO frame's last character was latched (HDSPDisplay flush end) to the JS
+// button edge timestamped in the GPIO ISR (ButtonEvent::edgeUs) - neither
+// the I2C write time nor the loop() latency ends up in the result.
+// The best REACTION_BEST_COUNT results are kept in the settings blob.
+class Reaction {
+private:
+  ReactionState state;
+  unsigned long stateStart;    // millis() of the last state change
+  uint32_t delayMs;            // random WAIT -> GO delay
+  bool waitConfirmed;          // WAIT frame is on the panel, delay running
+  uint32_t goRequestUs;        // GO handed to the display
+  uint32_t goVisibleUs;        // GO frame latched, 0 = not yet
+  uint16_t lastResultMs;       // 0 = TOO SOON / TOO SLOW
+  byte lastRank;               // 1.. = place in the best list, 0 = not in it
+  const char* message;         // TOO SOON / TOO SLOW
+  byte browseIndex;            // idle: 0 = PUSH BTN, n = n-th best
+
+  HDSPDisplay* display;
+  Settings* settings;
+
+  bool exitReactionMode;
+
+  // The frame is on the panel (no pending reset, text latched)
+  bool frameShown(const char* frame) const {
+    return !display->isResetting() && strncmp(display->getDisplayedText(), frame, 8) == 0;
+  }
+
+  void enter(ReactionState next) {
+    state = next;
+    stateStart = millis();
+  }
+
+  // Insert into the sorted best list; returns the place (1..), 0 = not good enough
+  byte recordBest(uint16_t ms) {
+    uint16_t best[REACTION_BEST_COUNT];
+    memcpy(best, settings->get().reactionBestMs, sizeof(best));
+    byte pos = 0;
+    while (pos < REACTION_BEST_COUNT && best[pos] != 0 && best[pos] <= ms) pos++;
+    if (pos >= REACTION_BEST_COUNT) return 0;
+    for (byte i = REACTION_BEST_COUNT - 1; i > pos; i--) best[i] = best[i - 1];
+    best[pos] = ms;
+    settings->setReactionBest(best);
+    return pos + 1;
+  }
+
+  void finish(uint16_t resultMs, const char* text) {
+    lastResultMs = resultMs;
+    message = text;
+    lastRank = resultMs ? recordBest(resultMs) : 0;
+    enter(REACT_RESULT);
+  }
+
+public:
+  Reaction(HDSPDisplay* hdspDisplay, Settings* settingsStore)
+    : display(hdspDisplay), settings(settingsStore) {
+    reset();
+  }
+
+  void reset() {
+    enter(REACT_IDLE);
+    waitConfirmed = false;
+    goVisibleUs = 0;
+    lastResultMs = 0;
+    lastRank = 0;
+    message = nullptr;
+    browseIndex = 0;
+    exitReactionMode = false;
+  }
+
+  // Call from loop() while the mode is on screen
+  void update() {
+    char buffer[16];
+    switch (state) {
+      case REACT_IDLE: {
+        if (browseIndex == 0) {
+          display->displayText("PUSH BTN");
+          return;
+        }
+        uint16_t ms = settings->get().reactionBestMs[browseIndex - 1];
+        if (ms == 0) snprintf(buffer, sizeof(buffer), "#%u  --- ", browseIndex);
+        else snprintf(buffer, sizeof(buffer), "#%u%4ums", browseIndex, ms);
+        display->displayText(buffer);
+        return;
+      }
+
+      case REACT_WAITING:
+        display->displayText(REACTION_WAIT_TEXT);
+        if (!waitConfirmed) {
+          // Random delay counts from the confirmed flush, not from the button press
+          if (frameShown(REACTION_WAIT_TEXT)) {
+            waitConfirmed = true;
+            stateStart = millis();
+          }
+          return;
+        }
+        if (millis() - stateStart >= delayMs) {
+          goRequestUs = micros();
+          goVisibleUs = 0;
+          enter(REACT_GO);
+          display->displayText(REACTION_GO_TEXT);
+          if (frameShown(REACTION_GO_TEXT)) goVisibleUs = display->getLastFlushEndUs();
+        }
+        return;
+
+      case REACT_GO:
+        if (goVisibleUs == 0) {
+          // Still behind a display reset - the queued frame is flushed by HDSP.update()
+          display->displayText(REACTION_GO_TEXT);
+          if (frameShown(REACTION_GO_TEXT)) goVisibleUs = display->getLastFlushEndUs();
+        }
+        if (millis() - stateStart >= REACTION_TIMEOUT_MS) finish(0, "TOO SLOW");
+        return;
+
+      case REACT_RESULT:
+        if (message) {
+          display->displayText((char*)message);
+        } else if (lastRank > 0 && (millis() - stateStart) / REACTION_RESULT_TOGGLE_MS % 2) {
+          snprintf(buffer, sizeof(buffer), "BEST #%u ", lastRank);
+          display->displayText(buffer);
+        } else {
+          snprintf(buffer, sizeof(buffer), "%4u ms ", lastResultMs);
+          display->displayText(buffer);
+        }
+        return;
+    }
+  }
+
+  // JS button press - edgeUs is the ISR timestamp of the press edge
+  void handlePress(uint32_t edgeUs) {
+    switch (state) {
+      case REACT_IDLE:
+      case REACT_RESULT:
+        // Start a round
+        delayMs = random(REACTION_MIN_DELAY_MS, REACTION_MAX_DELAY_MS + 1);
+        waitConfirmed = false;
+        message = nullptr;
+        browseIndex = 0;
+        enter(REACT_WAITING);
+        break;
+
+      case REACT_WAITING:
+        finish(0, "TOO SOON");
+        break;
+
+      case REACT_GO: {
+        // Pressed before the GO frame was latched = anticipated, not a reaction
+        if (goVisibleUs == 0 || (int32_t)(edgeUs - goVisibleUs) < 0) {
+          finish(0, "TOO SOON");
+          break;
+        }
+        uint32_t reactionUs = edgeUs - goVisibleUs;
+        uint32_t flushUs = goVisibleUs - goRequestUs;
+        Serial.printf("Reaction: %lu us (GO flush %lu us, uncorrected %lu us)\n",
+                      (unsigned long)reactionUs, (unsigned long)flushUs, (unsigned long)(edgeUs - goRequestUs));
+        uint32_t ms = (reactionUs + 500) / 1000;
+        finish(ms > 9999 ? 9999 : (ms == 0 ? 1 : ms), nullptr);
+        break;
+      }
+    }
+  }
+
+  // ADD / SUBTRACT while idle - step through the best list
+  void handleNextBest() {
+    if (state != REACT_IDLE) return;
+    browseIndex = (browseIndex + 1) % (REACTION_BEST_COUNT + 1);
+  }
+
+  void handlePreviousBest() {
+    if (state != REACT_IDLE) return;
+    browseIndex = browseIndex == 0 ? REACTION_BEST_COUNT : browseIndex - 1;
+  }
+
+  // Single CANCEL - abandon the round / back to PUSH BTN
+  void handleCancelButton() {
+    enter(REACT_IDLE);
+    message = nullptr;
+    browseIndex = 0;
+  }
+
+  // Double CANCEL - exit the mode
+  void handleCancelDoublePress() {
+    enter(REACT_IDLE);
+    exitReactionMode = true;
+  }
+
+  bool shouldExitReactionMode() const {
+    return exitReactionMode;
+  }
+
+  void clearExitFlag() {
+    exitReactionMode = false;
+  }
+};
@@ -0,0 +1,388 @@
+#pragma once
+
+#include "HDSPDisplay.h"
+#include "audio.h"
+#include "melodies.h"
+#include "constants.h"
+#include "settings.h"
+
+// Interval reminders. Each enabled slot has an absolute next-fire instant
+// (local RTC unixtime) on a fixed grid: switched on at T, it's due at
+// T + n * interval. The earliest one is a ClockScheduler target, so
+// nothing is compared per loop; fireDue() handles every slot that's due.
+//
+// Catch-up (loop() stall, sleep, forward clock jump within
+// REMINDER_CATCHUP_S): a slot that missed one or more instants fires ONCE,
+// in due-time order (slot index on a tie), and continues on its grid with
+// the first instant after now. Further jumps re-grid silently; a backward
+// jump keeps the remaining time.
+//
+// A fired reminder scrolls its label across the panel once; several due at
+// the same time are queued.
+class Reminders {
+private:
+  // Setting state (mode UI)
+  bool settingReminder;
+  byte currentSetting;  // 0=slot, 1=interval, 2=label, 3=enable/disable
+  byte editSlot;
+  byte cursor;          // label position being edited
+
+  // RAM copy of the Settings slots + schedule
+  ReminderSlot slots[REMINDER_SLOT_COUNT];
+  uint32_t nextFire[REMINDER_SLOT_COUNT];  // 0 = not armed
+  uint32_t nextFireEpoch;                  // earliest of nextFire[], 0 = none
+  uint32_t nowEpoch;
+
+  // Scroll queue (slot indices) and the scroll in progress
+  byte queue[REMINDER_SLOT_COUNT];
+  byte queueHead;
+  byte queueCount;
+  bool scrolling;
+  byte scrollSlot;
+  byte scrollStep;
+  unsigned long scrollStepStart;
+
+  // Setting display state
+  bool showingSettingTitle;
+  unsigned long settingTitleStartTime;
+
+  HDSPDisplay* display;
+  AudioSequencer* audio;
+  Settings* settings;
+
+  bool exitReminderMode;
+
+  uint32_t intervalSeconds(byte i) const {
+    return (uint32_t)slots[i].intervalMinutes * 60;
+  }
+
+  void arm(byte i, uint32_t from) {
+    nextFire[i] = (slots[i].enabled && from != 0) ? from + intervalSeconds(i) : 0;
+  }
+
+  void updateNextFire() {
+    nextFireEpoch = 0;
+    for (byte i = 0; i < REMINDER_SLOT_COUNT; i++) {
+      if (nextFire[i] != 0 && (nextFireEpoch == 0 || nextFire[i] < nextFireEpoch)) nextFireEpoch = nextFire[i];
+    }
+  }
+
+  // First grid instant after 'now'; returns how many instants were passed
+  uint32_t regrid(byte i, uint32_t now) {
+    uint32_t passed = (now - nextFire[i]) / intervalSeconds(i) + 1;
+    nextFire[i] += passed * intervalSeconds(i);
+    return passed;
+  }
+
+  void enqueue(byte i) {
+    if (queueCount >= REMINDER_SLOT_COUNT) return;
+    queue[(queueHead + queueCount) % REMINDER_SLOT_COUNT] = i;
+    queueCount++;
+  }
+
+  void startNextScroll() {
+    if (queueCount == 0) return;
+    scrollSlot = queue[queueHead];
+    queueHead = (queueHead + 1) % REMINDER_SLOT_COUNT;
+    queueCount--;
+    scrolling = true;
+    scrollStep = 0;
+    scrollStepStart = millis();
+    audio->play(SOUND_CHIME, BEEPBEEP_MELODY.notes, BEEPBEEP_MELODY.length);
+    showScrollFrame();
+  }
+
+  // Label enters from the right and leaves on the left: 8 + 8 steps
+  void showScrollFrame() {
+    char frame[9];
+    for (byte p = 0; p < 8; p++) {
+      int src = scrollStep + p - 8;
+      frame[p] = (src >= 0 && src < 8) ? slots[scrollSlot].label[src] : ' ';
+    }
+    frame[8] = '\0';
+    // One clean reset when the label starts, then only the changed characters -
+    // a reset per step would blank the panel ~30 ms on every frame
+    if (scrollStep == 0) display->forceDisplayText(frame);
+    else display->displayText(frame);
+  }
+
+public:
+  Reminders(HDSPDisplay* hdspDisplay, AudioSequencer* audioSequencer, Settings* settingsStore)
+    : editSlot(0), nextFireEpoch(0), nowEpoch(0), queueHead(0), queueCount(0), scrolling(false), scrollSlot(0), scrollStep(0),
+      scrollStepStart(0), display(hdspDisplay), audio(audioSequencer), settings(settingsStore) {
+    memset(slots, 0, sizeof(slots));
+    memset(nextFire, 0, sizeof(nextFire));
+    reset();
+  }
+
+  void reset() {
+    settingReminder = true;
+    currentSetting = 0;
+    editSlot = 0;
+    cursor = 0;
+    showingSettingTitle = true;
+    settingTitleStartTime = millis();
+    exitReminderMode = false;
+  }
+
+  // Load the slots from the settings cache (call from setup(), after settings.begin()).
+  // Enabled slots are armed from the first valid time seen by setNow().
+  void loadReminderSettings() {
+    const SettingsData& data = settings->get();
+    for (byte i = 0; i < REMINDER_SLOT_COUNT; i++) {
+      slots[i] = data.reminders[i];
+      if (slots[i].intervalMinutes == 0 || slots[i].intervalMinutes > REMINDER_MAX_MINUTES) slots[i].intervalMinutes = REMINDER_DEFAULT_MINUTES;
+      if (!slots[i].enabled) nextFire[i] = 0;
+    }
+    updateNextFire();
+  }
+
+  void forceShowSettingTitle() {
+    showingSettingTitle = true;
+    settingTitleStartTime = millis();
+  }
+
+  // Per-tick time feed - arms enabled slots once the clock is valid
+  void setNow(uint32_t currentEpoch) {
+    nowEpoch = currentEpoch;
+    if (nowEpoch == 0) return;
+    bool changed = false;
+    for (byte i = 0; i < REMINDER_SLOT_COUNT; i++) {
+      if (slots[i].enabled && nextFire[i] == 0) {
+        arm(i, nowEpoch);
+        changed = true;
+      }
+    }
+    if (changed) updateNextFire();
+  }
+
+  // Earliest next-fire instant for the ClockScheduler, 0 = none
+  uint32_t getNextFireEpoch() const {
+    return nextFireEpoch;
+  }
+
+  // ClockScheduler saw getNextFireEpoch() crossed - every due slot fires once
+  void fireDue(uint32_t now) {
+    // Due slots in (due time, index) order - at most 8, insertion sort
+    byte due[REMINDER_SLOT_COUNT];
+    uint32_t dueAt[REMINDER_SLOT_COUNT];
+    byte count = 0;
+    for (byte i = 0; i < REMINDER_SLOT_COUNT; i++) {
+      if (nextFire[i] == 0 || nextFire[i] > now) continue;
+      byte pos = count++;
+      while (pos > 0 && dueAt[pos - 1] > nextFire[i]) {
+        due[pos] = due[pos - 1];
+        dueAt[pos] = dueAt[pos - 1];
+        pos--;
+      }
+      due[pos] = i;
+      dueAt[pos] = nextFire[i];
+    }
+
+    for (byte k = 0; k < count; k++) {
+      byte i = due[k];
+      uint32_t passed = regrid(i, now);
+      if (passed > 1) Serial.printf("Reminder %u: %lu missed, fired once\n", i + 1, (unsigned long)(passed - 1));
+      enqueue(i);
+    }
+    updateNextFire();
+    if (!scrolling) startNextScroll();
+  }
+
+  // RTC was set / resynced. Anything still overdue was beyond the catch-up
+  // window - re-grid without firing; a backward jump keeps the remaining time.
+  void clockChanged(uint32_t currentEpoch, int32_t jumpSeconds) {
+    nowEpoch = currentEpoch;
+    for (byte i = 0; i < REMINDER_SLOT_COUNT; i++) {
+      if (nextFire[i] == 0) continue;
+      if (jumpSeconds < 0) {
+        nextFire[i] += jumpSeconds;
+      } else if (nextFire[i] <= nowEpoch) {
+        regrid(i, nowEpoch);
+      }
+    }
+    updateNextFire();
+  }
+
+  // Label scroll on screen - the caller holds back its own display meanwhile
+  bool isScrolling() const {
+    return scrolling;
+  }
+
+  // Scroll animation - call every loop(). Returns true once the last queued
+  // label has left the panel (caller redraws its mode).
+  bool updateScroll() {
+    if (!scrolling || millis() - scrollStepStart < REMINDER_SCROLL_STEP_MS) return false;
+    scrollStepStart = millis();
+    if (++scrollStep <= 16) {
+      showScrollFrame();
+      return false;
+    }
+    scrolling = false;
+    startNextScroll();
+    return !scrolling;
+  }
+
+  // Handle reminder mode updates (call this in main loop when in reminder mode)
+  void update() {
+    if (showingSettingTitle && (millis() - settingTitleStartTime >= REMINDER_SETTING_TITLE_DURATION)) {
+      showingSettingTitle = false;
+    }
+    updateDisplay();
+  }
+
+  void handleConfirmButton() {
+    if (!settingReminder || showingSettingTitle) return;
+
+    if (currentSetting == 2 && cursor < 7) {
+      cursor++;  // next label character
+      return;
+    }
+
+    currentSetting++;
+    if (currentSetting >= 4) {
+      saveReminderSlot(editSlot);
+      settingReminder = false;
+      exitReminderMode = true;
+    } else {
+      cursor = 0;
+      forceShowSettingTitle();
+    }
+  }
+
+  void handleAddButton() {
+    if (!settingReminder || showingSettingTitle) return;
+    ReminderSlot& slot = slots[editSlot];
+    switch (currentSetting) {
+      case 0:  // Slot
+        editSlot = (editSlot + 1) % REMINDER_SLOT_COUNT;
+        break;
+      case 1:  // Interval - 1 min steps up to an hour, then 5, then 30
+        slot.intervalMinutes += slot.intervalMinutes < 60 ? 1 : (slot.intervalMinutes < 240 ? 5 : 30);
+        if (slot.intervalMinutes > REMINDER_MAX_MINUTES) slot.intervalMinutes = 1;
+        break;
+      case 2:  // Label character at the cursor
+        slot.label[cursor] = nextLabelChar(slot.label[cursor], 1);
+        break;
+      case 3:  // Enable
+        slot.enabled = 1;
+        break;
+    }
+  }
+
+  void handleSubtractButton() {
+    if (!settingReminder || showingSettingTitle) return;
+    ReminderSlot& slot = slots[editSlot];
+    switch (currentSetting) {
+      case 0:  // Slot
+        editSlot = (editSlot == 0) ? REMINDER_SLOT_COUNT - 1 : editSlot - 1;
+        break;
+      case 1:  // Interval
+        if (slot.intervalMinutes <= 1) {
+          slot.intervalMinutes = REMINDER_MAX_MINUTES;
+        } else {
+          slot.intervalMinutes -= slot.intervalMinutes <= 60 ? 1 : (slot.intervalMinutes <= 240 ? 5 : 30);
+        }
+        break;
+      case 2:  // Label character at the cursor
+        slot.label[cursor] = nextLabelChar(slot.label[cursor], -1);
+        break;
+      case 3:  // Disable
+        slot.enabled = 0;
+        break;
+    }
+  }
+
+  // Single CANCEL - reset the current field
+  void handleCancelButton() {
+    if (!settingReminder || showingSettingTitle) return;
+    ReminderSlot& slot = slots[editSlot];
+    switch (currentSetting) {
+      case 0:  // Slot
+        editSlot = 0;
+        break;
+      case 1:  // Interval
+        slot.intervalMinutes = REMINDER_DEFAULT_MINUTES;
+        break;
+      case 2:  // Label character at the cursor
+        slot.label[cursor] = ' ';
+        break;
+      case 3:  // Enable/disable - toggle
+        slot.enabled = !slot.enabled;
+        break;
+    }
+  }
+
+  // Double CANCEL - exit reminder mode, unconfirmed edits are dropped
+  void handleCancelDoublePress() {
+    const SettingsData& data = settings->get();
+    for (byte i = 0; i < REMINDER_SLOT_COUNT; i++) slots[i] = data.reminders[i];
+    exitReminderMode = true;
+  }
+
+  bool shouldExitReminderMode() const {
+    return exitReminderMode;
+  }
+
+  void clearExitFlag() {
+    exitReminderMode = false;
+  }
+
+private:
+  static char nextLabelChar(char c, int dir) {
+    const int count = sizeof(REMINDER_LABEL_CHARS) - 1;
+    const char* at = strchr(REMINDER_LABEL_CHARS, c);
+    int index = (at && c) ? at - REMINDER_LABEL_CHARS : 0;
+    return REMINDER_LABEL_CHARS[(index + dir + count) % count];
+  }
+
+  // Save one slot - RAM only, the settings cache commits to NVS later. A
+  // saved slot starts its grid from now (like switching it on).
+  void saveReminderSlot(byte index) {
+    settings->setReminderSlot(index, slots[index]);
+    arm(index, nowEpoch);
+    updateNextFire();
+  }
+
+  const char* getCurrentSettingTitle() const {
+    switch (currentSetting) {
+      case 0: return "SEL RMND";
+      case 1: return "SET MINS";
+      case 2: return "SET NAME";
+      case 3: return "SET RMND";
+      default: return "";
+    }
+  }
+
+  void updateDisplay() {
+    const ReminderSlot& slot = slots[editSlot];
+    char buffer[16];
+
+    if (showingSettingTitle) {
+      display->displayText((char*)getCurrentSettingTitle());
+      return;
+    }
+
+    switch (currentSetting) {
+      case 0:  // Slot overview - R1  60m / R1  OFF
+        if (slot.enabled) {
+          snprintf(buffer, sizeof(buffer), "R%u %4um", editSlot + 1, slot.intervalMinutes);
+        } else {
+          snprintf(buffer, sizeof(buffer), "R%u  OFF ", editSlot + 1);
+        }
+        break;
+      case 1:  // Interval
+        snprintf(buffer, sizeof(buffer), "%4u MIN", slot.intervalMinutes);
+        break;
+      case 2:  // Label, the character under the cursor blinks
+        memcpy(buffer, slot.label, 8);
+        buffer[8] = '\0';
+        if ((millis() / REMINDER_CURSOR_BLINK_MS) % 2) buffer[cursor] = '_';
+        break;
+      default:  // RMND ON / RMND OFF
+        strcpy(buffer, slot.enabled ? "RMND ON " : "RMND OFF");
+        break;
+    }
+    display->displayText(buffer);
+  }
+};
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <RTClib.h>
+#include "constants.h"
+
+// DS3231 INT/SQW (open drain, active low) - set by the ISR, consumed by poll()
+volatile bool rtcIntPending = false;
+volatile uint32_t rtcIntCount = 0;
+
+void IRAM_ATTR onRtcInt() {
+  rtcIntPending = true;
+  rtcIntCount++;
+}
+
+// Mirrors the software schedule into the DS3231: Alarm 1 = next alarm
+// instant (date + HH:MM:SS match), Alarm 2 = every full hour (minute 00
+// match, chime + INT wiring check). The INT line then tells us the instant
+// it happens, and loop() re-reads the RTC right away instead of up to
+// RTC_READ_INTERVAL later; the ClockScheduler still does the firing, so
+// the behaviour is the same with or without the INT line.
+//
+// Software fallback: RTC_INT_PIN < 0, or the hourly Alarm 2 passed
+// RTC_INT_MAX_MISSES times without an INT edge (line not wired) - the
+// DS3231 alarms are then switched off and only the 1 s polling remains.
+class RtcAlarmLink {
+private:
+  RTC_DS3231* rtc;
+  int8_t intPin;
+  bool hardware;
+  uint32_t alarm1Epoch;   // what's programmed into Alarm 1 (0 = disabled)
+  bool intSeen;           // at least one edge since the last hourly check
+  bool hourCheckPending;
+  unsigned long hourCheckStart;
+  byte misses;
+
+  void fallBack(const char* reason) {
+    Serial.printf("RTC INT: %s - software timing only\n", reason);
+    if (intPin >= 0) detachInterrupt(digitalPinToInterrupt(intPin));
+    rtc->disableAlarm(1);
+    rtc->disableAlarm(2);
+    rtc->clearAlarm(1);
+    rtc->clearAlarm(2);
+    hardware = false;
+  }
+
+public:
+  RtcAlarmLink()
+    : rtc(nullptr), intPin(-1), hardware(false), alarm1Epoch(0), intSeen(false), hourCheckPending(false), hourCheckStart(0), misses(0) {}
+
+  // Call after rtc.begin() succeeded
+  void begin(RTC_DS3231* ds3231, int8_t pin) {
+    rtc = ds3231;
+    intPin = pin;
+    if (intPin < 0) return;
+
+    // INTCN=1: the pin is the alarm interrupt output, not a square wave
+    rtc->writeSqwPinMode(DS3231_OFF);
+    rtc->disableAlarm(1);
+    rtc->disableAlarm(2);
+    rtc->clearAlarm(1);
+    rtc->clearAlarm(2);
+    alarm1Epoch = 0;
+    rtc->setAlarm2(DateTime(2000, 1, 1, 0, 0, 0), DS3231_A2_Minute);
+
+    pinMode(intPin, INPUT_PULLUP);
+    attachInterrupt(digitalPinToInterrupt(intPin), onRtcInt, FALLING);
+    hardware = true;
+  }
+
+  bool isHardware() const {
+    return hardware;
+  }
+
+  // Reprogram only on change - a few I2C writes per alarm, not per tick
+  void setAlarm1(uint32_t epoch) {
+    if (!hardware || epoch == alarm1Epoch) return;
+    alarm1Epoch = epoch;
+    if (epoch == 0) {
+      rtc->disableAlarm(1);
+    } else {
+      rtc->setAlarm1(DateTime(epoch), DS3231_A1_Date);
+    }
+  }
+
+  // Returns true if the DS3231 signalled - the caller re-reads the time now
+  bool poll() {
+    if (!hardware) return false;
+
+    // Wiring check, a little after the hour so the edge surely got here
+    if (hourCheckPending && millis() - hourCheckStart >= RTC_INT_CHECK_DELAY) {
+      hourCheckPending = false;
+      if (intSeen) {
+        misses = 0;
+      } else if (++misses >= RTC_INT_MAX_MISSES) {
+        fallBack("no edge on the hourly alarm");
+        return false;
+      }
+      intSeen = false;
+    }
+
+    if (!rtcIntPending) return false;
+    rtcIntPending = false;
+    intSeen = true;
+
+    // Clearing the flags releases the INT line for the next match
+    if (rtc->alarmFired(1)) {
+      rtc->clearAlarm(1);
+      alarm1Epoch = 0;  // a DS3231 alarm is one-shot by date, program the next one
+    }
+    if (rtc->alarmFired(2)) rtc->clearAlarm(2);
+    return true;
+  }
+
+  // The full hour passed (ClockScheduler) - Alarm 2 must have pulled INT by now
+  void noteHourPassed() {
+    if (!hardware) return;
+    hourCheckPending = true;
+    hourCheckStart = millis();
+  }
+
+  uint32_t getIntCount() const {
+    return rtcIntCount;
+  }
+};
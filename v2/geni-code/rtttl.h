@@ -0,0 +1,158 @@
+#pragma once
+
+#include "constants.h"
+
+// Compile-time RTTTL ("name:d=4,o=5,b=120:8c6,8.e6,p,...") -> Note table.
+// Everything below is constexpr, so the string never reaches the firmware -
+// only the packed Note array does, and it lands in flash (.rodata).
+
+// Octave 8 frequencies (Hz), lower octaves are halved with rounding
+constexpr uint16_t RTTTL_OCTAVE8_HZ[] = { 4186, 4435, 4699, 4978, 5274, 5588, 5920, 6272, 6645, 7040, 7459, 7902 };
+
+constexpr bool rtttlIsDigit(char c) {
+  return c >= '0' && c <= '9';
+}
+
+constexpr char rtttlLower(char c) {
+  return (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
+}
+
+constexpr size_t rtttlSkipSpaces(const char* s, size_t i) {
+  while (s[i] == ' ') i++;
+  return i;
+}
+
+constexpr size_t rtttlReadNumber(const char* s, size_t i, unsigned& value) {
+  value = 0;
+  while (rtttlIsDigit(s[i])) value = value * 10 + (s[i++] - '0');
+  return i;
+}
+
+// Index right after the n-th ':' (the name / defaults / notes sections)
+constexpr size_t rtttlSection(const char* s, byte n) {
+  size_t i = 0;
+  while (n > 0 && s[i] != '\0') {
+    if (s[i] == ':') n--;
+    i++;
+  }
+  return i;
+}
+
+constexpr size_t rtttlNoteCount(const char* s) {
+  size_t i = rtttlSection(s, 2);
+  size_t count = (s[i] != '\0') ? 1 : 0;
+  for (; s[i] != '\0'; i++) {
+    if (s[i] == ',') count++;
+  }
+  return count;
+}
+
+constexpr uint16_t rtttlFrequency(char note, bool sharp, unsigned octave) {
+  int semitone = 0;
+  switch (note) {
+    case 'c': semitone = 0; break;
+    case 'd': semitone = 2; break;
+    case 'e': semitone = 4; break;
+    case 'f': semitone = 5; break;
+    case 'g': semitone = 7; break;
+    case 'a': semitone = 9; break;
+    case 'b': semitone = 11; break;
+    default: return 0;  // 'p' = pause
+  }
+  if (sharp) semitone++;
+  unsigned hz = RTTTL_OCTAVE8_HZ[semitone % 12];
+  if (semitone == 12) octave++;  // b# = c of the next octave
+  if (octave >= 8) return hz;
+  unsigned shift = 8 - octave;
+  return (hz + (1u << (shift - 1))) >> shift;
+}
+
+// A tune as a fixed-size Note table in flash - from RTTTL text (parseRtttl)
+// or from an explicit table (rawMelody)
+template <size_t N>
+struct NoteMelody {
+  Note notes[N];
+  byte length;
+};
+
+template <size_t N>
+constexpr NoteMelody<N> parseRtttl(const char* s) {
+  NoteMelody<N> melody{};
+  melody.length = N;
+
+  // Defaults section: d=, o=, b=
+  unsigned defDuration = 4, defOctave = 6, bpm = 63;
+  size_t i = rtttlSection(s, 1);
+  while (s[i] != ':' && s[i] != '\0') {
+    i = rtttlSkipSpaces(s, i);
+    char key = rtttlLower(s[i]);
+    if (s[i + 1] == '=') {
+      unsigned value = 0;
+      i = rtttlReadNumber(s, i + 2, value);
+      if (key == 'd') defDuration = value;
+      else if (key == 'o') defOctave = value;
+      else if (key == 'b') bpm = value;
+    }
+    while (s[i] != ',' && s[i] != ':' && s[i] != '\0') i++;
+    if (s[i] == ',') i++;
+  }
+  if (s[i] == ':') i++;
+
+  unsigned wholeNoteMs = 60000u * 4 / bpm;
+
+  for (size_t n = 0; n < N; n++) {
+    i = rtttlSkipSpaces(s, i);
+
+    unsigned duration = 0;
+    i = rtttlReadNumber(s, i, duration);
+    if (duration == 0) duration = defDuration;
+
+    char note = rtttlLower(s[i]);
+    if (s[i] != '\0') i++;
+
+    bool sharp = false;
+    if (s[i] == '#') {
+      sharp = true;
+      i++;
+    }
+
+    bool dotted = false;
+    if (s[i] == '.') {
+      dotted = true;
+      i++;
+    }
+
+    unsigned octave = 0;
+    i = rtttlReadNumber(s, i, octave);
+    if (octave == 0) octave = defOctave;
+
+    if (s[i] == '.') {  // the dot may also follow the octave
+      dotted = true;
+      i++;
+    }
+
+    unsigned ms = wholeNoteMs / duration;
+    if (dotted) ms += ms / 2;
+
+    melody.notes[n].freq = rtttlFrequency(note, sharp, octave);
+    melody.notes[n].durationMs = ms;
+
+    while (s[i] != ',' && s[i] != '\0') i++;
+    if (s[i] == ',') i++;
+  }
+
+  return melody;
+}
+
+// RTTTL_MELODY(NAME, "rtttl") -> constexpr NAME (NoteMelody, in flash)
+#define RTTTL_MELODY(name, str) constexpr auto name = parseRtttl<rtttlNoteCount(str)>(str)
+
+// Same shape from an explicit {freq, ms} table - for tunes whose exact
+// pitches / timings aren't on the equal-tempered RTTTL grid
+template <size_t N>
+constexpr NoteMelody<N> rawMelody(const Note (&notes)[N]) {
+  NoteMelody<N> melody{};
+  melody.length = N;
+  for (size_t n = 0; n < N; n++) melody.notes[n] = notes[n];
+  return melody;
+}
@@ -30,10 +30,6 @@ private:
   bool showingSettingTitle;
   unsigned long settingTitleStartTime;
 
-  unsigned long lastCancelPress;
-  byte cancelPressCount;
-  bool cancelSingleProcessed;
-
   bool exitSetTimeMode;
   bool commitTime;
 
@@ -113,22 +109,11 @@ public:
 
     showingSettingTitle = true;
     settingTitleStartTime = millis();
-    cancelPressCount = 0;
-    lastCancelPress = 0;
-    cancelSingleProcessed = false;
     exitSetTimeMode = false;
     commitTime = false;
   }
 
   void update() {
-    if (cancelPressCount > 0 && (millis() - lastCancelPress > ALARM_CANCEL_DOUBLE_PRESS_WINDOW)) {
-      if (cancelPressCount == 1 && !cancelSingleProcessed) {
-        handleCancelSinglePress();
-        cancelSingleProcessed = true;
-      }
-      cancelPressCount = 0;
-    }
-
     if (showingSettingTitle && (millis() - settingTitleStartTime >= ALARM_SETTING_TITLE_DURATION)) {
       showingSettingTitle = false;
     }
@@ -198,20 +183,15 @@ public:
     }
   }
 
+  // Single CANCEL -> revert the current field
   void handleCancelButton() {
-    unsigned long now = millis();
-
-    // Double press -> abort the whole flow, nothing gets written to the RTC
-    if (now - lastCancelPress <= ALARM_CANCEL_DOUBLE_PRESS_WINDOW && cancelPressCount == 1) {
-      cancelPressCount = 0;
-      commitTime = false;
-      exitSetTimeMode = true;
-      return;
-    }
+    handleCancelSinglePress();
+  }
 
-    cancelPressCount = 1;
-    lastCancelPress = now;
-    cancelSingleProcessed = false;
+  // Double CANCEL -> abort the whole flow, nothing gets written to the RTC
+  void handleCancelDoublePress() {
+    commitTime = false;
+    exitSetTimeMode = true;
   }
 
   bool shouldExitSetTimeMode() const {
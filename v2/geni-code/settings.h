@@ -0,0 +1,309 @@
+#pragma once
+
+#include <Preferences.h>
+#include <esp_rom_crc.h>
+#include "constants.h"
+
+// One alarm slot (alarm.h). days = weekday bitmask (bit 0 = Sunday, as
+// DateTime::dayOfTheWeek()); days == 0 is a one-shot alarm for the date in
+// year/month/day, which disables itself after it rang.
+struct AlarmSlot {
+  uint8_t hour;
+  uint8_t minute;
+  uint8_t days;
+  uint8_t enabled;
+  uint8_t tune;     // MELODY_LIBRARY index
+  uint8_t year;     // one-shot only, years since 2000
+  uint8_t month;
+  uint8_t day;
+};
+static_assert(sizeof(AlarmSlot) == 8, "AlarmSlot must not contain padding");
+
+const uint8_t ALARM_DAYS_DAILY = 0x7F;
+
+// One interval reminder (reminders.h) - fires every intervalMinutes from
+// the moment it was switched on, with its label scrolled across the panel
+struct ReminderSlot {
+  char label[8];  // pontosan 8 karakter, nincs lezáró 0
+  uint16_t intervalMinutes;
+  uint8_t enabled;
+  uint8_t reserved;
+};
+static_assert(sizeof(ReminderSlot) == 12, "ReminderSlot must not contain padding");
+
+// Every persisted parameter, as held in RAM and as stored in the NVS blob.
+// Fixed-width fields, no padding - the struct is written byte for byte.
+// Layout changes: only append fields and bump SETTINGS_VERSION; a shorter
+// (older) record keeps the defaults for the fields it doesn't have.
+struct SettingsData {
+  uint16_t jsCenterX;
+  uint16_t jsCenterY;
+  uint8_t v1AlarmHours;  // v1 single alarm - migrated into alarms[0], unused since v2
+  uint8_t v1AlarmMinutes;
+  uint8_t v1AlarmEnabled;
+  uint8_t v1AlarmTune;
+  uint8_t clockType;
+  uint8_t clockTypeSet;  // 0 on first boot -> display setup screen
+  uint8_t chimeTune;
+  uint8_t reserved;
+  // v2
+  AlarmSlot alarms[ALARM_SLOT_COUNT];
+  // v3 - pomodoro.h
+  uint8_t pomoWorkMinutes;
+  uint8_t pomoBreakMinutes;
+  uint8_t pomoLongEvery;   // every n-th break is a long one (0 = never)
+  uint8_t pomoLongFactor;  // long break = pomoBreakMinutes * this
+  // v4
+  ReminderSlot reminders[REMINDER_SLOT_COUNT];
+  // v5 - reaction.h, ascending, 0 = empty
+  uint16_t reactionBestMs[REACTION_BEST_COUNT];
+};
+static_assert(sizeof(SettingsData) == 12 + ALARM_SLOT_COUNT * sizeof(AlarmSlot) + 4 + REMINDER_SLOT_COUNT * sizeof(ReminderSlot) + REACTION_BEST_COUNT * 2, "SettingsData must not contain padding");
+
+// Blob = header + SettingsData (header.length bytes) + CRC32 of everything before it
+struct SettingsHeader {
+  uint16_t version;
+  uint16_t length;
+};
+
+const char SETTINGS_BLOB_KEY[] = "cfg";
+const uint16_t SETTINGS_VERSION = 5;
+const size_t SETTINGS_BLOB_MAX = 192;  // newer firmware may have appended fields
+static_assert(sizeof(SettingsHeader) + sizeof(SettingsData) + sizeof(uint32_t) <= SETTINGS_BLOB_MAX, "our own blob must fit in SETTINGS_BLOB_MAX");
+
+// Pre-blob layout, one NVS key per value - only read once for migration
+const char* const SETTINGS_LEGACY_KEYS[] = { "alarmHours", "alarmMins", "alarmOn", "alarmTune", "clockType", "chimeTune", "jsCx", "jsCy" };
+const byte SETTINGS_LEGACY_KEY_COUNT = sizeof(SETTINGS_LEGACY_KEYS) / sizeof(SETTINGS_LEGACY_KEYS[0]);
+
+// Write-back cache in front of Preferences. Setters only touch RAM and mark
+// the cache dirty; commit() writes the whole record as one blob if it differs
+// from what's in NVS. Commits happen on mode exit, after SETTINGS_IDLE_COMMIT_MS
+// without changes (update()), or explicitly (before sleep / reboot).
+class Settings {
+private:
+  Preferences* preferences;
+  SettingsData data;
+  SettingsData persisted;  // what NVS currently holds
+  bool dirty;
+  bool blobCurrent;        // NVS holds a valid blob in the current layout
+  bool legacyKeysPresent;  // removed after the first successful blob write
+  unsigned long lastChange;
+  uint32_t nvsWrites;
+
+  void touch() {
+    dirty = true;
+    lastChange = millis();
+  }
+
+  void setDefaults(uint8_t defaultAlarmTune, uint8_t defaultChimeTune) {
+    memset(&data, 0, sizeof(data));
+    data.jsCenterX = JS_DEFAULT_X_CENTER;
+    data.jsCenterY = JS_DEFAULT_Y_CENTER;
+    data.v1AlarmTune = defaultAlarmTune;
+    data.clockType = DEFAULT_CLOCK_TYPE;
+    data.chimeTune = defaultChimeTune;
+    for (byte i = 0; i < ALARM_SLOT_COUNT; i++) {
+      data.alarms[i].days = ALARM_DAYS_DAILY;
+      data.alarms[i].tune = defaultAlarmTune;
+    }
+    data.pomoWorkMinutes = POMODORO_DEFAULT_WORK;
+    data.pomoBreakMinutes = POMODORO_DEFAULT_BREAK;
+    data.pomoLongEvery = POMODORO_DEFAULT_LONG_EVERY;
+    data.pomoLongFactor = POMODORO_DEFAULT_LONG_FACTOR;
+    for (byte i = 0; i < REMINDER_SLOT_COUNT; i++) {
+      memcpy(data.reminders[i].label, REMINDER_DEFAULT_LABEL, sizeof(data.reminders[i].label));
+      data.reminders[i].intervalMinutes = REMINDER_DEFAULT_MINUTES;
+    }
+  }
+
+  // v1 -> v2: the single daily alarm becomes slot 0
+  void migrateV1Alarm() {
+    data.alarms[0].hour = data.v1AlarmHours;
+    data.alarms[0].minute = data.v1AlarmMinutes;
+    data.alarms[0].enabled = data.v1AlarmEnabled;
+    data.alarms[0].tune = data.v1AlarmTune;
+    data.alarms[0].days = ALARM_DAYS_DAILY;
+  }
+
+  // Returns false if there's no usable blob (missing / wrong size / CRC error)
+  bool loadBlob(bool& corrupt) {
+    corrupt = false;
+    size_t blobLen = preferences->getBytesLength(SETTINGS_BLOB_KEY);
+    if (blobLen == 0) return false;
+
+    uint8_t buf[SETTINGS_BLOB_MAX];
+    SettingsHeader header;
+    uint32_t storedCrc;
+    corrupt = true;
+    if (blobLen < sizeof(header) + sizeof(storedCrc) || blobLen > sizeof(buf)) return false;
+    if (preferences->getBytes(SETTINGS_BLOB_KEY, buf, blobLen) != blobLen) return false;
+
+    memcpy(&header, buf, sizeof(header));
+    if (sizeof(header) + header.length + sizeof(storedCrc) != blobLen) return false;
+    memcpy(&storedCrc, buf + blobLen - sizeof(storedCrc), sizeof(storedCrc));
+    if (esp_rom_crc32_le(0, buf, blobLen - sizeof(storedCrc)) != storedCrc) return false;
+    corrupt = false;
+
+    // Forward migration: fields missing from an older record keep their defaults
+    size_t known = header.length < sizeof(data) ? header.length : sizeof(data);
+    memcpy(&data, buf + sizeof(header), known);
+    if (header.version < 2) migrateV1Alarm();
+    if (header.version < SETTINGS_VERSION) {
+      touch();  // rewrite in the current layout
+    } else {
+      blobCurrent = true;
+      persisted = data;  // a setting changed and then changed back needs no write
+    }
+    return true;
+  }
+
+  bool loadLegacyKeys() {
+    legacyKeysPresent = false;
+    for (byte i = 0; i < SETTINGS_LEGACY_KEY_COUNT; i++) {
+      if (preferences->isKey(SETTINGS_LEGACY_KEYS[i])) legacyKeysPresent = true;
+    }
+    if (!legacyKeysPresent) return false;
+
+    data.v1AlarmHours = preferences->getInt("alarmHours", 0);
+    data.v1AlarmMinutes = preferences->getInt("alarmMins", 0);
+    data.v1AlarmEnabled = preferences->getBool("alarmOn", false);
+    data.v1AlarmTune = preferences->getUChar("alarmTune", data.alarms[0].tune);
+    migrateV1Alarm();
+    data.clockTypeSet = preferences->isKey("clockType");
+    data.clockType = preferences->getUChar("clockType", DEFAULT_CLOCK_TYPE);
+    data.chimeTune = preferences->getUChar("chimeTune", data.chimeTune);
+    data.jsCenterX = preferences->getUShort("jsCx", JS_DEFAULT_X_CENTER);
+    data.jsCenterY = preferences->getUShort("jsCy", JS_DEFAULT_Y_CENTER);
+    return true;
+  }
+
+public:
+  Settings()
+    : preferences(nullptr), dirty(false), blobCurrent(false), legacyKeysPresent(false), lastChange(0), nvsWrites(0) {
+    setDefaults(0, 0);
+    persisted = data;
+  }
+
+  // One blob read on a normal boot - call after preferences.begin()
+  void begin(Preferences* prefs, uint8_t defaultAlarmTune, uint8_t defaultChimeTune) {
+    preferences = prefs;
+    unsigned long startUs = micros();
+
+    setDefaults(defaultAlarmTune, defaultChimeTune);
+    persisted = data;
+    dirty = false;
+
+    bool corrupt;
+    const char* source = "blob";
+    if (!loadBlob(corrupt)) {
+      setDefaults(defaultAlarmTune, defaultChimeTune);
+      if (corrupt) {
+        source = "defaults (blob corrupt)";
+      } else if (loadLegacyKeys()) {
+        source = "legacy keys";
+      } else {
+        source = "defaults";
+      }
+      touch();
+    }
+
+    Serial.printf("Settings load: %lu us from %s (v%u)\n", micros() - startUs, source, SETTINGS_VERSION);
+    if (dirty) commit();  // migrated / repaired record goes to NVS right away
+  }
+
+  const SettingsData& get() const {
+    return data;
+  }
+
+  bool hasClockType() const {
+    return data.clockTypeSet;
+  }
+
+  void setAlarmSlot(byte index, const AlarmSlot& slot) {
+    if (index >= ALARM_SLOT_COUNT || memcmp(&slot, &data.alarms[index], sizeof(slot)) == 0) return;
+    data.alarms[index] = slot;
+    touch();
+  }
+
+  void setClockType(uint8_t type) {
+    if (type == data.clockType && data.clockTypeSet) return;
+    data.clockType = type;
+    data.clockTypeSet = 1;
+    touch();
+  }
+
+  void setChimeTune(uint8_t tune) {
+    if (tune == data.chimeTune) return;
+    data.chimeTune = tune;
+    touch();
+  }
+
+  void setReminderSlot(byte index, const ReminderSlot& slot) {
+    if (index >= REMINDER_SLOT_COUNT || memcmp(&slot, &data.reminders[index], sizeof(slot)) == 0) return;
+    data.reminders[index] = slot;
+    touch();
+  }
+
+  void setReactionBest(const uint16_t* best) {
+    if (memcmp(best, data.reactionBestMs, sizeof(data.reactionBestMs)) == 0) return;
+    memcpy(data.reactionBestMs, best, sizeof(data.reactionBestMs));
+    touch();
+  }
+
+  void setPomodoro(uint8_t workMinutes, uint8_t breakMinutes) {
+    if (workMinutes == data.pomoWorkMinutes && breakMinutes == data.pomoBreakMinutes) return;
+    data.pomoWorkMinutes = workMinutes;
+    data.pomoBreakMinutes = breakMinutes;
+    touch();
+  }
+
+  void setJoystickCenter(uint16_t x, uint16_t y) {
+    if (x == data.jsCenterX && y == data.jsCenterY) return;
+    data.jsCenterX = x;
+    data.jsCenterY = y;
+    touch();
+  }
+
+  // Writes the whole record as one blob if it changed; returns the number of NVS writes done
+  byte commit() {
+    if (!dirty || !preferences) return 0;
+    dirty = false;
+    if (blobCurrent && memcmp(&data, &persisted, sizeof(data)) == 0) return 0;  // changed back
+
+    uint8_t buf[sizeof(SettingsHeader) + sizeof(SettingsData) + sizeof(uint32_t)];
+    SettingsHeader header = { SETTINGS_VERSION, sizeof(SettingsData) };
+    memcpy(buf, &header, sizeof(header));
+    memcpy(buf + sizeof(header), &data, sizeof(data));
+    uint32_t crc = esp_rom_crc32_le(0, buf, sizeof(header) + sizeof(data));
+    memcpy(buf + sizeof(header) + sizeof(data), &crc, sizeof(crc));
+
+    if (preferences->putBytes(SETTINGS_BLOB_KEY, buf, sizeof(buf)) != sizeof(buf)) {
+      Serial.println("NVS commit failed");
+      touch();  // retry after the next idle period
+      return 0;
+    }
+    persisted = data;
+    blobCurrent = true;
+    nvsWrites++;
+    Serial.printf("NVS commit: %u bytes (%lu writes total)\n", (unsigned)sizeof(buf), (unsigned long)nvsWrites);
+
+    if (legacyKeysPresent) {
+      for (byte i = 0; i < SETTINGS_LEGACY_KEY_COUNT; i++) preferences->remove(SETTINGS_LEGACY_KEYS[i]);
+      legacyKeysPresent = false;
+    }
+    return 1;
+  }
+
+  // Idle commit - call every loop()
+  void update() {
+    if (dirty && millis() - lastChange >= SETTINGS_IDLE_COMMIT_MS) commit();
+  }
+
+  bool isDirty() const {
+    return dirty;
+  }
+
+  uint32_t getNvsWriteCount() const {
+    return nvsWrites;
+  }
+};
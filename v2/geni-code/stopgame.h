@@ -0,0 +1,148 @@
+#pragma once
+
+#include "HDSPDisplay.h"
+#include "constants.h"
+
+enum StopGameState : byte {
+  STOPGAME_IDLE = 0,  // "10.00 ?" - press to start
+  STOPGAME_RUNNING,   // hundredths counting up
+  STOPGAME_RESULT,    // stopped time <-> error
+};
+
+// "Stop at exactly 10.00 s". Start and stop are the JS button edges
+// timestamped in the GPIO ISR, so the result is exact to the microsecond
+// whatever loop() was doing. While running the panel is refreshed at
+// display rate: HDSPDisplay only writes the characters that changed, so a
+// hundredth is 1 (at most 4) character writes instead of 8.
+//
+// Frame stats per round (Serial): frames shown, hundredths that never made
+// it to the panel (dropped), and the slowest frame write.
+class StopGame {
+private:
+  StopGameState state;
+  uint32_t startUs;       // ISR timestamp of the start press
+  uint32_t stoppedUs;     // elapsed at the stop press
+  unsigned long resultStart;
+
+  // Frame stats of the current round
+  int32_t lastCs;         // hundredth on the panel, -1 = none yet
+  uint32_t frames;
+  uint32_t dropped;
+  uint32_t maxFlushUs;
+
+  HDSPDisplay* display;
+
+  bool exitGameMode;
+
+  void showCs(uint32_t cs) {
+    char buffer[16];
+    snprintf(buffer, sizeof(buffer), "  %02u.%02u ", (unsigned)(cs / 100 % 100), (unsigned)(cs % 100));
+    display->displayText(buffer);
+  }
+
+  void stop(uint32_t elapsedUs) {
+    stoppedUs = elapsedUs;
+    state = STOPGAME_RESULT;
+    resultStart = millis();
+
+    int32_t errorUs = (int32_t)stoppedUs - (int32_t)STOPGAME_TARGET_MS * 1000;
+    uint32_t runMs = stoppedUs / 1000;
+    Serial.printf("StopGame: %lu us (error %+ld us) - %lu frames in %lu ms (%lu fps), %lu dropped, max frame %lu us\n",
+                  (unsigned long)stoppedUs, (long)errorUs, (unsigned long)frames, (unsigned long)runMs,
+                  (unsigned long)(runMs ? frames * 1000 / runMs : 0), (unsigned long)dropped, (unsigned long)maxFlushUs);
+  }
+
+public:
+  StopGame(HDSPDisplay* hdspDisplay)
+    : display(hdspDisplay) {
+    reset();
+  }
+
+  void reset() {
+    state = STOPGAME_IDLE;
+    exitGameMode = false;
+  }
+
+  bool isRunning() const {
+    return state == STOPGAME_RUNNING;
+  }
+
+  // Call from loop() while the mode is on screen - as often as possible
+  void update() {
+    char buffer[16];
+    switch (state) {
+      case STOPGAME_IDLE:
+        display->displayText("10.00 ? ");
+        return;
+
+      case STOPGAME_RUNNING: {
+        uint32_t elapsed = micros() - startUs;
+        if (elapsed >= STOPGAME_MAX_MS * 1000UL) {
+          stop(elapsed);  // nobody pressed - the round ends by itself
+          return;
+        }
+        int32_t cs = elapsed / 10000;
+        if (cs == lastCs) return;
+        if (lastCs >= 0) dropped += cs - lastCs - 1;
+        lastCs = cs;
+        showCs(cs);
+        frames++;
+        if (display->getLastFlushDurationUs() > maxFlushUs) maxFlushUs = display->getLastFlushDurationUs();
+        return;
+      }
+
+      case STOPGAME_RESULT: {
+        // 10.013 s <-> +0.013 s
+        if ((millis() - resultStart) / STOPGAME_RESULT_TOGGLE_MS % 2 == 0) {
+          uint32_t ms = stoppedUs / 1000;
+          snprintf(buffer, sizeof(buffer), "%2u.%03u s", (unsigned)(ms / 1000 % 100), (unsigned)(ms % 1000));
+        } else {
+          int32_t errorMs = (int32_t)(stoppedUs / 1000) - (int32_t)STOPGAME_TARGET_MS;
+          uint32_t absMs = errorMs < 0 ? -errorMs : errorMs;
+          if (absMs > 9999) absMs = 9999;
+          snprintf(buffer, sizeof(buffer), "%c%u.%03u s", errorMs < 0 ? '-' : '+', (unsigned)(absMs / 1000), (unsigned)(absMs % 1000));
+        }
+        display->displayText(buffer);
+        return;
+      }
+    }
+  }
+
+  // JS button press - edgeUs is the ISR timestamp of the press edge
+  void handlePress(uint32_t edgeUs) {
+    switch (state) {
+      case STOPGAME_IDLE:
+      case STOPGAME_RESULT:
+        startUs = edgeUs;
+        lastCs = -1;
+        frames = 0;
+        dropped = 0;
+        maxFlushUs = 0;
+        state = STOPGAME_RUNNING;
+        break;
+
+      case STOPGAME_RUNNING:
+        stop(edgeUs - startUs);
+        break;
+    }
+  }
+
+  // Single CANCEL - abandon the round
+  void handleCancelButton() {
+    state = STOPGAME_IDLE;
+  }
+
+  // Double CANCEL - exit the mode
+  void handleCancelDoublePress() {
+    state = STOPGAME_IDLE;
+    exitGameMode = true;
+  }
+
+  bool shouldExitGameMode() const {
+    return exitGameMode;
+  }
+
+  void clearExitFlag() {
+    exitGameMode = false;
+  }
+};
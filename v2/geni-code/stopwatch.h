@@ -0,0 +1,164 @@
+#pragma once
+
+#include <esp_timer.h>
+#include "HDSPDisplay.h"
+#include "constants.h"
+
+// Stopwatch mode. Time comes from the microsecond clock, so it keeps
+// running (and keeps its laps) while other modes are shown. Laps are lap
+// durations in ms in a fixed ring - the newest STOPWATCH_LAP_COUNT are kept.
+class Stopwatch {
+private:
+  bool running;
+  int64_t startUs;        // esp_timer_get_time() at the last start
+  int64_t accumulatedUs;  // elapsed before the last start
+  int64_t lastLapUs;      // elapsed at the previous lap mark
+
+  uint32_t laps[STOPWATCH_LAP_COUNT];  // lap durations, ms
+  byte lapHead;        // next slot to write
+  uint16_t lapTotal;   // laps taken since reset (lap numbering)
+
+  // Lap browsing: 0 = live view, n = n-th newest lap
+  byte lapView;
+  unsigned long lapLabelStart;
+
+  // Display refresh only when the least significant visible digit changes
+  // (or something else was written to the panel meanwhile)
+  int64_t lastShownUnit;
+  char lastFrame[9];
+
+  HDSPDisplay* display;
+
+  // HH:MM:SS from an hour on, MM:SS.cc below
+  static void format(char* buffer, int64_t us, int64_t& unit) {
+    if (us >= 3600LL * 1000000) {
+      uint32_t secs = us / 1000000;
+      unit = secs;
+      sprintf(buffer, "%02u:%02u:%02u", (unsigned)(secs / 3600 % 100), (unsigned)(secs / 60 % 60), (unsigned)(secs % 60));
+    } else {
+      uint32_t cs = us / 10000;
+      unit = cs;
+      sprintf(buffer, "%02u:%02u.%02u", (unsigned)(cs / 6000), (unsigned)(cs / 100 % 60), (unsigned)(cs % 100));
+    }
+  }
+
+  byte storedLaps() const {
+    return lapTotal < STOPWATCH_LAP_COUNT ? lapTotal : STOPWATCH_LAP_COUNT;
+  }
+
+  // n = 1 is the newest
+  uint32_t lapMs(byte n) const {
+    return laps[(lapHead + STOPWATCH_LAP_COUNT - n) % STOPWATCH_LAP_COUNT];
+  }
+
+  void showLap(byte n) {
+    lapView = n;
+    lapLabelStart = millis();
+    lastShownUnit = -1;
+  }
+
+  void show(char* buffer, int64_t unit) {
+    if (unit == lastShownUnit && strncmp(display->getDisplayedText(), lastFrame, 8) == 0) return;
+    lastShownUnit = unit;
+    display->displayText(buffer);
+    strncpy(lastFrame, display->getDisplayedText(), 8);
+  }
+
+public:
+  Stopwatch(HDSPDisplay* hdspDisplay)
+    : display(hdspDisplay) {
+    reset();
+  }
+
+  // Back to 00:00.00, laps cleared
+  void reset() {
+    running = false;
+    startUs = 0;
+    accumulatedUs = 0;
+    lastLapUs = 0;
+    memset(laps, 0, sizeof(laps));
+    lapHead = 0;
+    lapTotal = 0;
+    lapView = 0;
+    lastShownUnit = -1;
+    lastFrame[8] = '\0';
+  }
+
+  int64_t getElapsedUs() const {
+    return running ? accumulatedUs + (esp_timer_get_time() - startUs) : accumulatedUs;
+  }
+
+  bool isRunning() const {
+    return running;
+  }
+
+  // Call from loop() while the mode is on screen
+  void update() {
+    char buffer[16];
+    int64_t unit;
+
+    if (lapView > 0) {
+      if (millis() - lapLabelStart < STOPWATCH_LAP_LABEL_MS) {
+        sprintf(buffer, "LAP %3u ", (unsigned)(lapTotal - lapView + 1));
+        display->displayText(buffer);
+        return;
+      }
+      format(buffer, (int64_t)lapMs(lapView) * 1000, unit);
+      show(buffer, unit);
+      return;
+    }
+
+    format(buffer, getElapsedUs(), unit);
+    show(buffer, unit);
+  }
+
+  // CONFIRM - start / stop
+  void handleStartStop() {
+    if (running) {
+      accumulatedUs = getElapsedUs();
+      running = false;
+    } else {
+      startUs = esp_timer_get_time();
+      running = true;
+    }
+    lapView = 0;
+    lastShownUnit = -1;
+  }
+
+  // JS button - lap mark while running
+  void handleLap() {
+    if (!running) return;
+    int64_t now = getElapsedUs();
+    laps[lapHead] = (now - lastLapUs) / 1000;
+    lapHead = (lapHead + 1) % STOPWATCH_LAP_COUNT;
+    if (lapTotal < UINT16_MAX) lapTotal++;
+    lastLapUs = now;
+    showLap(1);
+  }
+
+  // ADD / SUBTRACT - step through the stored laps (newest first), 0 = live
+  void handleNextLap() {
+    if (storedLaps() == 0) return;
+    showLap(lapView >= storedLaps() ? 0 : lapView + 1);
+  }
+
+  void handlePreviousLap() {
+    if (storedLaps() == 0) return;
+    showLap(lapView == 0 ? storedLaps() : lapView - 1);
+  }
+
+  // Single CANCEL - leave lap view, or reset a stopped stopwatch
+  void handleCancelButton() {
+    if (lapView > 0) {
+      showLap(0);
+    } else if (!running) {
+      reset();
+    }
+  }
+
+  // Mode entered - start on the live view
+  void showLive() {
+    lapView = 0;
+    lastShownUnit = -1;
+  }
+};
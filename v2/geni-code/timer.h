@@ -1,99 +1,61 @@
 #pragma once
 
 #include "HDSPDisplay.h"
+#include "timerpool.h"
 #include "constants.h"
 
+// Timer mode UI - edits / starts / pauses one timer of the TimerPool. The
+// countdowns themselves live in the pool and keep running when the mode is
+// left; entering the mode only resets this UI.
 class Timer {
 private:
   // Timer state
   bool settingTimer;
-  bool startedTimer;
-  bool timerFinished;
-  byte currentSetting;  // 0=hours, 1=minutes, 2=seconds
+  byte currentSetting;  // 0=timer select, 1=hours, 2=minutes, 3=seconds
+  byte selected;        // TimerPool id
 
-  // Timer values
+  // Timer values (the duration being set)
   int currentHours;
   int currentMinutes;
   int currentSeconds;
 
-  // Countdown tracking
-  unsigned long previousMillis;
-
-  // Timer alarm - FIXED timing variables
-  bool alarmPlaying;
-  unsigned long alarmStartTime;
-  byte alarmStep;
-  unsigned long alarmCycleGap;
-  unsigned long noteStartTime;  // Track individual note timing
-
   // Setting display state
   bool showingSettingTitle;
   unsigned long settingTitleStartTime;
 
-  // Cancel button tracking - UPDATED for single/double press detection
-  unsigned long lastCancelPress;
-  byte cancelPressCount;
-  bool cancelSingleProcessed;
-
   // Reference to external components
   HDSPDisplay* display;
-  byte buzzerPin;
+  TimerPool* pool;
 
 public:
-  Timer(HDSPDisplay* hdspDisplay, byte buzzer)
-    : display(hdspDisplay), buzzerPin(buzzer) {
+  Timer(HDSPDisplay* hdspDisplay, TimerPool* timerPool)
+    : selected(0), display(hdspDisplay), pool(timerPool) {
     reset();
   }
 
   void reset() {
     settingTimer = true;
-    startedTimer = false;
-    timerFinished = false;
     currentSetting = 0;
     currentHours = 0;
     currentMinutes = 0;
     currentSeconds = 0;
-    previousMillis = 0;
-    alarmPlaying = false;
-    alarmStartTime = 0;
-    alarmStep = 0;
-    alarmCycleGap = 0;
-    noteStartTime = 0;  // Initialize note timing
     showingSettingTitle = true;
     settingTitleStartTime = millis();
-    cancelPressCount = 0;
-    lastCancelPress = 0;
-    cancelSingleProcessed = false;
     exitTimerMode = false;
   }
 
   // Handle timer updates (call this in main loop when in timer mode)
   void update() {
-    // Handle cancel button timeout and single press processing
-    if (cancelPressCount > 0 && (millis() - lastCancelPress > TIMER_CANCEL_DOUBLE_PRESS_WINDOW)) {
-      if (cancelPressCount == 1 && !cancelSingleProcessed) {
-        // Process single press - reset current setting to 0
-        handleCancelSinglePress();
-        cancelSingleProcessed = true;
-      }
-      cancelPressCount = 0;
-    }
-
     // Handle setting title timeout
     if (showingSettingTitle && (millis() - settingTitleStartTime >= TIMER_SETTING_TITLE_DURATION)) {
       showingSettingTitle = false;
     }
 
-    if (alarmPlaying) {
-      handleAlarm();
+    if (pool->isRinging()) {
       updateAlarmDisplay();
       return;
     }
 
-    if (startedTimer) {
-      handleCountdown();
-    }
-
     updateDisplay();
   }
 
@@ -105,66 +67,63 @@ public:
 
   // Button handlers
   void handleConfirmButton() {
-    if (alarmPlaying || timerFinished) {
+    if (pool->isRinging()) {
       // Stop alarm and reset
       stopAlarm();
-      reset();
       return;
     }
 
     if (settingTimer) {
       handleValueConfirm();
-    } else if (!startedTimer) {
-      handleTimerStart();
+    } else if (pool->getState(selected) == PTIMER_RUNNING) {
+      pool->pause(selected);
     } else {
-      handleTimerStop();
+      pool->start(selected);
     }
   }
 
   void handleAddButton() {
-    if (alarmPlaying || timerFinished) {
+    if (pool->isRinging()) {
       stopAlarm();
-      reset();
       return;
     }
-    if (settingTimer && !alarmPlaying && !showingSettingTitle) {
+    if (settingTimer && !showingSettingTitle) {
       handleAdd();
     }
   }
 
   void handleSubtractButton() {
-    if (alarmPlaying || timerFinished) {
+    if (pool->isRinging()) {
       stopAlarm();
-      reset();
       return;
     }
-    if (settingTimer && !alarmPlaying && !showingSettingTitle) {
+    if (settingTimer && !showingSettingTitle) {
       handleSubtract();
     }
   }
 
+  // Single CANCEL (the gesture engine already waited out the double-press window)
   void handleCancelButton() {
-    if (alarmPlaying || timerFinished) {
+    if (pool->isRinging()) {
       stopAlarm();
-      reset();
       exitTimerMode = true;
       return;
     }
 
-    unsigned long currentTime = millis();
+    handleCancelSinglePress();
+  }
 
-    // Check for double press
-    if (currentTime - lastCancelPress <= TIMER_CANCEL_DOUBLE_PRESS_WINDOW && cancelPressCount == 1) {
-      // Double press detected - exit timer mode
-      cancelPressCount = 0;
-      exitTimerMode = true;
-      return;
+  // Double CANCEL - exit timer mode (running timers keep running)
+  void handleCancelDoublePress() {
+    if (pool->isRinging()) {
+      stopAlarm();
     }
+    exitTimerMode = true;
+  }
 
-    // Record the press
-    cancelPressCount = 1;
-    lastCancelPress = currentTime;
-    cancelSingleProcessed = false;  // Reset flag for new press
+  // While ringing any CANCEL must act at once - no double-press window
+  bool isRinging() const {
+    return pool->isRinging();
   }
 
   // Get current state for display purposes
@@ -180,18 +139,29 @@ public:
 private:
   bool exitTimerMode = false;  // Flag for double-cancel exit
 
-  // NEW: Handle single cancel press - reset current setting to 0
+  // Handle single cancel press - reset current setting to 0
   void handleCancelSinglePress() {
-    if (!settingTimer || showingSettingTitle) return;  // Only work in setting mode, not during title display
+    if (!settingTimer) {
+      // Paused / not yet started countdown - discard it, back to setting
+      if (pool->getState(selected) != PTIMER_RUNNING) {
+        pool->clear(selected);
+        reset();
+      }
+      return;
+    }
+    if (showingSettingTitle) return;  // Not during title display
 
     switch (currentSetting) {
-      case 0:  // Hours
+      case 0:  // Timer select
+        selected = 0;
+        break;
+      case 1:  // Hours
         currentHours = 0;
         break;
-      case 1:  // Minutes
+      case 2:  // Minutes
         currentMinutes = 0;
         break;
-      case 2:  // Seconds
+      case 3:  // Seconds
         currentSeconds = 0;
         break;
     }
@@ -210,30 +180,69 @@ private:
     return formatTimerValue(currentHours) + ":" + formatTimerValue(currentMinutes) + ":" + formatTimerValue(currentSeconds);
   }
 
+  int64_t getSetDurationUs() const {
+    return ((int64_t)currentHours * 3600 + currentMinutes * 60 + currentSeconds) * 1000000LL;
+  }
+
+  // Remaining time, rounded up (00:00:00 only once it's over). Tenths of a
+  // second in the final minute.
+  void formatRemaining(char* buffer) const {
+    int64_t left = pool->getRemainingUs(selected);
+    if (left < (int64_t)TIMER_TENTHS_BELOW_MS * 1000) {
+      uint32_t tenths = (left + 99999) / 100000;
+      sprintf(buffer, "   %02u.%u ", (unsigned)(tenths / 10), (unsigned)(tenths % 10));
+      return;
+    }
+    uint32_t secs = (left + 999999) / 1000000;
+    sprintf(buffer, "%02u:%02u:%02u", (unsigned)(secs / 3600), (unsigned)(secs / 60 % 60), (unsigned)(secs % 60));
+  }
+
+  // Timer list entry - T1  --  / T1 05:00 / T1 12h05
+  void formatSlot(char* buffer) const {
+    if (pool->getState(selected) == PTIMER_IDLE) {
+      sprintf(buffer, "T%u  --  ", selected + 1);
+      return;
+    }
+    uint32_t secs = (pool->getRemainingUs(selected) + 999999) / 1000000;
+    if (secs < 3600) {
+      sprintf(buffer, "T%u %02u:%02u", selected + 1, (unsigned)(secs / 60), (unsigned)(secs % 60));
+    } else {
+      sprintf(buffer, "T%u %2uh%02u", selected + 1, (unsigned)(secs / 3600), (unsigned)(secs / 60 % 60));
+    }
+  }
+
   // Get current setting title
   String getCurrentSettingTitle() const {
     switch (currentSetting) {
-      case 0: return "SET HRS ";
-      case 1: return "SET MIN ";
-      case 2: return "SET SEC ";
+      case 0: return "SEL TIMR";
+      case 1: return "SET HRS ";
+      case 2: return "SET MIN ";
+      case 3: return "SET SEC ";
       default: return "";
     }
   }
 
-  // Handle value confirmation (hours -> minutes -> seconds -> done)
+  // Handle value confirmation (timer -> hours -> minutes -> seconds -> done)
   void handleValueConfirm() {
     if (showingSettingTitle) return;  // Ignore if still showing title
 
+    if (currentSetting == 0 && pool->getState(selected) != PTIMER_IDLE) {
+      // Timer already set / running - straight to its countdown
+      settingTimer = false;
+      return;
+    }
+
     currentSetting++;
-    if (currentSetting >= 3) {
+    if (currentSetting >= 4) {
       // All values set, check if timer has valid time
       if (currentHours == 0 && currentMinutes == 0 && currentSeconds == 0) {
-        // No time set, reset to beginning
-        currentSetting = 0;
+        // No time set, back to the hours
+        currentSetting = 1;
         showingSettingTitle = true;
         settingTitleStartTime = millis();
       } else {
-        // Valid time set, exit setting mode
+        // Valid time set, exit setting mode - CONFIRM starts it
+        pool->set(selected, getSetDurationUs());
         settingTimer = false;
       }
     } else {
@@ -246,19 +255,22 @@ private:
   // Handle adding to current setting
   void handleAdd() {
     switch (currentSetting) {
-      case 0:  // Hours
+      case 0:  // Timer select
+        selected = (selected + 1) % TIMER_POOL_SIZE;
+        break;
+      case 1:  // Hours
         currentHours++;
         if (currentHours > 23) {
           currentHours = 0;
         }
         break;
-      case 1:  // Minutes
+      case 2:  // Minutes
         currentMinutes++;
         if (currentMinutes > 59) {
           currentMinutes = 0;
         }
         break;
-      case 2:  // Seconds
+      case 3:  // Seconds
         currentSeconds++;
         if (currentSeconds > 59) {
           currentSeconds = 0;
@@ -270,19 +282,22 @@ private:
   // Handle subtracting from current setting
   void handleSubtract() {
     switch (currentSetting) {
-      case 0:  // Hours
+      case 0:  // Timer select
+        selected = (selected == 0) ? TIMER_POOL_SIZE - 1 : selected - 1;
+        break;
+      case 1:  // Hours
         currentHours--;
         if (currentHours < 0) {
           currentHours = 23;
         }
         break;
-      case 1:  // Minutes
+      case 2:  // Minutes
         currentMinutes--;
         if (currentMinutes < 0) {
           currentMinutes = 59;
         }
         break;
-      case 2:  // Seconds
+      case 3:  // Seconds
         currentSeconds--;
         if (currentSeconds < 0) {
           currentSeconds = 59;
@@ -291,143 +306,44 @@ private:
     }
   }
 
-  // Start the timer countdown
-  void handleTimerStart() {
-    if (currentHours == 0 && currentMinutes == 0 && currentSeconds == 0) {
-      // Can't start with 0 time, go back to setting
-      settingTimer = true;
-      currentSetting = 0;
-      showingSettingTitle = true;
-      settingTitleStartTime = millis();
-      return;
-    }
-
-    startedTimer = true;
-    previousMillis = millis();
-  }
-
-  // Stop/pause the timer
-  void handleTimerStop() {
-    startedTimer = false;
-  }
-
-  // Handle countdown logic
-  void handleCountdown() {
-    unsigned long currentMillis = millis();
-
-    // Every 1 second
-    if (currentMillis - previousMillis >= TIMER_COUNTDOWN_INTERVAL) {
-      previousMillis = currentMillis;
-
-      // Countdown logic
-      if (currentSeconds > 0) {
-        currentSeconds--;
-      } else if (currentMinutes > 0) {
-        currentMinutes--;
-        currentSeconds = 59;
-      } else if (currentHours > 0) {
-        currentHours--;
-        currentMinutes = 59;
-        currentSeconds = 59;
-      } else {
-        // Timer finished!
-        startedTimer = false;
-        timerFinished = true;
-        startAlarm();
-      }
-    }
-  }
-
-  // Start the timer alarm - loops until stopped by any joystick interaction
-  void startAlarm() {
-    alarmPlaying = true;
-    alarmStartTime = millis();
-    noteStartTime = millis();  // Initialize note timing
-    alarmStep = 0;
-    alarmCycleGap = 0;
-
-    // Stop any existing tone and play first tone WITHOUT duration parameter
-    noTone(buzzerPin);
-    delay(10);
-    tone(buzzerPin, TIMER_ALARM_MELODY[0]);  // NO duration parameter!
-  }
-
-  // Handle alarm progression - loops the melody forever (gap between passes)
-  // until the user interacts; there's no cycle limit / auto-stop anymore.
-  void handleAlarm() {
-    unsigned long currentMillis = millis();
-
-    // Handle gap between melody repeats
-    if (alarmCycleGap > 0) {
-      if (currentMillis - alarmCycleGap >= TIMER_ALARM_CYCLE_GAP_DURATION) {
-        alarmCycleGap = 0;
-        alarmStep = 0;
-        noteStartTime = currentMillis;
-
-        noTone(buzzerPin);
-        delay(5);
-        tone(buzzerPin, TIMER_ALARM_MELODY[0]);
-      }
-      return;
-    }
-
-    // Check if current note duration has elapsed
-    if (currentMillis - noteStartTime >= TIMER_ALARM_STEP_DURATION) {
-      alarmStep++;
-
-      if (alarmStep < TIMER_ALARM_MELODY_LENGTH) {
-        // Play next tone in melody
-        noteStartTime = currentMillis;
-        noTone(buzzerPin);
-        delay(5);
-        tone(buzzerPin, TIMER_ALARM_MELODY[alarmStep]);
-      } else {
-        // Melody finished - brief gap, then repeat (forever, until stopped)
-        noTone(buzzerPin);
-        alarmCycleGap = currentMillis;
-      }
-    }
-  }
-
-  // Stop the alarm
+  // Stop the alarm - every expired timer is dismissed, the UI starts over
   void stopAlarm() {
-    alarmPlaying = false;
-    timerFinished = false;
-    noTone(buzzerPin);
+    pool->dismissRinging();
+    reset();
   }
 
   // Update display based on current state
   void updateDisplay() {
+    char buffer[16];
     if (settingTimer) {
       if (showingSettingTitle) {
-        // Show setting title (SET HRS, SET MIN, SET SEC)
+        // Show setting title (SEL TIMR, SET HRS, SET MIN, SET SEC)
         String titleStr = getCurrentSettingTitle();
-        char buffer[9];
         titleStr.toCharArray(buffer, 9);
-        display->displayText(buffer);
+      } else if (currentSetting == 0) {
+        formatSlot(buffer);
       } else {
         // Show current timer values
         String timerStr = getTimerString();
-        char buffer[9];
         timerStr.toCharArray(buffer, 9);
-        display->displayText(buffer);
       }
     } else {
       // Show countdown or ready timer
-      String timerStr = getTimerString();
-      char buffer[9];
-      timerStr.toCharArray(buffer, 9);
-      display->displayText(buffer);
+      formatRemaining(buffer);
     }
+    display->displayText(buffer);
   }
 
-  // Update alarm display
+  // Update alarm display - TIME UP flashing with the name of the timer that ran out
   void updateAlarmDisplay() {
-    // Flash "TIME UP" message
-    if ((millis() / 300) % 2 == 0) {
+    unsigned long phase = (millis() / 300) % 4;
+    if (phase == 0) {
       display->displayText("TIME UP ");
+    } else if (phase == 2) {
+      byte id = pool->firstRinging();
+      display->displayText((char*)(id < TIMER_POOL_SIZE ? pool->getName(id) : "TIME UP "));
     } else {
       display->displayText("        ");
     }
   }
-};
\ No newline at end of file
+};
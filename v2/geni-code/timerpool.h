@@ -0,0 +1,240 @@
+#pragma once
+
+#include <esp_timer.h>
+#include "audio.h"
+#include "melodies.h"
+#include "constants.h"
+
+enum PoolTimerState : byte {
+  PTIMER_IDLE = 0,
+  PTIMER_PAUSED,   // set (or paused) - remainingUs is what's left
+  PTIMER_RUNNING,  // in the deadline heap
+  PTIMER_RINGING,  // ran out, waiting to be dismissed
+};
+
+struct PoolTimer {
+  const char* name;  // pontosan 8 karakter
+  PoolTimerState state;
+  int64_t deadlineUs;   // esp_timer_get_time() when it runs out
+  int64_t remainingUs;  // while paused
+};
+
+// Fixed set of countdown timers running independently of the visible mode.
+// Running timers sit in a min-heap keyed by deadline, so tick() only ever
+// looks at the nearest one. Expiry plays the timer melody (SOUND_TIMER)
+// until dismissRinging(). A one-shot esp_timer armed at the nearest
+// deadline starts the melody on the exact microsecond, however late the
+// next loop() is; tick() then does the bookkeeping.
+class TimerPool {
+private:
+  PoolTimer timers[TIMER_POOL_SIZE];
+  byte heap[TIMER_POOL_SIZE];     // timer ids, heap[0] = nearest deadline
+  byte heapIndex[TIMER_POOL_SIZE];  // id -> position in heap, HEAP_NONE if not running
+  byte heapSize;
+  byte ringingCount;
+  AudioSequencer* audio;
+  esp_timer_handle_t deadlineTimer;
+  volatile bool melodyStarted;  // set by the deadline callback (timer task)
+  int64_t armedDeadlineUs;           // what deadlineTimer is armed for
+  volatile int64_t firedDeadlineUs;  // what the callback last fired for
+
+  static const byte HEAP_NONE = 0xFF;
+
+  bool earlier(byte a, byte b) const {
+    return timers[heap[a]].deadlineUs < timers[heap[b]].deadlineUs;
+  }
+
+  void swapNodes(byte a, byte b) {
+    byte t = heap[a];
+    heap[a] = heap[b];
+    heap[b] = t;
+    heapIndex[heap[a]] = a;
+    heapIndex[heap[b]] = b;
+  }
+
+  void siftUp(byte pos) {
+    while (pos > 0) {
+      byte parent = (pos - 1) / 2;
+      if (!earlier(pos, parent)) break;
+      swapNodes(pos, parent);
+      pos = parent;
+    }
+  }
+
+  void siftDown(byte pos) {
+    while (true) {
+      byte left = 2 * pos + 1;
+      byte right = left + 1;
+      byte best = pos;
+      if (left < heapSize && earlier(left, best)) best = left;
+      if (right < heapSize && earlier(right, best)) best = right;
+      if (best == pos) break;
+      swapNodes(pos, best);
+      pos = best;
+    }
+  }
+
+  void heapPush(byte id) {
+    heap[heapSize] = id;
+    heapIndex[id] = heapSize;
+    heapSize++;
+    siftUp(heapSize - 1);
+  }
+
+  static void onDeadline(void* arg) {
+    TimerPool* pool = static_cast<TimerPool*>(arg);
+    pool->audio->play(SOUND_TIMER, TIMER_ALARM_MELODY.notes, TIMER_ALARM_MELODY.length, true);
+    pool->firedDeadlineUs = pool->armedDeadlineUs;
+    pool->melodyStarted = true;
+  }
+
+  // Deadline timer follows the heap top
+  void rearm() {
+    if (!deadlineTimer) return;
+    esp_timer_stop(deadlineTimer);
+    if (heapSize == 0) return;
+    armedDeadlineUs = timers[heap[0]].deadlineUs;
+    int64_t waitUs = armedDeadlineUs - esp_timer_get_time();
+    esp_timer_start_once(deadlineTimer, waitUs > 0 ? waitUs : 1);
+  }
+
+  void heapRemove(byte id) {
+    byte pos = heapIndex[id];
+    if (pos == HEAP_NONE) return;
+    heapSize--;
+    if (pos != heapSize) {
+      swapNodes(pos, heapSize);
+      siftDown(pos);
+      siftUp(pos);
+    }
+    heapIndex[id] = HEAP_NONE;
+  }
+
+public:
+  TimerPool(AudioSequencer* audioSequencer)
+    : heapSize(0), ringingCount(0), audio(audioSequencer), deadlineTimer(nullptr), melodyStarted(false),
+      armedDeadlineUs(0), firedDeadlineUs(0) {
+    for (byte i = 0; i < TIMER_POOL_SIZE; i++) {
+      timers[i].name = TIMER_NAMES[i];
+      timers[i].state = PTIMER_IDLE;
+      timers[i].deadlineUs = 0;
+      timers[i].remainingUs = 0;
+      heapIndex[i] = HEAP_NONE;
+    }
+  }
+
+  // Without begin() expiry is only seen by tick(), up to one loop() late
+  void begin() {
+    esp_timer_create_args_t args = {};
+    args.callback = &TimerPool::onDeadline;
+    args.arg = this;
+    args.dispatch_method = ESP_TIMER_TASK;
+    args.name = "timerpool";
+    esp_timer_create(&args, &deadlineTimer);
+  }
+
+  // Deadline check - call every loop(); only the heap top is compared
+  void tick() {
+    // Flag first, clock second: a deadline the callback fires for is then
+    // never later than 'now', so its timer expires in this very tick
+    bool started = melodyStarted;
+    melodyStarted = false;
+    int64_t firedFor = firedDeadlineUs;
+    int64_t now = esp_timer_get_time();
+    bool expired = false;
+    while (heapSize > 0 && timers[heap[0]].deadlineUs <= now) {
+      byte id = heap[0];
+      heapRemove(id);
+      timers[id].state = PTIMER_RINGING;
+      timers[id].remainingUs = 0;
+      ringingCount++;
+      expired = true;
+    }
+    if (expired) {
+      rearm();
+      // The callback already started it at the deadline - don't restart the melody
+      if (!started) audio->play(SOUND_TIMER, TIMER_ALARM_MELODY.notes, TIMER_ALARM_MELODY.length, true);
+    } else if (started && ringingCount == 0 && (heapSize == 0 || timers[heap[0]].deadlineUs > firedFor)) {
+      audio->stop(SOUND_TIMER);  // paused / cleared on the deadline itself
+    }
+  }
+
+  // Load a duration (stopped, ready to start)
+  void set(byte id, int64_t durationUs) {
+    clear(id);
+    timers[id].state = PTIMER_PAUSED;
+    timers[id].remainingUs = durationUs;
+  }
+
+  void start(byte id) {
+    PoolTimer& t = timers[id];
+    if (t.state != PTIMER_PAUSED || t.remainingUs <= 0) return;
+    t.state = PTIMER_RUNNING;
+    t.deadlineUs = esp_timer_get_time() + t.remainingUs;
+    heapPush(id);
+    rearm();
+  }
+
+  void pause(byte id) {
+    PoolTimer& t = timers[id];
+    if (t.state != PTIMER_RUNNING) return;
+    t.remainingUs = getRemainingUs(id);
+    heapRemove(id);
+    rearm();
+    t.state = PTIMER_PAUSED;
+  }
+
+  void clear(byte id) {
+    PoolTimer& t = timers[id];
+    if (t.state == PTIMER_RUNNING) {
+      heapRemove(id);
+      rearm();
+    }
+    if (t.state == PTIMER_RINGING) {
+      ringingCount--;
+      if (ringingCount == 0) audio->stop(SOUND_TIMER);
+    }
+    t.state = PTIMER_IDLE;
+    t.remainingUs = 0;
+  }
+
+  // Any input while ringing - every expired timer goes back to idle
+  void dismissRinging() {
+    for (byte i = 0; i < TIMER_POOL_SIZE; i++) {
+      if (timers[i].state == PTIMER_RINGING) timers[i].state = PTIMER_IDLE;
+    }
+    ringingCount = 0;
+    audio->stop(SOUND_TIMER);
+  }
+
+  int64_t getRemainingUs(byte id) const {
+    const PoolTimer& t = timers[id];
+    if (t.state != PTIMER_RUNNING) return t.remainingUs;
+    int64_t left = t.deadlineUs - esp_timer_get_time();
+    return left > 0 ? left : 0;
+  }
+
+  PoolTimerState getState(byte id) const {
+    return timers[id].state;
+  }
+
+  const char* getName(byte id) const {
+    return timers[id].name;
+  }
+
+  bool isRinging() const {
+    return ringingCount > 0;
+  }
+
+  // First expired timer (for the TIME UP screen), TIMER_POOL_SIZE if none
+  byte firstRinging() const {
+    for (byte i = 0; i < TIMER_POOL_SIZE; i++) {
+      if (timers[i].state == PTIMER_RINGING) return i;
+    }
+    return TIMER_POOL_SIZE;
+  }
+
+  byte getRunningCount() const {
+    return heapSize;
+  }
+};
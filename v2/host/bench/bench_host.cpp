@@ -0,0 +1,131 @@
+// bench.h's cases on the host, against the panel model: the same CSV rows
+// as the board prints with BENCHMARK_AT_BOOT, so a change to a hot path can
+// be compared before / after without flashing. Times are the host's wall
+// clock - the display cases include the MCP23017 / panel models, not the
+// I2C bus - so compare host rows with host rows only. The virtual time of
+// the display cases (I2C transfers at the bus clock + the driver's strobe
+// delays: what the board is blocked for) follows as
+//   BUS,<case>,<iterations>,<total us>
+//
+//   bench_host [repeat]   (best of 'repeat' runs per case, default 5)
+
+#include <chrono>
+#include <cstdlib>
+#include <map>
+#include <sstream>
+
+#include <Arduino.h>
+#include "constants.h"
+#include "HDSPDisplay.h"
+#include "gps.h"
+#include "Better-JoyStick.h"
+#include "bench.h"
+
+#include "mcp23017.h"
+#include "panel.h"
+
+// runAll() waits for a pending panel reset by spinning on update(), and
+// the virtual millis() doesn't move while it spins - step it through here
+static void settle(HDSPDisplay& display) {
+  while (display.isResetting()) {
+    display.update();
+    host::advanceUs(1000);
+  }
+}
+
+static uint64_t wallNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+    .count();
+}
+
+struct Row {
+  uint32_t iterations = 0;
+  uint64_t totalUs = 0, nsPerOp = 0;
+};
+
+// Serial's BENCH rows -> case -> row
+static std::map<std::string, Row> parseRows(const std::string& out, std::vector<std::string>& order) {
+  std::map<std::string, Row> rows;
+  std::istringstream in(out);
+  std::string line;
+  while (std::getline(in, line)) {
+    if (line.rfind("BENCH,", 0) != 0 || line.rfind("BENCH,case,", 0) == 0) continue;
+    std::istringstream fields(line.substr(6));
+    std::string name, iterations, total, perOp;
+    std::getline(fields, name, ',');
+    std::getline(fields, iterations, ',');
+    std::getline(fields, total, ',');
+    std::getline(fields, perOp, ',');
+    Row& row = rows[name];
+    row.iterations = strtoul(iterations.c_str(), nullptr, 10);
+    row.totalUs = strtoull(total.c_str(), nullptr, 10);
+    row.nsPerOp = strtoull(perOp.c_str(), nullptr, 10);
+    order.push_back(name);
+  }
+  return rows;
+}
+
+int main(int argc, char** argv) {
+  int repeat = argc > 1 ? atoi(argv[1]) : 5;
+  if (repeat < 1) {
+    fprintf(stderr, "usage: bench_host [repeat]\n");
+    return 2;
+  }
+
+  host::reset();
+  host::setI2cLogging(false);
+  Mcp23017 mcp;
+  DisplayPanel panel(DisplayPanel::PANEL_HDSP2111);
+  mcp.onOutputs = [&panel](uint8_t gpa, uint8_t gpb) {
+    panel.onPins(gpa, gpb);
+  };
+  host::attachI2c(MCP23017_ADDR, &mcp);
+  host::setAnalog(JS_X, JS_DEFAULT_X_CENTER);
+  host::setAnalog(JS_Y, JS_DEFAULT_Y_CENTER);
+
+  HDSPDisplay display;
+  display.setClockType(DisplayPanel::PANEL_HDSP2111);
+  display.begin();
+  GPS gps;
+  gps.begin(GPS_RX, GPS_TX);
+  BetterJoystick joystick;
+  joystick.begin(JS_SW, JS_X, JS_Y);
+
+  // Best (lowest ns/op) of the runs - the host is not a quiet board
+  std::map<std::string, Row> best;
+  std::vector<std::string> order;
+  for (int run = 0; run < repeat; run++) {
+    Benchmark::nowNs = wallNs;
+    settle(display);
+    host::serialOutput().clear();
+    Benchmark::runAll(display, gps, joystick, DisplayPanel::PANEL_HDSP2111);
+    std::vector<std::string> names;
+    for (const auto& [name, row] : parseRows(host::serialOutput(), names)) {
+      auto it = best.find(name);
+      if (it == best.end() || row.nsPerOp < it->second.nsPerOp) best[name] = row;
+    }
+    if (run == 0) order = names;
+  }
+
+  // Bus time: the virtual clock only moves on the wire and in delays
+  Benchmark::nowNs = [] { return host::nowUs() * 1000; };
+  settle(display);
+  host::serialOutput().clear();
+  Benchmark::runAll(display, gps, joystick, DisplayPanel::PANEL_HDSP2111);
+  std::vector<std::string> busOrder;
+  std::map<std::string, Row> bus = parseRows(host::serialOutput(), busOrder);
+
+  printf("BENCH,case,iterations,total_us,ns_per_op\n");
+  for (const std::string& name : order) {
+    const Row& row = best[name];
+    printf("BENCH,%s,%u,%llu,%llu\n", name.c_str(), row.iterations, (unsigned long long)row.totalUs,
+           (unsigned long long)row.nsPerOp);
+  }
+  printf("BUS,case,iterations,total_us\n");
+  for (const std::string& name : busOrder) {
+    const Row& row = bus[name];
+    if (row.totalUs == 0) continue;  // no I2C in it
+    printf("BUS,%s,%u,%llu\n", name.c_str(), row.iterations, (unsigned long long)row.totalUs);
+  }
+  return 0;
+}
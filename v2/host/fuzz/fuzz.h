@@ -0,0 +1,28 @@
+#pragma once
+
+// Shared by the LLVMFuzzerTestOneInput targets. A broken invariant aborts,
+// which both libFuzzer and fuzz_main.cpp report as a crash with the input.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "host.h"
+
+#define FUZZ_CHECK(cond)                                                        \
+  do {                                                                          \
+    if (!(cond)) {                                                              \
+      fprintf(stderr, "%s:%d: invariant broken: %s\n", __FILE__, __LINE__, #cond); \
+      abort();                                                                  \
+    }                                                                           \
+  } while (0)
+
+// "$<body>*<XOR checksum>\r\n"
+inline std::string fuzzNmea(const std::string& body) {
+  uint8_t sum = 0;
+  for (char c : body) sum ^= (uint8_t)c;
+  char tail[8];
+  snprintf(tail, sizeof(tail), "*%02X\r\n", sum);
+  return "$" + body + tail;
+}
@@ -0,0 +1,80 @@
+// The UTC -> Hungarian local time conversion (GPS::convertToHungarianTime,
+// the DST rule, calculateDayOfWeek) against RTClib: the input picks a UTC
+// second in 2000-2099, it goes in as an RMC sentence, and the local date,
+// time and weekday that come out must equal DateTime arithmetic with the
+// EU rule (CEST from 01:00 UTC on the last Sunday of March to 01:00 UTC on
+// the last Sunday of October) worked out from DateTime::dayOfTheWeek().
+// Inputs near the DST instants and the midnights are favoured.
+//
+//   fuzz_local_time [-runs=N]
+
+#include <Arduino.h>
+#include <RTClib.h>
+#include "constants.h"
+#include "gps.h"
+
+#include "fuzz.h"
+
+static uint32_t lastSundayUtc1(int year, int month) {
+  DateTime day(year, month, 31, 1, 0, 0);
+  while (day.dayOfTheWeek() != 0) day = day - TimeSpan(1, 0, 0, 0);
+  return day.unixtime();
+}
+
+static uint32_t expectedLocal(uint32_t utc) {
+  DateTime t(utc);
+  bool dst = utc >= lastSundayUtc1(t.year(), 3) && utc < lastSundayUtc1(t.year(), 10);
+  return utc + (dst ? 7200 : 3600);
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+  uint8_t in[5] = {};  // shorter inputs: zero-padded
+  memcpy(in, data, size < sizeof(in) ? size : sizeof(in));
+  uint32_t raw = (uint32_t)in[0] | (uint32_t)in[1] << 8 | (uint32_t)in[2] << 16 | (uint32_t)in[3] << 24;
+  const uint32_t first = DateTime(2000, 1, 1, 0, 0, 0).unixtime();
+  const uint32_t last = DateTime(2099, 12, 31, 23, 59, 59).unixtime();
+
+  uint32_t utc;
+  switch (in[4] % 4) {
+    case 0:  // a DST change of a year, +-2 h
+    case 1: {
+      int year = 2000 + raw % 100;
+      uint32_t change = lastSundayUtc1(year, in[4] % 4 == 0 ? 3 : 10);
+      utc = change - 7200 + (raw >> 8) % 14400;
+      break;
+    }
+    case 2:  // around a UTC midnight (the local day changes an hour or two later)
+      utc = first + (raw % 36525) * 86400 + 21 * 3600 + (raw >> 16) % (5 * 3600);
+      break;
+    default:
+      utc = first + raw % (last - first + 1);
+      break;
+  }
+  if (utc > last) utc = last;
+
+  host::reset();
+  GPS gps;
+  gps.begin(GPS_RX, GPS_TX);
+  DateTime t(utc);
+  char body[80];
+  snprintf(body, sizeof(body), "GPRMC,%02d%02d%02d.00,A,4730.000,N,01903.000,E,0.0,0.0,%02d%02d%02d,,,A", t.hour(),
+           t.minute(), t.second(), t.day(), t.month(), t.year() % 100);
+  host::uartInject(1, fuzzNmea(body));
+  gps.update();
+  FUZZ_CHECK(gps.hasFix());
+
+  int year, month, day, dayIndex, hour, minute, second;
+  gps.getHungarianTime(year, month, day, dayIndex, hour, minute, second);
+  DateTime local(expectedLocal(utc));
+  if (local.year() > 2099) return 0;  // 2100: past RTClib's range, nothing to compare with
+  FUZZ_CHECK(year == local.year());
+  FUZZ_CHECK(month == local.month());
+  FUZZ_CHECK(day == local.day());
+  FUZZ_CHECK(hour == local.hour());
+  FUZZ_CHECK(minute == local.minute());
+  FUZZ_CHECK(second == local.second());
+  FUZZ_CHECK(dayIndex == local.dayOfTheWeek());
+  FUZZ_CHECK(gps.getUtcOffsetHours() * 3600 == (int)(local.unixtime() - utc));
+  host::serialOutput().clear();
+  return 0;
+}
@@ -0,0 +1,151 @@
+// Stand-in for libFuzzer's driver where there is no clang: the same
+// command line subset, so the ctest entries read the same either way.
+//
+//   fuzz_<target> [-runs=N] [-seed=S] [-max_len=L] [file|dir ...]
+//
+// Every file (or every file in a dir) is run as is, then N inputs made by
+// mutating them - bit flips, byte changes, inserts, deletes, duplicated
+// chunks, splices of two inputs, NMEA tokens dropped in. Deterministic for
+// a given seed. A crash / broken invariant aborts with the input saved to
+// crash-<run>.
+//
+// This is a random mutator, not coverage-guided: it finds what libFuzzer
+// finds only slower. Build with -DGENI_LIBFUZZER=ON under clang for the
+// real thing.
+
+#include <algorithm>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <string>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+namespace {
+
+std::vector<std::string> corpus;
+std::string current;  // the input being run, saved on a crash
+unsigned long currentRun = 0;
+
+void onAbort(int) {
+  char name[32];
+  snprintf(name, sizeof(name), "crash-%lu", currentRun);
+  FILE* f = fopen(name, "wb");
+  if (f) {
+    fwrite(current.data(), 1, current.size(), f);
+    fclose(f);
+  }
+  fprintf(stderr, "fuzz: crash on run %lu, input (%zu bytes) saved to %s\n", currentRun, current.size(), name);
+  signal(SIGABRT, SIG_DFL);
+  abort();
+}
+
+bool readFile(const std::string& path, std::string& out) {
+  FILE* f = fopen(path.c_str(), "rb");
+  if (!f) return false;
+  char buf[4096];
+  size_t n;
+  out.clear();
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0) out.append(buf, n);
+  fclose(f);
+  return true;
+}
+
+void load(const std::string& path) {
+  DIR* dir = opendir(path.c_str());
+  if (!dir) {
+    std::string data;
+    if (readFile(path, data)) corpus.push_back(data);
+    else fprintf(stderr, "fuzz: can't read %s\n", path.c_str());
+    return;
+  }
+  std::vector<std::string> names;
+  while (dirent* e = readdir(dir)) {
+    if (e->d_name[0] != '.') names.push_back(e->d_name);
+  }
+  closedir(dir);
+  std::sort(names.begin(), names.end());
+  for (const std::string& name : names) load(path + "/" + name);
+}
+
+uint64_t rngState;
+uint32_t rnd(uint32_t n) {
+  rngState ^= rngState << 13;
+  rngState ^= rngState >> 7;
+  rngState ^= rngState << 17;
+  return n ? (uint32_t)(rngState % n) : 0;
+}
+
+const char* const TOKENS[] = { "$GPRMC,", "$GNRMC,", "$GPGGA,", ",A,", ",V,", ",N,", ",E,", "*", "\r\n",
+                               ",,", "000000.00", "999999", "290224", "311299", "-", "." };
+
+void mutate(std::string& s, size_t maxLen) {
+  int count = 1 + rnd(4);
+  for (int i = 0; i < count; i++) {
+    size_t pos = s.empty() ? 0 : rnd(s.size());
+    switch (rnd(7)) {
+      case 0:
+        if (!s.empty()) s[pos] ^= (char)(1 << rnd(8));
+        break;
+      case 1:
+        if (!s.empty()) s[pos] = (char)rnd(256);
+        break;
+      case 2:
+        s.insert(s.begin() + pos, (char)("0123456789,.*$AVNE\r\n"[rnd(20)]));
+        break;
+      case 3:
+        if (!s.empty()) s.erase(pos, 1 + rnd(8));
+        break;
+      case 4:
+        if (!s.empty()) s.insert(pos, s.substr(rnd(s.size()), 1 + rnd(16)));
+        break;
+      case 5: {
+        const std::string& other = corpus[rnd(corpus.size())];
+        if (!other.empty()) s = s.substr(0, pos) + other.substr(rnd(other.size()));
+        break;
+      }
+      default:
+        s.insert(pos, TOKENS[rnd(sizeof(TOKENS) / sizeof(TOKENS[0]))]);
+        break;
+    }
+  }
+  if (s.size() > maxLen) s.resize(maxLen);
+}
+
+void run(const std::string& input) {
+  current = input;
+  LLVMFuzzerTestOneInput((const uint8_t*)current.data(), current.size());
+  currentRun++;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  unsigned long runs = 0;
+  unsigned long seed = 1;
+  size_t maxLen = 1024;
+  for (int i = 1; i < argc; i++) {
+    if (!strncmp(argv[i], "-runs=", 6)) runs = strtoul(argv[i] + 6, nullptr, 10);
+    else if (!strncmp(argv[i], "-seed=", 6)) seed = strtoul(argv[i] + 6, nullptr, 10);
+    else if (!strncmp(argv[i], "-max_len=", 9)) maxLen = strtoul(argv[i] + 9, nullptr, 10);
+    else if (argv[i][0] == '-') fprintf(stderr, "fuzz: %s ignored (libFuzzer only)\n", argv[i]);
+    else load(argv[i]);
+  }
+  signal(SIGABRT, onAbort);
+  rngState = seed ? seed : 1;
+
+  for (const std::string& input : corpus) run(input);
+  size_t loaded = corpus.size();
+  if (corpus.empty()) corpus.push_back("");
+  for (unsigned long i = 0; i < runs; i++) {
+    std::string input = corpus[rnd(corpus.size())];
+    mutate(input, maxLen);
+    run(input);
+  }
+  printf("fuzz: %lu inputs (%zu from the corpus), no crash\n", currentRun, loaded);
+  return 0;
+}
@@ -0,0 +1,67 @@
+// The GPS receive path with arbitrary bytes on the UART: GPS::update() ->
+// TinyGPSPlus::encode() -> getHungarianTime() -> GpsTimeFilter::accept(),
+// as updateTimeSource() drives it. Whatever a glitching module sends, the
+// local time handed out is a real calendar time (or all zero) and nothing
+// reads out of bounds. The bytes arrive in 9600 baud chunks with update()
+// calls in between, so sentences split across loop() passes are covered.
+// The firmware only sends UBX (CFG-RATE), it never parses any.
+//
+//   fuzz_nmea [-runs=N] corpus/nmea
+
+#include <Arduino.h>
+#include "constants.h"
+#include "gps.h"
+#include "gpsfilter.h"
+
+#include "fuzz.h"
+
+const size_t CHUNK = 64;
+const uint64_t BYTE_US = 1042;  // 10 bits at 9600 baud
+
+static int daysInMonth(int year, int month) {
+  static const int DAYS[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+  bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+  return month == 2 && leap ? 29 : DAYS[month - 1];
+}
+
+static void checkFix(GPS& gps, GpsTimeFilter& filter) {
+  if (!gps.hasFix()) {
+    FUZZ_CHECK(gps.getUtcOffsetHours() == 0);
+    return;
+  }
+  int offset = gps.getUtcOffsetHours();
+  FUZZ_CHECK(offset == 1 || offset == 2);
+
+  int year, month, day, dayIndex, hour, minute, second;
+  gps.getHungarianTime(year, month, day, dayIndex, hour, minute, second);
+  if (year == 0) return;  // nonsense date in the sentence - no time
+  FUZZ_CHECK(year >= 2000 && year <= 2100);
+  FUZZ_CHECK(month >= 1 && month <= 12);
+  FUZZ_CHECK(day >= 1 && day <= daysInMonth(year, month));
+  FUZZ_CHECK(dayIndex >= 0 && dayIndex <= 6);
+  FUZZ_CHECK(hour >= 0 && hour <= 23);
+  FUZZ_CHECK(minute >= 0 && minute <= 59);
+  FUZZ_CHECK(second >= 0 && second <= 59);
+
+  // Against a running RTC and one without a time
+  DateTime rtc(2025, 5, 1, 12, 0, 0);
+  filter.accept(year, month, day, hour, minute, second, rtc.unixtime());
+  filter.accept(year, month, day, hour, minute, second, 0, 3600);
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+  host::reset();
+  GPS gps;
+  gps.begin(GPS_RX, GPS_TX);
+  GpsTimeFilter filter;
+
+  for (size_t pos = 0; pos < size; pos += CHUNK) {
+    size_t n = size - pos < CHUNK ? size - pos : CHUNK;
+    host::uartInject(1, std::string((const char*)data + pos, n));
+    host::advanceUs(n * BYTE_US);
+    gps.update();
+    checkFix(gps, filter);
+  }
+  host::serialOutput().clear();
+  return 0;
+}
@@ -0,0 +1,187 @@
+#include "ds3231.h"
+
+#include <math.h>
+
+namespace {
+
+uint8_t bcd(uint8_t v) {
+  return (v / 10) << 4 | (v % 10);
+}
+
+uint8_t unbcd(uint8_t v) {
+  return (v >> 4) * 10 + (v & 0x0F);
+}
+
+const uint8_t CTRL_A1IE = 0x01, CTRL_A2IE = 0x02, CTRL_INTCN = 0x04;
+const uint8_t STAT_A1F = 0x01, STAT_A2F = 0x02, STAT_EN32K = 0x08, STAT_OSF = 0x80;
+
+}  // namespace
+
+Ds3231::Ds3231()
+  : pointer(0), expectPointer(false), timeWritten(false), secondsWritten(false), baseSecs(0), baseUs(host::nowUs()),
+    driftPpm(0), lastTickSecs(0), intPin(-1), adjustCount(0), matches{ 0, 0 } {
+  for (uint8_t i = 0; i < REG_COUNT; i++) regs[i] = 0;
+  regs[REG_CONTROL] = 0x1C;  // INTCN, RS2, RS1
+  regs[REG_STATUS] = STAT_OSF | STAT_EN32K;
+  setTemperature(25.25f);
+  materialise();
+}
+
+uint32_t Ds3231::secondsAt(uint64_t us) const {
+  double elapsed = (double)(us - baseUs) * (1.0 + driftPpm * 1e-6);
+  return baseSecs + (uint32_t)floor(elapsed / 1e6);
+}
+
+uint64_t Ds3231::usOfSecond(uint32_t secs) const {
+  uint64_t us = baseUs + (uint64_t)ceil((double)(secs - baseSecs) * 1e6 / (1.0 + driftPpm * 1e-6));
+  while (secondsAt(us) < secs) us++;
+  return us;
+}
+
+// Rebase on the last whole second and refresh the time registers
+void Ds3231::materialise() {
+  uint32_t secs = secondsAt(host::nowUs());
+  baseUs = usOfSecond(secs);
+  baseSecs = secs;
+
+  DateTime dt(secs + SECONDS_FROM_1970_TO_2000);
+  regs[0] = bcd(dt.second());
+  regs[1] = bcd(dt.minute());
+  regs[2] = bcd(dt.hour());
+  regs[3] = dt.dayOfTheWeek() == 0 ? 7 : dt.dayOfTheWeek();
+  regs[4] = bcd(dt.day());
+  regs[5] = bcd(dt.month());
+  regs[6] = bcd(dt.year() - 2000);
+}
+
+void Ds3231::loadFromRegisters(bool restartChain) {
+  uint64_t now = host::nowUs();
+  uint64_t fraction = restartChain ? 0 : now - usOfSecond(secondsAt(now));
+  DateTime dt(2000 + unbcd(regs[6]), unbcd(regs[5] & 0x1F), unbcd(regs[4]), unbcd(regs[2] & 0x3F), unbcd(regs[1]),
+              unbcd(regs[0] & 0x7F));
+  baseSecs = dt.secondstime();
+  baseUs = now - fraction;
+  lastTickSecs = baseSecs;  // the alarms compare against the new time only
+}
+
+void Ds3231::setTime(const DateTime& dt) {
+  baseSecs = dt.secondstime();
+  baseUs = host::nowUs();
+  lastTickSecs = baseSecs;
+  regs[REG_STATUS] &= ~STAT_OSF;
+  materialise();
+}
+
+DateTime Ds3231::time() const {
+  return DateTime(secondsAt(host::nowUs()) + SECONDS_FROM_1970_TO_2000);
+}
+
+void Ds3231::setTemperature(float celsius) {
+  int quarters = (int)lroundf(celsius * 4);
+  regs[0x11] = (uint8_t)(int8_t)(quarters >> 2);
+  regs[0x12] = (uint8_t)((quarters & 3) << 6);
+}
+
+void Ds3231::connectInt(int pin) {
+  intPin = pin;
+  updateInt();
+}
+
+uint8_t Ds3231::reg(uint8_t r) const {
+  return r < REG_COUNT ? regs[r] : 0xFF;
+}
+
+bool Ds3231::intAsserted() const {
+  uint8_t ctrl = regs[REG_CONTROL], stat = regs[REG_STATUS];
+  return (ctrl & CTRL_INTCN) && (((ctrl & CTRL_A1IE) && (stat & STAT_A1F)) || ((ctrl & CTRL_A2IE) && (stat & STAT_A2F)));
+}
+
+void Ds3231::updateInt() {
+  if (intPin >= 0) host::setPin(intPin, intAsserted() ? LOW : HIGH);
+}
+
+// Alarm match at the start of second 'secs' (A1: mask bits A1M1..4, DY/DT; A2 at :00)
+void Ds3231::checkAlarms(uint32_t secs) {
+  DateTime dt(secs + SECONDS_FROM_1970_TO_2000);
+  uint8_t dow = dt.dayOfTheWeek() == 0 ? 7 : dt.dayOfTheWeek();
+  auto dayMatch = [&](uint8_t r) {
+    return (r & 0x40) ? (r & 0x0F) == dow : unbcd(r & 0x3F) == dt.day();
+  };
+
+  const uint8_t* a1 = &regs[0x07];
+  bool m1 = ((a1[0] & 0x80) || unbcd(a1[0] & 0x7F) == dt.second()) &&
+            ((a1[1] & 0x80) || unbcd(a1[1] & 0x7F) == dt.minute()) &&
+            ((a1[2] & 0x80) || unbcd(a1[2] & 0x3F) == dt.hour()) && ((a1[3] & 0x80) || dayMatch(a1[3]));
+  if (m1) {
+    regs[REG_STATUS] |= STAT_A1F;
+    matches[0]++;
+  }
+
+  const uint8_t* a2 = &regs[0x0B];
+  bool m2 = dt.second() == 0 && ((a2[0] & 0x80) || unbcd(a2[0] & 0x7F) == dt.minute()) &&
+            ((a2[1] & 0x80) || unbcd(a2[1] & 0x3F) == dt.hour()) && ((a2[2] & 0x80) || dayMatch(a2[2]));
+  if (m2) {
+    regs[REG_STATUS] |= STAT_A2F;
+    matches[1]++;
+  }
+}
+
+void Ds3231::catchUp() {
+  uint32_t secs = secondsAt(host::nowUs());
+  while (lastTickSecs < secs) checkAlarms(++lastTickSecs);
+}
+
+uint64_t Ds3231::nextEventUs() const {
+  // Only worth ticking every second when a match can pull INT; otherwise
+  // the flags are caught up lazily on the next bus access
+  uint8_t ctrl = regs[REG_CONTROL];
+  if (intPin < 0 || !(ctrl & CTRL_INTCN) || !(ctrl & (CTRL_A1IE | CTRL_A2IE))) return UINT64_MAX;
+  return usOfSecond(lastTickSecs + 1);
+}
+
+void Ds3231::onEvent(uint64_t) {
+  catchUp();
+  updateInt();
+}
+
+void Ds3231::i2cStart(bool read) {
+  catchUp();
+  materialise();  // the chip copies the time into its read / write buffer on START
+  expectPointer = !read;
+  timeWritten = secondsWritten = false;
+}
+
+void Ds3231::i2cReceive(uint8_t b) {
+  if (expectPointer) {
+    pointer = b % REG_COUNT;
+    expectPointer = false;
+    return;
+  }
+  uint8_t r = pointer;
+  pointer = (pointer + 1) % REG_COUNT;
+  if (r <= 0x06) {
+    regs[r] = b;
+    timeWritten = true;
+    if (r == 0) secondsWritten = true;
+  } else if (r == REG_STATUS) {
+    // Flags can only be cleared; EN32kHz is writable
+    regs[r] = (regs[r] & b & (STAT_OSF | STAT_A2F | STAT_A1F)) | (b & STAT_EN32K);
+  } else if (r < 0x11) {
+    regs[r] = b;  // alarms, control, aging; temperature is read-only
+  }
+}
+
+uint8_t Ds3231::i2cTransmit() {
+  uint8_t r = pointer;
+  pointer = (pointer + 1) % REG_COUNT;
+  return regs[r];
+}
+
+void Ds3231::i2cStop() {
+  if (timeWritten) {
+    loadFromRegisters(secondsWritten);
+    adjustCount++;
+    timeWritten = secondsWritten = false;
+  }
+  updateInt();
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "host.h"
+#include "RTClib.h"
+
+// DS3231 register model on the virtual clock: BCD time / calendar
+// (2000-2099, 24 h mode), both alarms with their mask bits, INTCN and the
+// open-drain INT/SQW output, OSF, temperature. The oscillator can run
+// fast or slow (ppm) so GPS resyncs have something to correct.
+//
+// Time registers are latched into the read buffer on START, and writing the
+// seconds register restarts the 1 Hz countdown chain, like the chip does.
+class Ds3231 : public host::I2cDevice, public host::Device {
+public:
+  static const uint8_t REG_CONTROL = 0x0E;
+  static const uint8_t REG_STATUS = 0x0F;
+
+  Ds3231();
+
+  // Battery-backed state at power-on: a running clock (OSF clear)
+  void setTime(const DateTime& dt);
+  DateTime time() const;
+  // Oscillator error, + = fast
+  void setDriftPpm(double ppm) {
+    materialise();
+    driftPpm = ppm;
+  }
+  void setTemperature(float celsius);
+  // INT/SQW wired to this GPIO (-1 = not connected)
+  void connectInt(int pin);
+
+  uint8_t reg(uint8_t r) const;
+  bool intAsserted() const;
+  uint32_t timeWrites() const {
+    return adjustCount;
+  }
+  uint32_t alarmMatches(uint8_t alarm) const {
+    return matches[alarm == 1 ? 0 : 1];
+  }
+
+  void i2cStart(bool read) override;
+  void i2cReceive(uint8_t b) override;
+  uint8_t i2cTransmit() override;
+  void i2cStop() override;
+
+  uint64_t nextEventUs() const override;
+  void onEvent(uint64_t nowUs) override;
+
+private:
+  static const uint8_t REG_COUNT = 0x13;
+  uint8_t regs[REG_COUNT];
+  uint8_t pointer;
+  bool expectPointer;
+  bool timeWritten;
+  bool secondsWritten;
+
+  uint32_t baseSecs;  // seconds since 2000 at baseUs
+  uint64_t baseUs;
+  double driftPpm;
+  uint32_t lastTickSecs;  // last second the alarms were evaluated for
+
+  int intPin;
+  uint32_t adjustCount;
+  uint32_t matches[2];
+
+  uint32_t secondsAt(uint64_t us) const;
+  uint64_t usOfSecond(uint32_t secs) const;
+  void materialise();
+  void catchUp();
+  void loadFromRegisters(bool restartChain);
+  void checkAlarms(uint32_t secs);
+  void updateInt();
+};
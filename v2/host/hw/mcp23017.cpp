@@ -0,0 +1,52 @@
+#include "mcp23017.h"
+
+Mcp23017::Mcp23017()
+  : pointer(0), expectPointer(false), lastA(0xFF), lastB(0xFF), writes(0) {
+  for (uint8_t i = 0; i < REG_COUNT; i++) regs[i] = 0;
+  regs[IODIRA] = 0xFF;  // all inputs after power-on
+  regs[IODIRB] = 0xFF;
+}
+
+uint8_t Mcp23017::portA() const {
+  return (regs[OLATA] & ~regs[IODIRA]) | regs[IODIRA];
+}
+
+uint8_t Mcp23017::portB() const {
+  return (regs[OLATB] & ~regs[IODIRB]) | regs[IODIRB];
+}
+
+void Mcp23017::publish() {
+  uint8_t a = portA();
+  uint8_t b = portB();
+  if (a == lastA && b == lastB) return;
+  lastA = a;
+  lastB = b;
+  if (onOutputs) onOutputs(a, b);
+}
+
+void Mcp23017::i2cStart(bool read) {
+  expectPointer = !read;
+}
+
+void Mcp23017::i2cReceive(uint8_t b) {
+  if (expectPointer) {
+    pointer = b % REG_COUNT;
+    expectPointer = false;
+    return;
+  }
+  uint8_t r = pointer;
+  pointer = (pointer + 1) % REG_COUNT;
+  writes++;
+  if (r == GPIOA) r = OLATA;  // writing GPIO writes the latch
+  else if (r == GPIOB) r = OLATB;
+  regs[r] = b;
+  publish();
+}
+
+uint8_t Mcp23017::i2cTransmit() {
+  uint8_t r = pointer;
+  pointer = (pointer + 1) % REG_COUNT;
+  if (r == GPIOA) return portA();
+  if (r == GPIOB) return portB();
+  return regs[r];
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <functional>
+
+#include "host.h"
+
+// MCP23017 in its power-on configuration (IOCON.BANK = 0, sequential
+// addressing). Port A / B output levels are pushed to onOutputs after every
+// byte that changes them - GPA and GPB of one 3-byte OLAT write arrive one
+// I2C byte time apart, exactly as the panel sees them.
+class Mcp23017 : public host::I2cDevice {
+public:
+  static const uint8_t IODIRA = 0x00;
+  static const uint8_t IODIRB = 0x01;
+  static const uint8_t GPIOA = 0x12;
+  static const uint8_t GPIOB = 0x13;
+  static const uint8_t OLATA = 0x14;
+  static const uint8_t OLATB = 0x15;
+
+  std::function<void(uint8_t gpa, uint8_t gpb)> onOutputs;
+
+  Mcp23017();
+
+  uint8_t reg(uint8_t r) const {
+    return regs[r % REG_COUNT];
+  }
+  // Pin levels: OLAT where the pin is an output, pulled high where it's an input
+  uint8_t portA() const;
+  uint8_t portB() const;
+  uint32_t writeCount() const {
+    return writes;
+  }
+
+  void i2cStart(bool read) override;
+  void i2cReceive(uint8_t b) override;
+  uint8_t i2cTransmit() override;
+
+private:
+  static const uint8_t REG_COUNT = 0x16;
+  uint8_t regs[REG_COUNT];
+  uint8_t pointer;
+  bool expectPointer;
+  uint8_t lastA, lastB;
+  uint32_t writes;
+
+  void publish();
+};
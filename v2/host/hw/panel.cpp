@@ -0,0 +1,106 @@
+#include "panel.h"
+
+namespace {
+
+bool bit(uint8_t v, uint8_t n) {
+  return (v >> n) & 1;
+}
+
+// Board wiring: HDSP-2111
+const uint8_t HDSP_RST = 0, HDSP_A0 = 1, HDSP_A1 = 2, HDSP_A2 = 3, HDSP_WR = 4;
+uint8_t hdspData(uint8_t gpa, uint8_t gpb) {
+  return bit(gpa, 5) | bit(gpa, 6) << 1 | bit(gpa, 7) << 2 | bit(gpb, 0) << 3 | bit(gpb, 1) << 4 | bit(gpb, 2) << 5 |
+         bit(gpb, 3) << 6;
+}
+
+// Board wiring: 2x HDLY-2416
+const uint8_t HDLY_CE1_D1 = 0, HDLY_CLR = 1, HDLY_WR = 2, HDLY_A0 = 4, HDLY_A1 = 3, HDLY_CE1_D2 = 5, HDLY_BL = 5;
+uint8_t hdlyData(uint8_t gpa, uint8_t gpb) {
+  return bit(gpa, 6) | bit(gpa, 7) << 1 | bit(gpb, 0) << 2 | bit(gpb, 1) << 3 | bit(gpb, 4) << 4 | bit(gpb, 3) << 5 |
+         bit(gpb, 2) << 6;
+}
+
+}  // namespace
+
+DisplayPanel::DisplayPanel(Type type)
+  : panelType(type), blank(false), lastA(0xFF), lastB(0xFF), resetStartUs(0), writes(0),
+    resetCount(0), violationCount(0) {
+  for (int i = 0; i < 8; i++) ram[i] = '#';
+}
+
+std::string DisplayPanel::text() const {
+  return std::string(ram, 8);
+}
+
+void DisplayPanel::violation(const char* what) {
+  violationCount++;
+  violationText = what;
+}
+
+void DisplayPanel::clearRam() {
+  for (int i = 0; i < 8; i++) ram[i] = ' ';
+  resetCount++;
+  changed();
+}
+
+void DisplayPanel::changed() {
+  std::string t = text();
+  if (frames.empty() || frames.back().text != t) frames.push_back({ host::nowUs(), t });
+}
+
+void DisplayPanel::onPins(uint8_t gpa, uint8_t gpb) {
+  if (panelType == PANEL_HDSP2111) hdsp(gpa, gpb);
+  else hdly(gpa, gpb);
+  lastA = gpa;
+  lastB = gpb;
+}
+
+void DisplayPanel::hdsp(uint8_t gpa, uint8_t gpb) {
+  bool rst = bit(gpa, HDSP_RST), wasRst = bit(lastA, HDSP_RST);
+  if (!rst && wasRst) resetStartUs = host::nowUs();
+  if (rst && !wasRst) {
+    if (host::nowUs() - resetStartUs < HDSP_RESET_MIN_US) violation("HDSP RST# pulse too short");
+    else clearRam();
+  }
+
+  // While RST# is (or was, up to this very edge) low the chip ignores the
+  // bus - e.g. HDSPDisplay::begin() turning the ports to outputs before OLAT
+  bool inReset = !rst || !wasRst;
+  bool wr = bit(gpa, HDSP_WR), wasWr = bit(lastA, HDSP_WR);
+  if (wr && !wasWr) {
+    if (!rst) {
+      violation("HDSP write during reset");
+      return;
+    }
+    if (inReset) return;
+    uint8_t addr = bit(gpa, HDSP_A0) | bit(gpa, HDSP_A1) << 1 | bit(gpa, HDSP_A2) << 2;
+    ram[addr] = (char)hdspData(gpa, gpb);
+    writes++;
+    changed();
+  } else if (!inReset && !wr && !wasWr && ((gpa ^ lastA) & ~(1 << HDSP_WR) || gpb != lastB)) {
+    violation("HDSP address / data changed while WR# low");
+  }
+}
+
+void DisplayPanel::hdly(uint8_t gpa, uint8_t gpb) {
+  bool clr = bit(gpa, HDLY_CLR), wasClr = bit(lastA, HDLY_CLR);
+  if (!clr && wasClr) clearRam();
+
+  bool wasBlank = blank;
+  blank = !bit(gpb, HDLY_BL);
+  if (blank != wasBlank) changed();
+
+  bool wr = bit(gpa, HDLY_WR), wasWr = bit(lastA, HDLY_WR);
+  if (wr && !wasWr) {
+    uint8_t addr = bit(gpa, HDLY_A0) | bit(gpa, HDLY_A1) << 1;
+    char code = (char)hdlyData(gpa, gpb);
+    bool ce0 = !bit(gpa, HDLY_CE1_D1), ce1 = !bit(gpa, HDLY_CE1_D2);
+    if (ce0 && ce1) violation("HDLY write with both CE1# low");
+    if (ce0) ram[3 - addr] = code;
+    if (ce1) ram[7 - addr] = code;
+    if (ce0 || ce1) {
+      writes++;
+      changed();
+    }
+  }
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "host.h"
+
+// The 8-character LED panel behind the MCP23017, decoded from the port pins
+// with the board's wiring (see the bit maps in HDSPDisplay.h):
+//  - PANEL_HDSP2111: one 8-digit HDSP-2111, RST#, A0..A2, WR#+CE# common;
+//  - PANEL_HDLY2416: two 4-digit HDLY-2416, CE1# each, shared CLR# / WR# /
+//    A0..A1 / data, BL#; chip 0 is the left half, digit 3 leftmost.
+// A character is latched on the WR# rising edge. Character RAM powers up
+// as garbage (shown as '#') until a reset / clear blanks it.
+class DisplayPanel {
+public:
+  enum Type { PANEL_HDLY2416 = 0, PANEL_HDSP2111 = 1 };
+
+  // HDSP-2111 reset: RST# low for at least this long, writes ignored meanwhile
+  static const uint32_t HDSP_RESET_MIN_US = 110;
+
+  struct Frame {
+    uint64_t us;
+    std::string text;
+  };
+
+  explicit DisplayPanel(Type type);
+
+  // MCP23017 port levels changed (Mcp23017::onOutputs)
+  void onPins(uint8_t gpa, uint8_t gpb);
+
+  Type type() const {
+    return panelType;
+  }
+  // What a person would read, left to right ('#' = never written since power-on)
+  std::string text() const;
+  bool blanked() const {
+    return blank;
+  }
+  // Every change of text(), with the virtual time it happened
+  const std::vector<Frame>& history() const {
+    return frames;
+  }
+  void clearHistory() {
+    frames.clear();
+  }
+  // Characters latched, resets / clears seen, protocol violations
+  uint32_t charWrites() const {
+    return writes;
+  }
+  uint32_t resets() const {
+    return resetCount;
+  }
+  uint32_t violations() const {
+    return violationCount;
+  }
+  const std::string& lastViolation() const {
+    return violationText;
+  }
+
+private:
+  Type panelType;
+  char ram[8];
+  bool blank;
+  uint8_t lastA, lastB;  // port levels before this change (MCP23017 inputs float high)
+  uint64_t resetStartUs;
+  uint32_t writes, resetCount, violationCount;
+  std::string violationText;
+  std::vector<Frame> frames;
+
+  void violation(const char* what);
+  void clearRam();
+  void changed();
+  void hdsp(uint8_t gpa, uint8_t gpb);
+  void hdly(uint8_t gpa, uint8_t gpb);
+};
@@ -0,0 +1,215 @@
+#pragma once
+
+// Arduino-ESP32 (core 3.x) API subset used by the sketch, on the host's
+// virtual clock (host.h). Only what geni-code calls is here; signatures
+// follow the core so the sketch compiles unmodified.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <limits.h>
+#include <ctype.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+#include "esp_timer.h"
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH 0x1
+#define LOW 0x0
+
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define PULLUP 0x04
+#define INPUT_PULLUP 0x05
+#define PULLDOWN 0x08
+#define INPUT_PULLDOWN 0x09
+
+#define RISING 0x01
+#define FALLING 0x02
+#define CHANGE 0x03
+
+#define IRAM_ATTR
+#define ARDUINO_ISR_ATTR
+#define RTC_DATA_ATTR
+#define RTC_NOINIT_ATTR
+#define PROGMEM
+
+#define SERIAL_8N1 0x800001c
+
+#define PI 3.1415926535897932384626433832795
+#define HALF_PI 1.5707963267948966192313216916398
+#define TWO_PI 6.283185307179586476925286766559
+#define DEG_TO_RAD 0.017453292519943295769236907684886
+#define RAD_TO_DEG 57.295779513082320876798154814105
+#define radians(deg) ((deg) * DEG_TO_RAD)
+#define degrees(rad) ((rad) * RAD_TO_DEG)
+#define sq(x) ((x) * (x))
+
+using std::abs;
+using std::isinf;
+using std::isnan;
+using std::max;
+using std::min;
+
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void yield();
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+uint16_t analogRead(uint8_t pin);
+void analogReadResolution(uint8_t bits);
+
+#define digitalPinToInterrupt(p) ((p) < 22 ? (p) : -1)
+void attachInterrupt(uint8_t pin, void (*userFunc)(void), int mode);
+void detachInterrupt(uint8_t pin);
+
+// ADC continuous (DMA) mode - frames are flagged at the configured rate
+typedef struct {
+  uint8_t pin;
+  uint8_t channel;
+  int avg_read_raw;
+  int avg_read_mvolts;
+} adc_continuous_data_t;
+bool analogContinuous(const uint8_t pins[], size_t pins_count, uint32_t conversions_per_pin, uint32_t sampling_freq_hz,
+                      void (*userFunc)(void));
+bool analogContinuousRead(adc_continuous_data_t** buffer, uint32_t timeout_ms);
+bool analogContinuousStart();
+bool analogContinuousStop();
+bool analogContinuousDeinit();
+void analogContinuousSetWidth(uint8_t bits);
+
+// LEDC / tone - every frequency change lands in host::toneLog()
+bool ledcAttach(uint8_t pin, uint32_t freq, uint8_t resolution);
+uint32_t ledcWriteTone(uint8_t pin, uint32_t freq);
+void tone(uint8_t pin, unsigned int frequency, unsigned long duration = 0);
+void noTone(uint8_t pin);
+
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+long map(long x, long in_min, long in_max, long out_min, long out_max);
+template <class T, class L, class H>
+auto constrain(T amt, L low, H high) -> decltype(amt < low ? low : (amt > high ? high : amt)) {
+  return amt < low ? low : (amt > high ? high : amt);
+}
+
+// One core, no preemption on the host - the critical sections are no-ops
+typedef int portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED 0
+#define portENTER_CRITICAL(mux) (void)(mux)
+#define portEXIT_CRITICAL(mux) (void)(mux)
+#define portENTER_CRITICAL_ISR(mux) (void)(mux)
+#define portEXIT_CRITICAL_ISR(mux) (void)(mux)
+
+class String {
+private:
+  std::string s;
+
+public:
+  String() {}
+  String(const char* c)
+    : s(c ? c : "") {}
+  String(const std::string& str)
+    : s(str) {}
+  String(char c)
+    : s(1, c) {}
+  String(int v)
+    : s(std::to_string(v)) {}
+  String(unsigned int v)
+    : s(std::to_string(v)) {}
+  String(long v)
+    : s(std::to_string(v)) {}
+  String(unsigned long v)
+    : s(std::to_string(v)) {}
+
+  const char* c_str() const {
+    return s.c_str();
+  }
+  unsigned int length() const {
+    return s.size();
+  }
+  void toCharArray(char* buf, unsigned int bufsize, unsigned int index = 0) const {
+    if (!buf || bufsize == 0) return;
+    size_t n = index < s.size() ? std::min<size_t>(s.size() - index, bufsize - 1) : 0;
+    memcpy(buf, s.data() + index, n);
+    buf[n] = '\0';
+  }
+  String& operator+=(const String& o) {
+    s += o.s;
+    return *this;
+  }
+  bool operator==(const String& o) const {
+    return s == o.s;
+  }
+  bool operator!=(const String& o) const {
+    return s != o.s;
+  }
+  char operator[](unsigned int i) const {
+    return i < s.size() ? s[i] : '\0';
+  }
+  friend String operator+(const String& a, const String& b) {
+    return String(a.s + b.s);
+  }
+  friend String operator+(const char* a, const String& b) {
+    return String(std::string(a) + b.s);
+  }
+  friend String operator+(const String& a, const char* b) {
+    return String(a.s + b);
+  }
+};
+
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t* buffer, size_t size) {
+    size_t n = 0;
+    while (size--) n += write(*buffer++);
+    return n;
+  }
+  size_t write(const char* str) {
+    return str ? write((const uint8_t*)str, strlen(str)) : 0;
+  }
+
+  size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+  size_t print(const char* s) {
+    return write(s);
+  }
+  size_t print(const String& s) {
+    return write(s.c_str());
+  }
+  size_t print(char c) {
+    return write((uint8_t)c);
+  }
+  size_t print(int v) {
+    return print((long)v);
+  }
+  size_t print(unsigned int v) {
+    return print((unsigned long)v);
+  }
+  size_t print(long v);
+  size_t print(unsigned long v);
+  size_t print(double v, int digits = 2);
+  size_t println() {
+    return write("\r\n");
+  }
+  template <class T>
+  size_t println(const T& v) {
+    size_t n = print(v);
+    return n + println();
+  }
+};
+
+#include "HardwareSerial.h"
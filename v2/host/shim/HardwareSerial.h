@@ -0,0 +1,38 @@
+#pragma once
+
+#include "Arduino.h"
+
+// UART n: TX goes to host::serialOutput(n), RX comes from host::uartInject(n)
+class HardwareSerial : public Print {
+private:
+  int port;
+
+public:
+  explicit HardwareSerial(int uartNum)
+    : port(uartNum) {}
+
+  void begin(unsigned long baud, uint32_t config = SERIAL_8N1, int8_t rxPin = -1, int8_t txPin = -1,
+             bool invert = false, unsigned long timeoutMs = 20000UL) {
+    (void)baud, (void)config, (void)rxPin, (void)txPin, (void)invert, (void)timeoutMs;
+  }
+  void end() {}
+  size_t setRxBufferSize(size_t size) {
+    return size;
+  }
+
+  int available();
+  int peek();
+  int read();
+  void flush() {}
+
+  using Print::write;
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t* buffer, size_t size) override;
+
+  operator bool() const {
+    return true;
+  }
+};
+
+extern HardwareSerial Serial;
+extern HardwareSerial Serial1;
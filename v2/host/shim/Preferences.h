@@ -0,0 +1,98 @@
+#pragma once
+
+#include "Arduino.h"
+
+// Preferences over an in-memory NVS (host.h: nvsErase / nvsWriteCount).
+// The store outlives the object and host::reset(), like flash does a reboot.
+// A put of an identical value is not a flash write - ESP-IDF's nvs_set_*
+// compares before writing, and so does this.
+class Preferences {
+private:
+  std::string ns;
+  bool started;
+  bool readOnly;
+
+  size_t put(const char* key, char type, const void* value, size_t len);
+  bool get(const char* key, char type, void* value, size_t len) const;
+
+public:
+  Preferences()
+    : started(false), readOnly(false) {}
+
+  bool begin(const char* name, bool readOnly = false, const char* partition_label = nullptr);
+  void end();
+
+  bool clear();
+  bool remove(const char* key);
+  bool isKey(const char* key) const;
+
+  size_t putChar(const char* key, int8_t value) {
+    return put(key, 'c', &value, 1);
+  }
+  size_t putUChar(const char* key, uint8_t value) {
+    return put(key, 'C', &value, 1);
+  }
+  size_t putShort(const char* key, int16_t value) {
+    return put(key, 's', &value, 2);
+  }
+  size_t putUShort(const char* key, uint16_t value) {
+    return put(key, 'S', &value, 2);
+  }
+  size_t putInt(const char* key, int32_t value) {
+    return put(key, 'i', &value, 4);
+  }
+  size_t putUInt(const char* key, uint32_t value) {
+    return put(key, 'I', &value, 4);
+  }
+  size_t putLong(const char* key, int32_t value) {
+    return put(key, 'i', &value, 4);
+  }
+  size_t putULong(const char* key, uint32_t value) {
+    return put(key, 'I', &value, 4);
+  }
+  size_t putBool(const char* key, bool value) {
+    uint8_t v = value;
+    return put(key, 'C', &v, 1);
+  }
+  size_t putBytes(const char* key, const void* value, size_t len) {
+    return put(key, 'b', value, len);
+  }
+
+  int8_t getChar(const char* key, int8_t defaultValue = 0) const {
+    get(key, 'c', &defaultValue, 1);
+    return defaultValue;
+  }
+  uint8_t getUChar(const char* key, uint8_t defaultValue = 0) const {
+    get(key, 'C', &defaultValue, 1);
+    return defaultValue;
+  }
+  int16_t getShort(const char* key, int16_t defaultValue = 0) const {
+    get(key, 's', &defaultValue, 2);
+    return defaultValue;
+  }
+  uint16_t getUShort(const char* key, uint16_t defaultValue = 0) const {
+    get(key, 'S', &defaultValue, 2);
+    return defaultValue;
+  }
+  int32_t getInt(const char* key, int32_t defaultValue = 0) const {
+    get(key, 'i', &defaultValue, 4);
+    return defaultValue;
+  }
+  uint32_t getUInt(const char* key, uint32_t defaultValue = 0) const {
+    get(key, 'I', &defaultValue, 4);
+    return defaultValue;
+  }
+  int32_t getLong(const char* key, int32_t defaultValue = 0) const {
+    return getInt(key, defaultValue);
+  }
+  uint32_t getULong(const char* key, uint32_t defaultValue = 0) const {
+    return getUInt(key, defaultValue);
+  }
+  bool getBool(const char* key, bool defaultValue = false) const {
+    uint8_t v = defaultValue;
+    get(key, 'C', &v, 1);
+    return v != 0;
+  }
+  size_t getBytesLength(const char* key) const;
+  size_t getBytes(const char* key, void* buf, size_t maxLen) const;
+};
@@ -0,0 +1,182 @@
+#pragma once
+
+// TinyGPSPlus subset (RMC + GGA) with the library's parsing semantics:
+// term-by-term, XOR checksum, values committed only on a matching checksum,
+// date / time fields taken as raw numbers (no range check - a "999999"
+// date really comes out as month 99). Configure with
+// -DGENI_TINYGPSPLUS_DIR=<library>/src to build against the real one.
+
+#include "Arduino.h"
+
+#define _GPS_KMPH_PER_KNOT 1.852
+#define _GPS_MAX_FIELD_SIZE 15
+
+class TinyGPSPlus;
+
+class TinyGPSLocation {
+  friend class TinyGPSPlus;
+
+public:
+  bool isValid() const {
+    return valid;
+  }
+  bool isUpdated() const {
+    return updated;
+  }
+  uint32_t age() const {
+    return valid ? millis() - lastCommitTime : (uint32_t)ULONG_MAX;
+  }
+  double lat() {
+    updated = false;
+    return latDeg;
+  }
+  double lng() {
+    updated = false;
+    return lngDeg;
+  }
+
+private:
+  bool valid = false, updated = false;
+  double latDeg = 0, lngDeg = 0, newLat = 0, newLng = 0;
+  uint32_t lastCommitTime = 0;
+  void commit();
+  void setLatitude(const char* term);
+  void setLongitude(const char* term);
+};
+
+class TinyGPSDate {
+  friend class TinyGPSPlus;
+
+public:
+  bool isValid() const {
+    return valid;
+  }
+  bool isUpdated() const {
+    return updated;
+  }
+  uint32_t age() const {
+    return valid ? millis() - lastCommitTime : (uint32_t)ULONG_MAX;
+  }
+  uint32_t value() {
+    updated = false;
+    return date;
+  }
+  uint16_t year();
+  uint8_t month();
+  uint8_t day();
+
+private:
+  bool valid = false, updated = false;
+  uint32_t date = 0, newDate = 0;
+  uint32_t lastCommitTime = 0;
+  void commit();
+  void setDate(const char* term);
+};
+
+class TinyGPSTime {
+  friend class TinyGPSPlus;
+
+public:
+  bool isValid() const {
+    return valid;
+  }
+  bool isUpdated() const {
+    return updated;
+  }
+  uint32_t age() const {
+    return valid ? millis() - lastCommitTime : (uint32_t)ULONG_MAX;
+  }
+  uint32_t value() {
+    updated = false;
+    return time;
+  }
+  uint8_t hour();
+  uint8_t minute();
+  uint8_t second();
+  uint8_t centisecond();
+
+private:
+  bool valid = false, updated = false;
+  uint32_t time = 0, newTime = 0;
+  uint32_t lastCommitTime = 0;
+  void commit();
+  void setTime(const char* term);
+};
+
+class TinyGPSDecimal {
+  friend class TinyGPSPlus;
+
+public:
+  bool isValid() const {
+    return valid;
+  }
+  bool isUpdated() const {
+    return updated;
+  }
+  uint32_t age() const {
+    return valid ? millis() - lastCommitTime : (uint32_t)ULONG_MAX;
+  }
+  int32_t value() {
+    updated = false;
+    return val;
+  }
+
+protected:
+  bool valid = false, updated = false;
+  int32_t val = 0, newval = 0;
+  uint32_t lastCommitTime = 0;
+  void commit();
+  void set(const char* term);
+};
+
+class TinyGPSSpeed : public TinyGPSDecimal {
+public:
+  double knots() {
+    return value() / 100.0;
+  }
+  double kmph() {
+    return _GPS_KMPH_PER_KNOT * value() / 100.0;
+  }
+};
+
+class TinyGPSPlus {
+public:
+  TinyGPSPlus();
+  bool encode(char c);  // true = a sentence with a matching checksum just ended
+
+  TinyGPSLocation location;
+  TinyGPSDate date;
+  TinyGPSTime time;
+  TinyGPSSpeed speed;
+
+  uint32_t charsProcessed() const {
+    return encodedCharCount;
+  }
+  uint32_t sentencesWithFix() const {
+    return sentencesWithFixCount;
+  }
+  uint32_t failedChecksum() const {
+    return failedChecksumCount;
+  }
+  uint32_t passedChecksum() const {
+    return passedChecksumCount;
+  }
+
+private:
+  enum { GPS_SENTENCE_GGA, GPS_SENTENCE_RMC, GPS_SENTENCE_OTHER };
+
+  uint8_t parity;
+  bool isChecksumTerm;
+  char term[_GPS_MAX_FIELD_SIZE];
+  uint8_t curSentenceType;
+  uint8_t curTermNumber;
+  uint8_t curTermOffset;
+  bool sentenceHasFix;
+
+  uint32_t encodedCharCount;
+  uint32_t sentencesWithFixCount;
+  uint32_t failedChecksumCount;
+  uint32_t passedChecksumCount;
+
+  bool endOfTermHandler();
+};
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Arduino.h"
+
+// I2C master on the host bus (host::attachI2c). Transfers take bus time at
+// the configured clock - the virtual clock moves byte by byte, so a device
+// model sees e.g. an MCP23017's GPA and GPB update ~90 us apart at 100 kHz.
+class TwoWire {
+private:
+  uint32_t clockHz;
+  uint8_t txAddr;
+  bool txActive;
+  uint8_t txBuffer[128];
+  size_t txLength;
+  uint8_t rxBuffer[128];
+  size_t rxLength;
+  size_t rxIndex;
+
+public:
+  TwoWire();
+
+  bool begin(int sda = -1, int scl = -1, uint32_t frequency = 0);
+  bool end();
+  bool setClock(uint32_t frequency);
+  uint32_t getClock() const {
+    return clockHz;
+  }
+
+  void beginTransmission(uint8_t address);
+  void beginTransmission(int address) {
+    beginTransmission((uint8_t)address);
+  }
+  uint8_t endTransmission(bool sendStop = true);
+
+  size_t requestFrom(uint8_t address, size_t size, bool sendStop = true);
+  uint8_t requestFrom(int address, int size) {
+    return requestFrom((uint8_t)address, (size_t)size, true);
+  }
+
+  size_t write(uint8_t data);
+  size_t write(const uint8_t* data, size_t quantity);
+  int available();
+  int read();
+  int peek();
+  void flush() {}
+};
+
+extern TwoWire Wire;
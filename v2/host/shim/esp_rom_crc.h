@@ -0,0 +1,6 @@
+#pragma once
+
+#include <stdint.h>
+
+// Same as the ROM routine: CRC-32 (IEEE 802.3, reflected), crc = 0 to start
+uint32_t esp_rom_crc32_le(uint32_t crc, const uint8_t* buf, uint32_t len);
@@ -0,0 +1,563 @@
+// Virtual clock, esp_timer, GPIO / ADC, buzzer, UARTs and the small
+// Arduino core helpers. I2C lives in wire.cpp, NVS in preferences.cpp.
+
+#include "host.h"
+#include "Arduino.h"
+#include "esp_rom_crc.h"
+#include "soc/gpio_reg.h"
+
+#include <algorithm>
+#include <map>
+
+// ---- esp_timer ----
+
+struct esp_timer {
+  esp_timer_cb_t callback;
+  void* arg;
+  const char* name;
+  uint64_t deadlineUs;
+  uint64_t periodUs;  // 0 = one-shot
+  bool active;
+  bool deleted;
+};
+
+namespace {
+
+struct PinState {
+  int mode = -1;
+  int outputLevel = LOW;
+  bool driven = false;  // host::setPin() overrides the pull
+  int drivenLevel = HIGH;
+  int analogRaw = 0;
+  void (*isr)() = nullptr;
+  int isrMode = 0;
+  uint32_t toneFreq = 0;
+  uint64_t toneStopUs = UINT64_MAX;
+};
+
+struct Uart {
+  std::string output;
+  std::string rx;
+  uint32_t dropped = 0;
+};
+
+const size_t UART_RX_FIFO = 256;
+const int PIN_COUNT = 22;
+
+struct State {
+  uint64_t now = 0;
+  uint64_t busy = 0;
+  int blockDepth = 0;  // > 0 while inside delay() - that time is busy
+  std::vector<esp_timer*> timers;
+  std::vector<host::Device*> devices;
+  PinState pins[PIN_COUNT];
+  std::vector<host::ToneChange> toneLog;
+  Uart uarts[3];
+  bool echo = false;
+  uint32_t randomState = 1;
+
+  bool adcAvailable = true;
+  bool adcRunning = false;
+  std::vector<uint8_t> adcPins;
+  uint64_t adcFrameUs = 0;
+  uint64_t adcLastFrame = 0;
+  void (*adcIsr)() = nullptr;
+  adc_continuous_data_t adcFrame[8];
+};
+
+State& state() {
+  static State s;
+  return s;
+}
+
+PinState* pinAt(uint8_t pin) {
+  return pin < PIN_COUNT ? &state().pins[pin] : nullptr;
+}
+
+int pulledLevel(const PinState& p) {
+  if (p.driven) return p.drivenLevel;
+  if (p.mode == OUTPUT) return p.outputLevel;
+  return (p.mode == INPUT_PULLUP || p.mode == PULLUP) ? HIGH : LOW;
+}
+
+void recordTone(uint8_t pin, uint32_t freq) {
+  PinState* p = pinAt(pin);
+  if (!p || p->toneFreq == freq) return;
+  p->toneFreq = freq;
+  state().toneLog.push_back({ state().now, pin, freq });
+}
+
+// Earliest thing that has to happen while the clock runs
+uint64_t nextEvent() {
+  State& s = state();
+  uint64_t next = UINT64_MAX;
+  for (esp_timer* t : s.timers) {
+    if (t->active && t->deadlineUs < next) next = t->deadlineUs;
+  }
+  for (const PinState& p : s.pins) next = std::min(next, p.toneStopUs);
+  for (host::Device* d : s.devices) next = std::min(next, d->nextEventUs());
+  return next;
+}
+
+// Fire everything due at the current time, in deadline order
+void fireDue() {
+  State& s = state();
+  bool again = true;
+  while (again) {
+    again = false;
+    esp_timer* due = nullptr;
+    for (esp_timer* t : s.timers) {
+      if (t->active && t->deadlineUs <= s.now && (!due || t->deadlineUs < due->deadlineUs)) due = t;
+    }
+    if (due) {
+      if (due->periodUs) due->deadlineUs += due->periodUs;
+      else due->active = false;
+      due->callback(due->arg);
+      again = true;
+      continue;
+    }
+    for (uint8_t pin = 0; pin < PIN_COUNT; pin++) {
+      if (s.pins[pin].toneStopUs <= s.now) {
+        s.pins[pin].toneStopUs = UINT64_MAX;
+        recordTone(pin, 0);
+      }
+    }
+    for (size_t i = 0; i < s.devices.size(); i++) {
+      if (s.devices[i]->nextEventUs() <= s.now) {
+        s.devices[i]->onEvent(s.now);
+        again = true;
+      }
+    }
+  }
+
+  // ADC frames only set a flag - several due at once are one ISR call
+  if (s.adcRunning && s.adcFrameUs && s.now - s.adcLastFrame >= s.adcFrameUs) {
+    s.adcLastFrame = s.now - (s.now - s.adcLastFrame) % s.adcFrameUs;
+    if (s.adcIsr) s.adcIsr();
+  }
+}
+
+void block(uint64_t us) {
+  State& s = state();
+  s.busy += us;
+  s.blockDepth++;
+  host::advanceUs(us);
+  s.blockDepth--;
+}
+
+}  // namespace
+
+namespace host {
+
+void i2cReset();  // wire.cpp
+
+void reset(uint64_t startUs) {
+  State& s = state();
+  for (esp_timer* t : s.timers) t->deleted = true;  // handles may still be held by static objects
+  s.timers.clear();
+  s.devices.clear();
+  s.now = startUs;
+  s.busy = 0;
+  s.blockDepth = 0;
+  for (PinState& p : s.pins) p = PinState();
+  s.toneLog.clear();
+  for (Uart& u : s.uarts) u = Uart();
+  s.randomState = 1;
+  s.adcAvailable = true;
+  s.adcRunning = false;
+  s.adcPins.clear();
+  s.adcFrameUs = 0;
+  s.adcLastFrame = startUs;
+  s.adcIsr = nullptr;
+  const char* echo = getenv("GENI_HOST_SERIAL");
+  s.echo = echo && *echo == '1';
+  i2cReset();
+}
+
+uint64_t nowUs() {
+  return state().now;
+}
+
+void advanceToUs(uint64_t targetUs) {
+  State& s = state();
+  fireDue();
+  while (s.now < targetUs) {
+    uint64_t next = nextEvent();
+    s.now = next < targetUs ? next : targetUs;
+    fireDue();
+  }
+}
+
+void advanceUs(uint64_t us) {
+  advanceToUs(state().now + us);
+}
+
+uint64_t busyUs() {
+  return state().busy;
+}
+
+uint64_t nextDeadlineUs() {
+  return nextEvent();
+}
+
+void attachDevice(Device* device) {
+  state().devices.push_back(device);
+}
+
+void detachDevice(Device* device) {
+  std::vector<Device*>& d = state().devices;
+  d.erase(std::remove(d.begin(), d.end(), device), d.end());
+}
+
+void setPin(uint8_t pin, int level) {
+  PinState* p = pinAt(pin);
+  if (!p) return;
+  int before = pulledLevel(*p);
+  p->driven = true;
+  p->drivenLevel = level ? HIGH : LOW;
+  int after = pulledLevel(*p);
+  if (!p->isr || before == after) return;
+  bool rising = after == HIGH;
+  if (p->isrMode == CHANGE || (p->isrMode == RISING && rising) || (p->isrMode == FALLING && !rising)) p->isr();
+}
+
+void releasePin(uint8_t pin) {
+  PinState* p = pinAt(pin);
+  if (!p || !p->driven) return;
+  PinState released = *p;
+  released.driven = false;
+  setPin(pin, pulledLevel(released));
+  p->driven = false;
+}
+
+int pinLevel(uint8_t pin) {
+  PinState* p = pinAt(pin);
+  return p ? pulledLevel(*p) : LOW;
+}
+
+int pinMode(uint8_t pin) {
+  PinState* p = pinAt(pin);
+  return p ? p->mode : -1;
+}
+
+void setAnalog(uint8_t pin, int raw) {
+  PinState* p = pinAt(pin);
+  if (p) p->analogRaw = raw;
+}
+
+void setAdcContinuousAvailable(bool available) {
+  state().adcAvailable = available;
+}
+
+const std::vector<ToneChange>& toneLog() {
+  return state().toneLog;
+}
+
+void clearToneLog() {
+  state().toneLog.clear();
+}
+
+uint32_t currentTone(uint8_t pin) {
+  PinState* p = pinAt(pin);
+  return p ? p->toneFreq : 0;
+}
+
+std::string& serialOutput(int port) {
+  return state().uarts[port < 0 || port > 2 ? 0 : port].output;
+}
+
+void setSerialEcho(bool echo) {
+  state().echo = echo;
+}
+
+void uartInject(int port, const std::string& bytes) {
+  Uart& u = state().uarts[port < 0 || port > 2 ? 0 : port];
+  size_t room = u.rx.size() < UART_RX_FIFO ? UART_RX_FIFO - u.rx.size() : 0;
+  u.rx.append(bytes, 0, std::min(room, bytes.size()));
+  if (bytes.size() > room) u.dropped += bytes.size() - room;
+}
+
+size_t uartPending(int port) {
+  return state().uarts[port < 0 || port > 2 ? 0 : port].rx.size();
+}
+
+uint32_t uartDropped(int port) {
+  return state().uarts[port < 0 || port > 2 ? 0 : port].dropped;
+}
+
+}  // namespace host
+
+// ---- Arduino core ----
+
+unsigned long millis() {
+  return (unsigned long)(uint32_t)(state().now / 1000);
+}
+
+unsigned long micros() {
+  return (unsigned long)(uint32_t)state().now;
+}
+
+void delay(uint32_t ms) {
+  block((uint64_t)ms * 1000);
+}
+
+void delayMicroseconds(uint32_t us) {
+  block(us);
+}
+
+void yield() {}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  PinState* p = pinAt(pin);
+  if (p) p->mode = mode;
+}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+  PinState* p = pinAt(pin);
+  if (p) p->outputLevel = val ? HIGH : LOW;
+}
+
+int digitalRead(uint8_t pin) {
+  return host::pinLevel(pin);
+}
+
+uint32_t hostRegRead(uint32_t reg) {
+  if (reg != GPIO_IN_REG) return 0;
+  uint32_t levels = 0;
+  for (uint8_t pin = 0; pin < PIN_COUNT; pin++) {
+    if (host::pinLevel(pin) == HIGH) levels |= 1UL << pin;
+  }
+  return levels;
+}
+
+uint16_t analogRead(uint8_t pin) {
+  PinState* p = pinAt(pin);
+  return p ? (uint16_t)p->analogRaw : 0;
+}
+
+void analogReadResolution(uint8_t) {}
+
+void attachInterrupt(uint8_t pin, void (*userFunc)(void), int mode) {
+  PinState* p = pinAt(pin);
+  if (!p) return;
+  p->isr = userFunc;
+  p->isrMode = mode;
+}
+
+void detachInterrupt(uint8_t pin) {
+  PinState* p = pinAt(pin);
+  if (p) p->isr = nullptr;
+}
+
+bool analogContinuous(const uint8_t pins[], size_t pins_count, uint32_t conversions_per_pin, uint32_t sampling_freq_hz,
+                      void (*userFunc)(void)) {
+  State& s = state();
+  if (!s.adcAvailable || pins_count == 0 || pins_count > 8 || sampling_freq_hz == 0) return false;
+  s.adcPins.assign(pins, pins + pins_count);
+  s.adcFrameUs = (uint64_t)conversions_per_pin * pins_count * 1000000ULL / sampling_freq_hz;
+  s.adcIsr = userFunc;
+  return true;
+}
+
+bool analogContinuousStart() {
+  State& s = state();
+  if (s.adcFrameUs == 0) return false;
+  s.adcRunning = true;
+  s.adcLastFrame = s.now;
+  return true;
+}
+
+bool analogContinuousStop() {
+  state().adcRunning = false;
+  return true;
+}
+
+bool analogContinuousDeinit() {
+  State& s = state();
+  s.adcRunning = false;
+  s.adcFrameUs = 0;
+  return true;
+}
+
+void analogContinuousSetWidth(uint8_t) {}
+
+bool analogContinuousRead(adc_continuous_data_t** buffer, uint32_t) {
+  State& s = state();
+  if (!s.adcRunning) return false;
+  for (size_t i = 0; i < s.adcPins.size(); i++) {
+    s.adcFrame[i].pin = s.adcPins[i];
+    s.adcFrame[i].channel = i;
+    s.adcFrame[i].avg_read_raw = analogRead(s.adcPins[i]);
+    s.adcFrame[i].avg_read_mvolts = s.adcFrame[i].avg_read_raw * 3300 / 4095;
+  }
+  *buffer = s.adcFrame;
+  return true;
+}
+
+bool ledcAttach(uint8_t pin, uint32_t, uint8_t) {
+  return pinAt(pin) != nullptr;
+}
+
+uint32_t ledcWriteTone(uint8_t pin, uint32_t freq) {
+  recordTone(pin, freq);
+  return freq;
+}
+
+void tone(uint8_t pin, unsigned int frequency, unsigned long duration) {
+  PinState* p = pinAt(pin);
+  if (!p) return;
+  recordTone(pin, frequency);
+  p->toneStopUs = duration ? state().now + (uint64_t)duration * 1000 : UINT64_MAX;
+}
+
+void noTone(uint8_t pin) {
+  PinState* p = pinAt(pin);
+  if (!p) return;
+  p->toneStopUs = UINT64_MAX;
+  recordTone(pin, 0);
+}
+
+// Deterministic across runs (reset() reseeds) - the simulator relies on it
+long random(long howbig) {
+  if (howbig <= 0) return 0;
+  uint32_t& x = state().randomState;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  return x % howbig;
+}
+
+long random(long howsmall, long howbig) {
+  if (howsmall >= howbig) return howsmall;
+  return random(howbig - howsmall) + howsmall;
+}
+
+void randomSeed(unsigned long seed) {
+  if (seed != 0) state().randomState = seed;
+}
+
+long map(long x, long in_min, long in_max, long out_min, long out_max) {
+  const long run = in_max - in_min;
+  if (run == 0) return out_min;
+  return (x - in_min) * (out_max - out_min) / run + out_min;
+}
+
+// ---- esp_timer ----
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t* args, esp_timer_handle_t* out) {
+  if (!args || !args->callback || !out) return ESP_ERR_INVALID_ARG;
+  esp_timer* t = new esp_timer{ args->callback, args->arg, args->name, 0, 0, false, false };
+  state().timers.push_back(t);
+  *out = t;
+  return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us) {
+  if (!timer || timer->deleted) return ESP_ERR_INVALID_ARG;
+  if (timer->active) return ESP_ERR_INVALID_STATE;
+  timer->deadlineUs = state().now + timeout_us;
+  timer->periodUs = 0;
+  timer->active = true;
+  return ESP_OK;
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period) {
+  if (!timer || timer->deleted || period == 0) return ESP_ERR_INVALID_ARG;
+  if (timer->active) return ESP_ERR_INVALID_STATE;
+  timer->deadlineUs = state().now + period;
+  timer->periodUs = period;
+  timer->active = true;
+  return ESP_OK;
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer) {
+  if (!timer || timer->deleted) return ESP_ERR_INVALID_ARG;
+  if (!timer->active) return ESP_ERR_INVALID_STATE;
+  timer->active = false;
+  return ESP_OK;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t timer) {
+  if (!timer || timer->deleted) return ESP_ERR_INVALID_ARG;
+  std::vector<esp_timer*>& v = state().timers;
+  v.erase(std::remove(v.begin(), v.end(), timer), v.end());
+  delete timer;
+  return ESP_OK;
+}
+
+bool esp_timer_is_active(esp_timer_handle_t timer) {
+  return timer && !timer->deleted && timer->active;
+}
+
+int64_t esp_timer_get_time() {
+  return (int64_t)state().now;
+}
+
+uint32_t esp_rom_crc32_le(uint32_t crc, const uint8_t* buf, uint32_t len) {
+  crc = ~crc;
+  while (len--) {
+    crc ^= *buf++;
+    for (int k = 0; k < 8; k++) crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1)));
+  }
+  return ~crc;
+}
+
+// ---- Print / HardwareSerial ----
+
+size_t Print::printf(const char* format, ...) {
+  char small[256];
+  va_list args;
+  va_start(args, format);
+  int n = vsnprintf(small, sizeof(small), format, args);
+  va_end(args);
+  if (n < 0) return 0;
+  if ((size_t)n < sizeof(small)) return write((const uint8_t*)small, n);
+  std::string big(n + 1, '\0');
+  va_start(args, format);
+  vsnprintf(&big[0], big.size(), format, args);
+  va_end(args);
+  return write((const uint8_t*)big.data(), n);
+}
+
+size_t Print::print(long v) {
+  return printf("%ld", v);
+}
+
+size_t Print::print(unsigned long v) {
+  return printf("%lu", v);
+}
+
+size_t Print::print(double v, int digits) {
+  return printf("%.*f", digits, v);
+}
+
+HardwareSerial Serial(0);
+HardwareSerial Serial1(1);
+
+int HardwareSerial::available() {
+  return (int)host::uartPending(port);
+}
+
+int HardwareSerial::peek() {
+  std::string& rx = state().uarts[port].rx;
+  return rx.empty() ? -1 : (uint8_t)rx[0];
+}
+
+int HardwareSerial::read() {
+  std::string& rx = state().uarts[port].rx;
+  if (rx.empty()) return -1;
+  uint8_t c = rx[0];
+  rx.erase(0, 1);
+  return c;
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+  return write(&c, 1);
+}
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+  State& s = state();
+  s.uarts[port].output.append((const char*)buffer, size);
+  if (port == 0 && s.echo) fwrite(buffer, 1, size, stdout);
+  return size;
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+// Host-side control of the Arduino / ESP32 shims. Tests and the firmware
+// simulator include this; sketch code never does - it only sees the
+// Arduino.h / Wire.h / ... shims next to this file.
+//
+// unsigned long is 64 bits here, 32 on the ESP32: millis() / micros()
+// values wrap like the target's, but the sketch's "now - then" arithmetic
+// on them does not - wrap-around behaviour can't be tested on the host.
+//
+// Everything runs on one virtual clock. Nothing moves unless the test
+// advances it (advanceUs) or the sketch blocks (delay, delayMicroseconds,
+// I2C transfers) - the latter is also summed up as "busy" time. esp_timer
+// callbacks, tone() stops and device events (I2cDevice models, DS3231
+// alarms) fire at their exact deadlines while the clock passes them.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+namespace host {
+
+// ---- Virtual time ----
+
+// Power-on: time = startUs, pins / timers / tone log / serial / I2C bus
+// detached and cleared. NVS contents survive (see nvsErase()).
+void reset(uint64_t startUs = 0);
+
+uint64_t nowUs();
+void advanceUs(uint64_t us);
+void advanceToUs(uint64_t targetUs);
+// Time spent blocked in delay(), delayMicroseconds() and I2C transfers
+uint64_t busyUs();
+// Earliest pending esp_timer / tone stop / device event, UINT64_MAX if none
+uint64_t nextDeadlineUs();
+
+// Something with its own timeline (DS3231 alarms, ...), polled by the clock
+class Device {
+public:
+  virtual ~Device() {}
+  virtual uint64_t nextEventUs() const {
+    return UINT64_MAX;
+  }
+  virtual void onEvent(uint64_t nowUs) {
+    (void)nowUs;
+  }
+};
+void attachDevice(Device* device);
+void detachDevice(Device* device);
+
+// ---- GPIO / ADC ----
+
+// Drive an input from outside (button, RTC INT). Fires an attached ISR on a
+// matching edge, synchronously - like the real GPIO interrupt would.
+void setPin(uint8_t pin, int level);
+// Stop driving - the pin floats back to its pull-up / pull-down
+void releasePin(uint8_t pin);
+int pinLevel(uint8_t pin);
+int pinMode(uint8_t pin);  // -1 = never configured
+
+void setAnalog(uint8_t pin, int raw);
+// analogContinuous() succeeds (default) or fails -> sketches fall back to analogRead()
+void setAdcContinuousAvailable(bool available);
+
+// ---- Buzzer (ledcWriteTone / tone / noTone) ----
+
+struct ToneChange {
+  uint64_t us;
+  uint8_t pin;
+  uint32_t freq;  // 0 = silent
+};
+const std::vector<ToneChange>& toneLog();
+void clearToneLog();
+uint32_t currentTone(uint8_t pin);
+
+// ---- UARTs ----
+
+// Everything the sketch printed on Serial (port 0) / wrote to port n
+std::string& serialOutput(int port = 0);
+// Also copy port 0 output to stdout (GENI_HOST_SERIAL=1 in the environment does the same)
+void setSerialEcho(bool echo);
+// Bytes arriving on port n's RX line (the RX FIFO holds 256, the rest is dropped)
+void uartInject(int port, const std::string& bytes);
+size_t uartPending(int port);
+uint32_t uartDropped(int port);
+
+// ---- I2C bus (Wire) ----
+
+// One byte-level I2C slave. The bus calls these in transfer order, with the
+// virtual clock at the end of the byte in question.
+class I2cDevice {
+public:
+  virtual ~I2cDevice() {}
+  virtual void i2cStart(bool read) {
+    (void)read;
+  }
+  virtual void i2cReceive(uint8_t b) = 0;  // master wrote a byte
+  virtual uint8_t i2cTransmit() = 0;       // master reads a byte
+  virtual void i2cStop() {}
+};
+void attachI2c(uint8_t addr, I2cDevice* device);
+void detachI2c(uint8_t addr);
+
+// Every transaction on the bus, in order (endTransmission / requestFrom)
+struct I2cTransaction {
+  uint64_t startUs;
+  uint32_t busUs;
+  uint8_t addr;
+  bool read;
+  uint8_t status;  // endTransmission() result, 0 = ACK
+  std::vector<uint8_t> data;
+};
+const std::vector<I2cTransaction>& i2cLog();
+void clearI2cLog();
+void setI2cLogging(bool enabled);  // off: only the counters below are kept
+uint64_t i2cTransactionCount();
+uint64_t i2cByteCount();
+uint64_t i2cBusUs();
+
+// ---- NVS (Preferences) ----
+
+void nvsErase();
+uint32_t nvsWriteCount();    // put*() / remove() / clear() calls that reached flash
+uint64_t nvsBytesWritten();
+bool nvsHasKey(const char* ns, const char* key);
+
+}  // namespace host
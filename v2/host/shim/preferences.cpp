@@ -0,0 +1,118 @@
+// Preferences over an in-memory NVS that survives host::reset()
+
+#include "host.h"
+#include "Preferences.h"
+
+#include <map>
+
+namespace {
+
+struct Entry {
+  char type;
+  std::string bytes;
+};
+
+struct Nvs {
+  std::map<std::string, std::map<std::string, Entry>> namespaces;
+  uint32_t writes = 0;
+  uint64_t bytesWritten = 0;
+};
+
+Nvs& nvs() {
+  static Nvs n;
+  return n;
+}
+
+const size_t NVS_KEY_NAME_MAX = 15;
+
+}  // namespace
+
+namespace host {
+
+void nvsErase() {
+  nvs() = Nvs();
+}
+
+uint32_t nvsWriteCount() {
+  return nvs().writes;
+}
+
+uint64_t nvsBytesWritten() {
+  return nvs().bytesWritten;
+}
+
+bool nvsHasKey(const char* ns, const char* key) {
+  std::map<std::string, std::map<std::string, Entry>>::const_iterator n = nvs().namespaces.find(ns);
+  return n != nvs().namespaces.end() && n->second.count(key) > 0;
+}
+
+}  // namespace host
+
+bool Preferences::begin(const char* name, bool ro, const char*) {
+  if (started || !name || strlen(name) > NVS_KEY_NAME_MAX) return false;
+  ns = name;
+  readOnly = ro;
+  started = true;
+  if (!readOnly) nvs().namespaces[ns];
+  return true;
+}
+
+void Preferences::end() {
+  started = false;
+}
+
+bool Preferences::clear() {
+  if (!started || readOnly) return false;
+  nvs().namespaces[ns].clear();
+  nvs().writes++;
+  return true;
+}
+
+bool Preferences::remove(const char* key) {
+  if (!started || readOnly || !key) return false;
+  if (nvs().namespaces[ns].erase(key) == 0) return false;
+  nvs().writes++;
+  return true;
+}
+
+bool Preferences::isKey(const char* key) const {
+  return started && key && host::nvsHasKey(ns.c_str(), key);
+}
+
+size_t Preferences::put(const char* key, char type, const void* value, size_t len) {
+  if (!started || readOnly || !key || strlen(key) > NVS_KEY_NAME_MAX || (!value && len)) return 0;
+  Entry e{ type, std::string((const char*)value, len) };
+  std::map<std::string, Entry>& entries = nvs().namespaces[ns];
+  std::map<std::string, Entry>::iterator it = entries.find(key);
+  if (it != entries.end() && it->second.type == type && it->second.bytes == e.bytes) return len;
+  entries[key] = e;
+  nvs().writes++;
+  nvs().bytesWritten += len;
+  return len;
+}
+
+bool Preferences::get(const char* key, char type, void* value, size_t len) const {
+  if (!started || !key) return false;
+  std::map<std::string, std::map<std::string, Entry>>::const_iterator n = nvs().namespaces.find(ns);
+  if (n == nvs().namespaces.end()) return false;
+  std::map<std::string, Entry>::const_iterator it = n->second.find(key);
+  if (it == n->second.end() || it->second.type != type || it->second.bytes.size() != len) return false;
+  memcpy(value, it->second.bytes.data(), len);
+  return true;
+}
+
+size_t Preferences::getBytesLength(const char* key) const {
+  if (!started || !key) return 0;
+  std::map<std::string, std::map<std::string, Entry>>::const_iterator n = nvs().namespaces.find(ns);
+  if (n == nvs().namespaces.end()) return 0;
+  std::map<std::string, Entry>::const_iterator it = n->second.find(key);
+  return (it == n->second.end() || it->second.type != 'b') ? 0 : it->second.bytes.size();
+}
+
+size_t Preferences::getBytes(const char* key, void* buf, size_t maxLen) const {
+  size_t len = getBytesLength(key);
+  if (len == 0 || !buf || len > maxLen) return 0;
+  const Entry& e = nvs().namespaces.find(ns)->second.find(key)->second;
+  memcpy(buf, e.bytes.data(), len);
+  return len;
+}
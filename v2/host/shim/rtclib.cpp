@@ -0,0 +1,272 @@
+// RTClib DateTime / TimeSpan arithmetic and the RTC_DS3231 register access
+// sequence, over the host Wire bus
+
+#include "RTClib.h"
+
+namespace {
+
+const uint8_t DS3231_ADDRESS = 0x68;
+const uint8_t DS3231_TIME = 0x00;
+const uint8_t DS3231_ALARM1 = 0x07;
+const uint8_t DS3231_ALARM2 = 0x0B;
+const uint8_t DS3231_CONTROL = 0x0E;
+const uint8_t DS3231_STATUSREG = 0x0F;
+const uint8_t DS3231_TEMPERATUREREG = 0x11;
+
+const uint8_t daysInMonth[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30 };
+
+uint16_t date2days(uint16_t y, uint8_t m, uint8_t d) {
+  if (y >= 2000U) y -= 2000U;
+  uint16_t days = d;
+  for (uint8_t i = 1; i < m; ++i) days += daysInMonth[i - 1];
+  if (m > 2 && y % 4 == 0) ++days;
+  return days + 365 * y + (y + 3) / 4 - 1;
+}
+
+uint32_t time2ulong(uint16_t days, uint8_t h, uint8_t m, uint8_t s) {
+  return ((days * 24UL + h) * 60 + m) * 60 + s;
+}
+
+uint8_t bcd2bin(uint8_t val) {
+  return val - 6 * (val >> 4);
+}
+
+uint8_t bin2bcd(uint8_t val) {
+  return val + 6 * (val / 10);
+}
+
+uint8_t dowToDS3231(uint8_t d) {
+  return d == 0 ? 7 : d;
+}
+
+}  // namespace
+
+DateTime::DateTime(uint32_t t) {
+  t -= SECONDS_FROM_1970_TO_2000;  // wraps for t < 2000, as in the library
+  ss = t % 60;
+  t /= 60;
+  mm = t % 60;
+  t /= 60;
+  hh = t % 24;
+  uint16_t days = t / 24;
+  uint8_t leap;
+  for (yOff = 0;; ++yOff) {
+    leap = yOff % 4 == 0;
+    if (days < 365U + leap) break;
+    days -= 365 + leap;
+  }
+  for (m = 1; m < 12; ++m) {
+    uint8_t daysPerMonth = daysInMonth[m - 1];
+    if (leap && m == 2) ++daysPerMonth;
+    if (days < daysPerMonth) break;
+    days -= daysPerMonth;
+  }
+  d = days + 1;
+}
+
+DateTime::DateTime(uint16_t year, uint8_t month, uint8_t day, uint8_t hour, uint8_t min, uint8_t sec) {
+  if (year >= 2000U) year -= 2000U;
+  yOff = year;
+  m = month;
+  d = day;
+  hh = hour;
+  mm = min;
+  ss = sec;
+}
+
+DateTime::DateTime(const DateTime& copy)
+  : yOff(copy.yOff), m(copy.m), d(copy.d), hh(copy.hh), mm(copy.mm), ss(copy.ss) {}
+
+bool DateTime::isValid() const {
+  if (yOff >= 100) return false;
+  DateTime other(unixtime());
+  return yOff == other.yOff && m == other.m && d == other.d && hh == other.hh && mm == other.mm && ss == other.ss;
+}
+
+uint8_t DateTime::twelveHour() const {
+  if (hh == 0 || hh == 12) return 12;
+  return hh > 12 ? hh - 12 : hh;
+}
+
+uint8_t DateTime::dayOfTheWeek() const {
+  uint16_t day = date2days(yOff, m, d);
+  return (day + 6) % 7;  // Jan 1, 2000 is a Saturday
+}
+
+uint32_t DateTime::secondstime() const {
+  return time2ulong(date2days(yOff, m, d), hh, mm, ss);
+}
+
+uint32_t DateTime::unixtime() const {
+  return secondstime() + SECONDS_FROM_1970_TO_2000;
+}
+
+DateTime DateTime::operator+(const TimeSpan& span) const {
+  return DateTime(unixtime() + span.totalseconds());
+}
+
+DateTime DateTime::operator-(const TimeSpan& span) const {
+  return DateTime(unixtime() - span.totalseconds());
+}
+
+TimeSpan DateTime::operator-(const DateTime& right) const {
+  return TimeSpan(unixtime() - right.unixtime());
+}
+
+bool DateTime::operator<(const DateTime& right) const {
+  return unixtime() < right.unixtime();
+}
+
+bool DateTime::operator==(const DateTime& right) const {
+  return unixtime() == right.unixtime();
+}
+
+TimeSpan::TimeSpan(int32_t seconds)
+  : _seconds(seconds) {}
+
+TimeSpan::TimeSpan(int16_t days, int8_t hours, int8_t minutes, int8_t seconds)
+  : _seconds((int32_t)days * 86400L + (int32_t)hours * 3600 + (int32_t)minutes * 60 + seconds) {}
+
+// ---- RTC_DS3231 ----
+
+void RTC_DS3231::writeBytes(const uint8_t* bytes, size_t len) {
+  wire->beginTransmission(DS3231_ADDRESS);
+  wire->write(bytes, len);
+  wire->endTransmission();
+}
+
+// Register pointer write, repeated start, read
+void RTC_DS3231::readBytes(uint8_t reg, uint8_t* out, size_t len) {
+  wire->beginTransmission(DS3231_ADDRESS);
+  wire->write(reg);
+  wire->endTransmission(false);
+  wire->requestFrom(DS3231_ADDRESS, len);
+  for (size_t i = 0; i < len; i++) {
+    int b = wire->read();
+    out[i] = b < 0 ? 0xFF : (uint8_t)b;
+  }
+}
+
+uint8_t RTC_DS3231::readRegister(uint8_t reg) {
+  uint8_t value;
+  readBytes(reg, &value, 1);
+  return value;
+}
+
+void RTC_DS3231::writeRegister(uint8_t reg, uint8_t value) {
+  uint8_t bytes[2] = { reg, value };
+  writeBytes(bytes, 2);
+}
+
+bool RTC_DS3231::begin(TwoWire* wireInstance) {
+  wire = wireInstance;
+  wire->beginTransmission(DS3231_ADDRESS);
+  return wire->endTransmission() == 0;
+}
+
+void RTC_DS3231::adjust(const DateTime& dt) {
+  uint8_t buffer[8] = { DS3231_TIME,
+                        bin2bcd(dt.second()),
+                        bin2bcd(dt.minute()),
+                        bin2bcd(dt.hour()),
+                        bin2bcd(dowToDS3231(dt.dayOfTheWeek())),
+                        bin2bcd(dt.day()),
+                        bin2bcd(dt.month()),
+                        bin2bcd(dt.year() - 2000U) };
+  writeBytes(buffer, 8);
+  uint8_t statreg = readRegister(DS3231_STATUSREG);
+  statreg &= ~0x80;  // flip OSF bit
+  writeRegister(DS3231_STATUSREG, statreg);
+}
+
+bool RTC_DS3231::lostPower() {
+  return readRegister(DS3231_STATUSREG) >> 7;
+}
+
+DateTime RTC_DS3231::now() {
+  uint8_t buffer[7];
+  readBytes(DS3231_TIME, buffer, 7);
+  return DateTime(bcd2bin(buffer[6]) + 2000U, bcd2bin(buffer[5] & 0x7F), bcd2bin(buffer[4]), bcd2bin(buffer[2]),
+                  bcd2bin(buffer[1]), bcd2bin(buffer[0] & 0x7F));
+}
+
+Ds3231SqwPinMode RTC_DS3231::readSqwPinMode() {
+  int mode = readRegister(DS3231_CONTROL) & 0x1C;
+  if (mode & 0x04) mode = DS3231_OFF;
+  return (Ds3231SqwPinMode)mode;
+}
+
+void RTC_DS3231::writeSqwPinMode(Ds3231SqwPinMode mode) {
+  uint8_t ctrl = readRegister(DS3231_CONTROL);
+  ctrl &= ~0x04;  // turn off INTCON
+  ctrl &= ~0x18;  // set freq bits to 0
+  ctrl |= mode == DS3231_OFF ? 0x04 : mode;
+  writeRegister(DS3231_CONTROL, ctrl);
+}
+
+bool RTC_DS3231::setAlarm1(const DateTime& dt, Ds3231Alarm1Mode alarm_mode) {
+  uint8_t ctrl = readRegister(DS3231_CONTROL);
+  if (!(ctrl & 0x04)) return false;
+
+  uint8_t A1M1 = (alarm_mode & 0x01) << 7;   // Seconds bit 7
+  uint8_t A1M2 = (alarm_mode & 0x02) << 6;   // Minutes bit 7
+  uint8_t A1M3 = (alarm_mode & 0x04) << 5;   // Hour bit 7
+  uint8_t A1M4 = (alarm_mode & 0x08) << 4;   // Day/Date bit 7
+  uint8_t DY_DT = (alarm_mode & 0x10) << 2;  // Day/Date bit 6 - day of week when 1
+  uint8_t day = DY_DT ? dowToDS3231(dt.dayOfTheWeek()) : dt.day();
+  uint8_t buffer[5] = { DS3231_ALARM1, uint8_t(bin2bcd(dt.second()) | A1M1), uint8_t(bin2bcd(dt.minute()) | A1M2),
+                        uint8_t(bin2bcd(dt.hour()) | A1M3), uint8_t(bin2bcd(day) | A1M4 | DY_DT) };
+  writeBytes(buffer, 5);
+  writeRegister(DS3231_CONTROL, ctrl | 0x01);  // AI1E
+  return true;
+}
+
+bool RTC_DS3231::setAlarm2(const DateTime& dt, Ds3231Alarm2Mode alarm_mode) {
+  uint8_t ctrl = readRegister(DS3231_CONTROL);
+  if (!(ctrl & 0x04)) return false;
+
+  uint8_t A2M2 = (alarm_mode & 0x01) << 7;  // Minutes bit 7
+  uint8_t A2M3 = (alarm_mode & 0x02) << 6;  // Hour bit 7
+  uint8_t A2M4 = (alarm_mode & 0x04) << 5;  // Day/Date bit 7
+  uint8_t DY_DT = (alarm_mode & 0x08) << 3; // Day/Date bit 6
+  uint8_t day = DY_DT ? dowToDS3231(dt.dayOfTheWeek()) : dt.day();
+  uint8_t buffer[4] = { DS3231_ALARM2, uint8_t(bin2bcd(dt.minute()) | A2M2), uint8_t(bin2bcd(dt.hour()) | A2M3),
+                        uint8_t(bin2bcd(day) | A2M4 | DY_DT) };
+  writeBytes(buffer, 4);
+  writeRegister(DS3231_CONTROL, ctrl | 0x02);  // AI2E
+  return true;
+}
+
+void RTC_DS3231::disableAlarm(uint8_t alarm_num) {
+  uint8_t ctrl = readRegister(DS3231_CONTROL);
+  ctrl &= ~(1 << (alarm_num - 1));
+  writeRegister(DS3231_CONTROL, ctrl);
+}
+
+void RTC_DS3231::clearAlarm(uint8_t alarm_num) {
+  uint8_t status = readRegister(DS3231_STATUSREG);
+  status &= ~(0x1 << (alarm_num - 1));
+  writeRegister(DS3231_STATUSREG, status);
+}
+
+bool RTC_DS3231::alarmFired(uint8_t alarm_num) {
+  return (readRegister(DS3231_STATUSREG) >> (alarm_num - 1)) & 0x1;
+}
+
+void RTC_DS3231::enable32K() {
+  writeRegister(DS3231_STATUSREG, readRegister(DS3231_STATUSREG) | 0x08);
+}
+
+void RTC_DS3231::disable32K() {
+  writeRegister(DS3231_STATUSREG, readRegister(DS3231_STATUSREG) & ~0x08);
+}
+
+bool RTC_DS3231::isEnabled32K() {
+  return (readRegister(DS3231_STATUSREG) >> 3) & 0x01;
+}
+
+float RTC_DS3231::getTemperature() {
+  uint8_t buffer[2];
+  readBytes(DS3231_TEMPERATUREREG, buffer, 2);
+  return (float)(int8_t)buffer[0] + (buffer[1] >> 6) * 0.25f;
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+// ESP32-C3 GPIO input register on the host: REG_READ(GPIO_IN_REG) returns
+// the virtual pin levels, bit n = GPIO n
+
+#include <stdint.h>
+
+#define DR_REG_GPIO_BASE 0x60004000
+#define GPIO_IN_REG (DR_REG_GPIO_BASE + 0x3c)
+
+uint32_t hostRegRead(uint32_t reg);
+#define REG_READ(reg) hostRegRead(reg)
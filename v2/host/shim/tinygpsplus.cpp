@@ -0,0 +1,234 @@
+// TinyGPSPlus RMC / GGA parsing, same term handling as the library
+
+#include "TinyGPSPlus.h"
+
+namespace {
+
+int fromHex(char a) {
+  if (a >= 'A' && a <= 'F') return a - 'A' + 10;
+  if (a >= 'a' && a <= 'f') return a - 'a' + 10;
+  return a - '0';
+}
+
+// "123.45" -> 12345 (two implied decimals), like TinyGPSPlus::parseDecimal
+int32_t parseDecimal(const char* term) {
+  bool negative = *term == '-';
+  if (negative) ++term;
+  int32_t ret = 100 * (int32_t)atol(term);
+  while (isdigit((unsigned char)*term)) ++term;
+  if (*term == '.' && isdigit((unsigned char)term[1])) {
+    ret += 10 * (term[1] - '0');
+    if (isdigit((unsigned char)term[2])) ret += term[2] - '0';
+  }
+  return negative ? -ret : ret;
+}
+
+// "4717.1234" -> 47 + 17.1234 / 60
+double parseDegrees(const char* term) {
+  uint32_t leftOfDecimal = (uint32_t)atol(term);
+  uint16_t minutes = (uint16_t)(leftOfDecimal % 100);
+  uint32_t multiplier = 10000000UL;
+  uint32_t tenMillionthsOfMinutes = minutes * multiplier;
+  uint16_t deg = (int16_t)(leftOfDecimal / 100);
+  while (isdigit((unsigned char)*term)) ++term;
+  if (*term == '.') {
+    while (isdigit((unsigned char)*++term)) {
+      multiplier /= 10;
+      tenMillionthsOfMinutes += (*term - '0') * multiplier;
+    }
+  }
+  return deg + (5 * tenMillionthsOfMinutes + 1) / 3 / 1000000000.0;
+}
+
+bool sentenceIs(const char* term, const char* type) {
+  // GP (GPS only) and GN (multi-constellation) talkers
+  return (term[0] == 'G' && (term[1] == 'P' || term[1] == 'N')) && strcmp(term + 2, type) == 0;
+}
+
+}  // namespace
+
+void TinyGPSLocation::commit() {
+  latDeg = newLat;
+  lngDeg = newLng;
+  lastCommitTime = millis();
+  valid = updated = true;
+}
+
+void TinyGPSLocation::setLatitude(const char* term) {
+  newLat = parseDegrees(term);
+}
+
+void TinyGPSLocation::setLongitude(const char* term) {
+  newLng = parseDegrees(term);
+}
+
+void TinyGPSDate::commit() {
+  date = newDate;
+  lastCommitTime = millis();
+  valid = updated = true;
+}
+
+void TinyGPSDate::setDate(const char* term) {
+  newDate = (uint32_t)atol(term);
+}
+
+uint16_t TinyGPSDate::year() {
+  updated = false;
+  uint16_t year = date % 100;
+  return year + 2000;
+}
+
+uint8_t TinyGPSDate::month() {
+  updated = false;
+  return (date / 100) % 100;
+}
+
+uint8_t TinyGPSDate::day() {
+  updated = false;
+  return date / 10000;
+}
+
+void TinyGPSTime::commit() {
+  time = newTime;
+  lastCommitTime = millis();
+  valid = updated = true;
+}
+
+void TinyGPSTime::setTime(const char* term) {
+  newTime = (uint32_t)parseDecimal(term);
+}
+
+uint8_t TinyGPSTime::hour() {
+  updated = false;
+  return time / 1000000;
+}
+
+uint8_t TinyGPSTime::minute() {
+  updated = false;
+  return (time / 10000) % 100;
+}
+
+uint8_t TinyGPSTime::second() {
+  updated = false;
+  return (time / 100) % 100;
+}
+
+uint8_t TinyGPSTime::centisecond() {
+  updated = false;
+  return time % 100;
+}
+
+void TinyGPSDecimal::commit() {
+  val = newval;
+  lastCommitTime = millis();
+  valid = updated = true;
+}
+
+void TinyGPSDecimal::set(const char* term) {
+  newval = parseDecimal(term);
+}
+
+TinyGPSPlus::TinyGPSPlus()
+  : parity(0), isChecksumTerm(false), curSentenceType(GPS_SENTENCE_OTHER), curTermNumber(0), curTermOffset(0),
+    sentenceHasFix(false), encodedCharCount(0), sentencesWithFixCount(0), failedChecksumCount(0),
+    passedChecksumCount(0) {
+  term[0] = '\0';
+}
+
+bool TinyGPSPlus::encode(char c) {
+  ++encodedCharCount;
+
+  switch (c) {
+    case ',':  // term terminators
+      parity ^= (uint8_t)c;
+      // fall through
+    case '\r':
+    case '\n':
+    case '*': {
+      bool isValidSentence = false;
+      if (curTermOffset < sizeof(term)) {
+        term[curTermOffset] = 0;
+        isValidSentence = endOfTermHandler();
+      }
+      ++curTermNumber;
+      curTermOffset = 0;
+      isChecksumTerm = c == '*';
+      return isValidSentence;
+    }
+
+    case '$':  // sentence begin
+      curTermNumber = curTermOffset = 0;
+      parity = 0;
+      curSentenceType = GPS_SENTENCE_OTHER;
+      isChecksumTerm = false;
+      sentenceHasFix = false;
+      return false;
+
+    default:  // ordinary characters
+      if (curTermOffset < sizeof(term) - 1) term[curTermOffset++] = c;
+      if (!isChecksumTerm) parity ^= c;
+      return false;
+  }
+}
+
+bool TinyGPSPlus::endOfTermHandler() {
+  // Sentence end: commit what was parsed if the checksum matches
+  if (isChecksumTerm) {
+    uint8_t checksum = 16 * fromHex(term[0]) + fromHex(term[1]);
+    if (checksum != parity) {
+      ++failedChecksumCount;
+      return false;
+    }
+    passedChecksumCount++;
+    if (sentenceHasFix) ++sentencesWithFixCount;
+
+    switch (curSentenceType) {
+      case GPS_SENTENCE_RMC:
+        date.commit();
+        time.commit();
+        if (sentenceHasFix) {
+          location.commit();
+          speed.commit();
+        }
+        break;
+      case GPS_SENTENCE_GGA:
+        time.commit();
+        if (sentenceHasFix) location.commit();
+        break;
+    }
+    return true;
+  }
+
+  if (curTermNumber == 0) {
+    if (sentenceIs(term, "RMC")) curSentenceType = GPS_SENTENCE_RMC;
+    else if (sentenceIs(term, "GGA")) curSentenceType = GPS_SENTENCE_GGA;
+    else curSentenceType = GPS_SENTENCE_OTHER;
+    return false;
+  }
+
+  if (curSentenceType != GPS_SENTENCE_OTHER && term[0]) {
+    if (curSentenceType == GPS_SENTENCE_RMC) {
+      switch (curTermNumber) {
+        case 1: time.setTime(term); break;
+        case 2: sentenceHasFix = term[0] == 'A'; break;
+        case 3: location.setLatitude(term); break;
+        case 4: if (term[0] == 'S') location.newLat = -location.newLat; break;
+        case 5: location.setLongitude(term); break;
+        case 6: if (term[0] == 'W') location.newLng = -location.newLng; break;
+        case 7: speed.set(term); break;
+        case 9: date.setDate(term); break;
+      }
+    } else {
+      switch (curTermNumber) {
+        case 1: time.setTime(term); break;
+        case 2: location.setLatitude(term); break;
+        case 3: if (term[0] == 'S') location.newLat = -location.newLat; break;
+        case 4: location.setLongitude(term); break;
+        case 5: if (term[0] == 'W') location.newLng = -location.newLng; break;
+        case 6: sentenceHasFix = term[0] > '0'; break;
+      }
+    }
+  }
+  return false;
+}
+
@@ -0,0 +1,207 @@
+// I2C master shim + the host bus: byte-level device models, transaction log,
+// bus time on the virtual clock
+
+#include "host.h"
+#include "Wire.h"
+
+#include <map>
+
+namespace {
+
+struct Bus {
+  std::map<uint8_t, host::I2cDevice*> devices;
+  std::vector<host::I2cTransaction> log;
+  bool logging = true;
+  uint64_t transactions = 0;
+  uint64_t bytes = 0;
+  uint64_t busUs = 0;
+};
+
+Bus& bus() {
+  static Bus b;
+  return b;
+}
+
+// Clock stretching aside, every bit is one SCL period; START + address
+// byte + data bytes (8 bits + ACK each) + STOP
+uint64_t bitsUs(uint32_t clockHz, uint32_t bits) {
+  return ((uint64_t)bits * 1000000ULL + clockHz - 1) / clockHz;
+}
+
+void blockFor(uint64_t us, uint64_t& total) {
+  delayMicroseconds((uint32_t)us);  // counts as busy, fires timers in between
+  total += us;
+}
+
+host::I2cDevice* deviceAt(uint8_t addr) {
+  std::map<uint8_t, host::I2cDevice*>::iterator it = bus().devices.find(addr);
+  return it == bus().devices.end() ? nullptr : it->second;
+}
+
+void logTransaction(uint64_t startUs, uint64_t us, uint8_t addr, bool read, uint8_t status, const uint8_t* data,
+                    size_t len) {
+  Bus& b = bus();
+  b.transactions++;
+  b.bytes += len;
+  b.busUs += us;
+  if (!b.logging) return;
+  host::I2cTransaction t;
+  t.startUs = startUs;
+  t.busUs = (uint32_t)us;
+  t.addr = addr;
+  t.read = read;
+  t.status = status;
+  t.data.assign(data, data + len);
+  b.log.push_back(t);
+}
+
+}  // namespace
+
+namespace host {
+
+void i2cReset() {
+  Bus& b = bus();
+  b.devices.clear();
+  b.log.clear();
+  b.logging = true;
+  b.transactions = 0;
+  b.bytes = 0;
+  b.busUs = 0;
+  Wire.end();
+}
+
+void attachI2c(uint8_t addr, I2cDevice* device) {
+  bus().devices[addr] = device;
+}
+
+void detachI2c(uint8_t addr) {
+  bus().devices.erase(addr);
+}
+
+const std::vector<I2cTransaction>& i2cLog() {
+  return bus().log;
+}
+
+void clearI2cLog() {
+  bus().log.clear();
+}
+
+void setI2cLogging(bool enabled) {
+  bus().logging = enabled;
+}
+
+uint64_t i2cTransactionCount() {
+  return bus().transactions;
+}
+
+uint64_t i2cByteCount() {
+  return bus().bytes;
+}
+
+uint64_t i2cBusUs() {
+  return bus().busUs;
+}
+
+}  // namespace host
+
+TwoWire Wire;
+
+TwoWire::TwoWire()
+  : clockHz(100000), txAddr(0), txActive(false), txLength(0), rxLength(0), rxIndex(0) {}
+
+bool TwoWire::begin(int, int, uint32_t frequency) {
+  clockHz = frequency ? frequency : 100000;
+  return true;
+}
+
+bool TwoWire::end() {
+  clockHz = 100000;
+  txActive = false;
+  txLength = rxLength = rxIndex = 0;
+  return true;
+}
+
+bool TwoWire::setClock(uint32_t frequency) {
+  if (frequency == 0) return false;
+  clockHz = frequency;
+  return true;
+}
+
+void TwoWire::beginTransmission(uint8_t address) {
+  txAddr = address;
+  txActive = true;
+  txLength = 0;
+}
+
+size_t TwoWire::write(uint8_t data) {
+  if (!txActive || txLength >= sizeof(txBuffer)) return 0;
+  txBuffer[txLength++] = data;
+  return 1;
+}
+
+size_t TwoWire::write(const uint8_t* data, size_t quantity) {
+  size_t n = 0;
+  while (n < quantity && write(data[n])) n++;
+  return n;
+}
+
+// 0 = ACK, 2 = address NACK (nothing at that address), 5 = not begun
+uint8_t TwoWire::endTransmission(bool sendStop) {
+  if (!txActive) return 5;
+  txActive = false;
+  uint64_t startUs = host::nowUs();
+  uint64_t spent = 0;
+  host::I2cDevice* dev = deviceAt(txAddr);
+
+  blockFor(bitsUs(clockHz, 1 + 9), spent);  // START + address
+  uint8_t status = 0;
+  if (!dev) {
+    status = 2;
+  } else {
+    dev->i2cStart(false);
+    for (size_t i = 0; i < txLength; i++) {
+      blockFor(bitsUs(clockHz, 9), spent);
+      dev->i2cReceive(txBuffer[i]);
+    }
+  }
+  if (sendStop || status) {
+    blockFor(bitsUs(clockHz, 1), spent);
+    if (dev) dev->i2cStop();
+  }
+  logTransaction(startUs, spent, txAddr, false, status, txBuffer, status ? 0 : txLength);
+  return status;
+}
+
+size_t TwoWire::requestFrom(uint8_t address, size_t size, bool sendStop) {
+  rxLength = rxIndex = 0;
+  if (size > sizeof(rxBuffer)) size = sizeof(rxBuffer);
+  uint64_t startUs = host::nowUs();
+  uint64_t spent = 0;
+  host::I2cDevice* dev = deviceAt(address);
+
+  blockFor(bitsUs(clockHz, 1 + 9), spent);
+  if (dev) {
+    dev->i2cStart(true);
+    for (size_t i = 0; i < size; i++) {
+      blockFor(bitsUs(clockHz, 9), spent);
+      rxBuffer[rxLength++] = dev->i2cTransmit();
+    }
+  }
+  (void)sendStop;  // a read always ends with NACK + STOP on this bus
+  blockFor(bitsUs(clockHz, 1), spent);
+  if (dev) dev->i2cStop();
+  logTransaction(startUs, spent, address, true, dev ? 0 : 2, rxBuffer, rxLength);
+  return rxLength;
+}
+
+int TwoWire::available() {
+  return (int)(rxLength - rxIndex);
+}
+
+int TwoWire::read() {
+  return rxIndex < rxLength ? rxBuffer[rxIndex++] : -1;
+}
+
+int TwoWire::peek() {
+  return rxIndex < rxLength ? rxBuffer[rxIndex] : -1;
+}
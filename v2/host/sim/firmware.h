@@ -0,0 +1,228 @@
+#pragma once
+
+// The whole sketch (setup() / loop() and its globals) on the board models:
+// MCP23017 -> LED panel, DS3231 with INT wired to GPIO10, joystick resting
+// in its centre, JS button released. Include this from exactly one .cpp -
+// it pulls in the generated geni-code.ino.cpp, so one process boots once.
+//
+// Only the board (board:: below) is fixed here, not the sketch's constants,
+// so older sketch trees build too (GENI_SKETCH_DIR) for before/after runs.
+//
+//   Firmware fw(DisplayPanel::PANEL_HDSP2111);
+//   fw.rtc.setTime(DateTime(2025, 5, 1, 12, 0, 0));
+//   fw.powerOn();
+//   fw.runForMs(5000);
+//   fw.panel.text();
+
+#include <functional>
+#include <vector>
+
+#include "host.h"
+#include "mcp23017.h"
+#include "panel.h"
+#include "ds3231.h"
+
+#include "geni-code.ino.cpp"
+
+// The PCB: I2C addresses and GPIOs as wired
+namespace board {
+const uint8_t MCP_ADDR = 0x20;
+const uint8_t RTC_ADDR = 0x68;
+const uint8_t RTC_INT = 10;
+const uint8_t JS_X = 1;
+const uint8_t JS_Y = 2;
+const uint8_t JS_SW = 3;
+const uint8_t BUZZER = 6;
+const int JS_X_CENTER = 3250;  // raw ADC of this stick at rest
+const int JS_Y_CENTER = 3500;
+}  // namespace board
+
+// Something that watches / pokes the board every periodUs of virtual time,
+// also while setup() or loop() is blocked in delay() - a scripted user
+class Poller : public host::Device {
+public:
+  Poller(uint64_t periodUs, std::function<void(uint64_t nowUs)> fn)
+    : period(periodUs), next(host::nowUs() + periodUs), poll(fn) {}
+  uint64_t nextEventUs() const override {
+    return next;
+  }
+  void onEvent(uint64_t nowUs) override {
+    next = nowUs + period;
+    poll(nowUs);
+  }
+
+private:
+  uint64_t period, next;
+  std::function<void(uint64_t)> poll;
+};
+
+class Firmware {
+public:
+  Mcp23017 mcp;
+  DisplayPanel panel;
+  Ds3231 rtc;
+
+  // Longest virtual step while loop() is idle (nothing blocked, no timer
+  // or device event due). 1 ms spins like the real loop; day-long runs
+  // raise it - the sketch's millis() intervals then fire up to this late.
+  uint64_t idleStepUs = 1000;
+
+  // Called before every loop() with the virtual time - scripted input goes here
+  std::function<void(uint64_t nowUs)> beforeLoop;
+
+  explicit Firmware(DisplayPanel::Type type, bool storeClockType = true)
+    : panel(type), storedType(storeClockType) {
+    mcp.onOutputs = [this](uint8_t gpa, uint8_t gpb) {
+      panel.onPins(gpa, gpb);
+    };
+  }
+
+  // Power the board up and run setup(). The panel type is stored in NVS
+  // beforehand unless the constructor was told otherwise (first boot ->
+  // display type setup screen).
+  void powerOn(uint64_t startUs = 0) {
+    host::reset(startUs);
+    if (storedType) storeClockType();
+    host::attachI2c(board::MCP_ADDR, &mcp);
+    host::attachI2c(board::RTC_ADDR, &rtc);
+    host::attachDevice(&rtc);
+    for (host::Device* device : extraDevices) host::attachDevice(device);
+    rtc.connectInt(board::RTC_INT);
+    centreJoystick();
+    host::releasePin(board::JS_SW);
+    bootNvsWrites = host::nvsWriteCount();
+    setup();
+    loops = 0;
+    loopBusyUs = 0;
+  }
+
+  // Attached again on every powerOn() (which resets the device list), so
+  // it already runs while setup() blocks
+  void addDevice(host::Device* device) {
+    extraDevices.push_back(device);
+    host::attachDevice(device);
+  }
+
+  // One pass of loop(). If it blocked, the clock already moved - poll again
+  // straight away; otherwise move on to the next timer / device deadline,
+  // at most idleStepUs.
+  void step() {
+    if (beforeLoop) beforeLoop(host::nowUs());
+    uint64_t before = host::nowUs();
+    loop();
+    loops++;
+    uint64_t spent = host::nowUs() - before;
+    loopBusyUs += spent;
+    if (spent) return;
+    uint64_t next = host::nextDeadlineUs();
+    uint64_t cap = host::nowUs() + idleStepUs;
+    host::advanceToUs(next > host::nowUs() && next < cap ? next : cap);
+  }
+
+  void runUntilUs(uint64_t targetUs) {
+    while (host::nowUs() < targetUs) step();
+  }
+  void runForMs(uint64_t ms) {
+    runUntilUs(host::nowUs() + ms * 1000);
+  }
+  // Run until pred() holds or timeoutMs passes; true if it held
+  bool runUntil(const std::function<bool()>& pred, uint64_t timeoutMs) {
+    uint64_t end = host::nowUs() + timeoutMs * 1000;
+    while (!pred()) {
+      if (host::nowUs() >= end) return false;
+      step();
+    }
+    return true;
+  }
+
+  // ---- Inputs ----
+
+#if __has_include("settings.h")
+  // Before powerOn(): an enabled daily alarm in slot 'index', as if set in ALARM mode
+  static void storeAlarm(byte index, uint8_t hour, uint8_t minute, uint8_t days = ALARM_DAYS_DAILY) {
+    Preferences prefs;
+    prefs.begin("geniClock", false);
+    Settings stored;
+    stored.begin(&prefs, DEFAULT_ALARM_TUNE, DEFAULT_CHIME_TUNE);
+    AlarmSlot slot = stored.get().alarms[index];
+    slot.hour = hour;
+    slot.minute = minute;
+    slot.days = days;
+    slot.enabled = 1;
+    stored.setAlarmSlot(index, slot);
+    stored.commit();
+    prefs.end();
+  }
+#endif
+
+  // Physical stick directions. The board swaps the axes against
+  // getDirection()'s names: up/down move VRX, right/left move VRY.
+  enum Stick { STICK_CENTRE, STICK_UP, STICK_DOWN, STICK_LEFT, STICK_RIGHT };
+
+  void centreJoystick() {
+    host::setAnalog(board::JS_X, board::JS_X_CENTER);
+    host::setAnalog(board::JS_Y, board::JS_Y_CENTER);
+  }
+  void stick(Stick dir) {
+    centreJoystick();
+    if (dir == STICK_UP) host::setAnalog(board::JS_X, 4095);
+    if (dir == STICK_DOWN) host::setAnalog(board::JS_X, 0);
+    if (dir == STICK_RIGHT) host::setAnalog(board::JS_Y, 4095);
+    if (dir == STICK_LEFT) host::setAnalog(board::JS_Y, 0);
+  }
+  // Push and let go, running the sketch meanwhile
+  void flick(Stick dir, uint64_t holdMs = 150, uint64_t afterMs = 150) {
+    stick(dir);
+    runForMs(holdMs);
+    centreJoystick();
+    runForMs(afterMs);
+  }
+  void click(uint64_t holdMs = 120, uint64_t afterMs = 150) {
+    pressButton();
+    runForMs(holdMs);
+    releaseButton();
+    runForMs(afterMs);
+  }
+  void pressButton() {
+    host::setPin(board::JS_SW, LOW);
+  }
+  void releaseButton() {
+    host::releasePin(board::JS_SW);
+  }
+
+  // Flash writes since setup() started
+  uint32_t nvsWritesSinceBoot() const {
+    return host::nvsWriteCount() - bootNvsWrites;
+  }
+  uint64_t loopCount() const {
+    return loops;
+  }
+  // Virtual time loop() spent blocked (delay, I2C transfers, ...)
+  uint64_t busyInLoopUs() const {
+    return loopBusyUs;
+  }
+
+private:
+  bool storedType;
+
+  void storeClockType() {
+    Preferences prefs;
+    prefs.begin("geniClock", false);
+#if __has_include("settings.h")
+    Settings stored;
+    stored.begin(&prefs, DEFAULT_ALARM_TUNE, DEFAULT_CHIME_TUNE);
+    if (stored.get().clockType != (uint8_t)panel.type() || !stored.hasClockType()) {
+      stored.setClockType((uint8_t)panel.type());
+      stored.commit();
+    }
+#else
+    prefs.putUChar("clockType", (uint8_t)panel.type());  // before the settings blob
+#endif
+    prefs.end();
+    host::serialOutput().clear();
+  }
+  uint32_t bootNvsWrites = 0;
+  std::vector<host::Device*> extraDevices;
+  uint64_t loops = 0;
+  uint64_t loopBusyUs = 0;
+};
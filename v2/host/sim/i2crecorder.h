@@ -0,0 +1,180 @@
+#pragma once
+
+// The host side of the binary I2C trace (.i2ct, format in i2ctrace.h): the
+// Wire shim's transaction log written out with every byte kept, read back,
+// and two traces compared - per address transactions, bytes and bus time,
+// and the first transaction where they part.
+
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "host.h"
+#include "i2ctrace.h"
+
+namespace i2ct {
+
+struct Record {
+  uint64_t startUs;
+  uint32_t busUs;
+  uint8_t addr;
+  bool read;
+  uint8_t status;
+  uint32_t len;
+  std::vector<uint8_t> kept;
+
+  bool operator==(const Record& o) const {
+    return startUs == o.startUs && busUs == o.busUs && addr == o.addr && read == o.read && status == o.status &&
+           len == o.len && kept == o.kept;
+  }
+};
+
+// host::i2cLog() from 'fromUs' on; start times relative to 'fromUs'
+inline std::string record(uint64_t fromUs = 0) {
+  std::string out(I2C_TRACE_MAGIC, I2C_TRACE_MAGIC + 4);
+  out += (char)I2C_TRACE_VERSION;
+  uint64_t previousUs = fromUs;
+  for (const host::I2cTransaction& t : host::i2cLog()) {
+    if (t.startUs < fromUs) continue;
+    std::vector<uint8_t> bytes(18 + t.data.size());
+    uint8_t kept = t.data.size() > 255 ? 255 : (uint8_t)t.data.size();
+    uint16_t n = I2cTraceFormat::putRecord(bytes.data(), (uint32_t)(t.startUs - previousUs), t.busUs, t.addr, t.read,
+                                           t.status, (uint32_t)t.data.size(), t.data.data(), kept);
+    out.append((const char*)bytes.data(), n);
+    previousUs = t.startUs;
+  }
+  return out;
+}
+
+inline bool readVarint(const std::string& in, size_t& pos, uint32_t& v) {
+  v = 0;
+  for (int shift = 0; shift < 35; shift += 7) {
+    if (pos >= in.size()) return false;
+    uint8_t b = (uint8_t)in[pos++];
+    v |= (uint32_t)(b & 0x7F) << shift;
+    if (!(b & 0x80)) return true;
+  }
+  return false;
+}
+
+// False on a bad header or a truncated record ('error' says which)
+inline bool parse(const std::string& in, std::vector<Record>& out, std::string& error) {
+  out.clear();
+  if (in.size() < 5 || in.compare(0, 4, std::string(I2C_TRACE_MAGIC, I2C_TRACE_MAGIC + 4)) != 0) {
+    error = "not an .i2ct trace";
+    return false;
+  }
+  if ((uint8_t)in[4] != I2C_TRACE_VERSION) {
+    error = "trace version " + std::to_string((uint8_t)in[4]);
+    return false;
+  }
+  size_t pos = 5;
+  uint64_t at = 0;
+  while (pos < in.size()) {
+    Record r;
+    uint32_t delta, len;
+    if (!readVarint(in, pos, delta) || !readVarint(in, pos, r.busUs) || pos + 2 > in.size()) break;
+    r.addr = (uint8_t)in[pos] & 0x7F;
+    r.read = (uint8_t)in[pos++] & 0x80;
+    r.status = (uint8_t)in[pos++];
+    if (!readVarint(in, pos, len) || pos >= in.size()) break;
+    uint8_t kept = (uint8_t)in[pos++];
+    if (pos + kept > in.size()) break;
+    at += delta;
+    r.startUs = at;
+    r.len = len;
+    r.kept.assign(in.begin() + pos, in.begin() + pos + kept);
+    pos += kept;
+    out.push_back(r);
+  }
+  if (pos < in.size()) {
+    error = "truncated after " + std::to_string(out.size()) + " transactions";
+    return false;
+  }
+  return true;
+}
+
+inline bool load(const std::string& path, std::string& bytes) {
+  FILE* f = fopen(path.c_str(), "rb");
+  if (!f) return false;
+  char buf[4096];
+  size_t n;
+  bytes.clear();
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0) bytes.append(buf, n);
+  fclose(f);
+  return true;
+}
+
+inline bool save(const std::string& path, const std::string& bytes) {
+  FILE* f = fopen(path.c_str(), "wb");
+  if (!f) return false;
+  bool ok = fwrite(bytes.data(), 1, bytes.size(), f) == bytes.size();
+  return fclose(f) == 0 && ok;
+}
+
+// One line per transaction, for diff(1)
+inline std::string dumpLine(const Record& r) {
+  char head[64];
+  snprintf(head, sizeof(head), "%llu,%u,0x%02X,%c,%u,%u,", (unsigned long long)r.startUs, r.busUs, r.addr,
+           r.read ? 'R' : 'W', r.status, r.len);
+  std::string line = head;
+  for (uint8_t b : r.kept) {
+    char hex[3];
+    snprintf(hex, sizeof(hex), "%02X", b);
+    line += hex;
+  }
+  return line;
+}
+
+struct Totals {
+  uint64_t transactions = 0, bytes = 0, busUs = 0;
+};
+
+// Per address, plus the whole bus under 0xFF
+inline std::map<uint8_t, Totals> totals(const std::vector<Record>& records) {
+  std::map<uint8_t, Totals> t;
+  for (const Record& r : records) {
+    for (uint8_t key : { r.addr, (uint8_t)0xFF }) {
+      t[key].transactions++;
+      t[key].bytes += r.len;
+      t[key].busUs += r.busUs;
+    }
+  }
+  return t;
+}
+
+// Bus-time delta table, old -> new; returns the index of the first
+// transaction that differs (-1 = identical)
+inline long printDelta(const std::vector<Record>& before, const std::vector<Record>& after, FILE* out = stdout) {
+  std::map<uint8_t, Totals> a = totals(before), b = totals(after);
+  std::map<uint8_t, bool> keys;
+  for (const auto& [k, v] : a) keys[k] = true;
+  for (const auto& [k, v] : b) keys[k] = true;
+  fprintf(out, "addr,transactions,delta,bytes,delta,bus_us,delta\n");
+  for (const auto& [k, unused] : keys) {
+    const Totals& x = a[k];
+    const Totals& y = b[k];
+    char name[8] = "all";
+    if (k != 0xFF) snprintf(name, sizeof(name), "0x%02X", k);
+    fprintf(out, "%s,%llu,%+lld,%llu,%+lld,%llu,%+lld\n", name, (unsigned long long)y.transactions,
+            (long long)(y.transactions - x.transactions), (unsigned long long)y.bytes, (long long)(y.bytes - x.bytes),
+            (unsigned long long)y.busUs, (long long)(y.busUs - x.busUs));
+  }
+  size_t common = before.size() < after.size() ? before.size() : after.size();
+  for (size_t i = 0; i < common; i++) {
+    if (!(before[i] == after[i])) {
+      fprintf(out, "first difference at transaction %zu:\n- %s\n+ %s\n", i, dumpLine(before[i]).c_str(),
+              dumpLine(after[i]).c_str());
+      return (long)i;
+    }
+  }
+  if (before.size() != after.size()) {
+    fprintf(out, "first difference at transaction %zu: %s\n", common,
+            before.size() > after.size() ? "removed from here on" : "added from here on");
+    return (long)common;
+  }
+  return -1;
+}
+
+}  // namespace i2ct
@@ -0,0 +1,107 @@
+// Loop stalls and RTC jumps on the whole firmware: the hourly chime and the
+// alarms fire when the clock crosses them, exactly once, however late the
+// loop gets there - and a jump forward only catches up within the event's
+// catch-up window (ALARM_CATCHUP_S / CHIME_CATCHUP_S).
+//
+// A stall is virtual time passing without loop() (esp_timers and the
+// DS3231 keep going); a jump is the DS3231 being set underneath the sketch.
+
+#include "firmware.h"
+#include "check.h"
+
+static Firmware fw(DisplayPanel::PANEL_HDSP2111);
+
+static int chimes = 0, alarms = 0;
+
+// Rising edges of the sketch's own state, seen between loop() passes
+static void watch(uint64_t) {
+  static bool chiming = false, ringing = false;
+  if (playingHourNotification && !chiming) chimes++;
+  if (alarmClock.isAlarmActive() && !ringing) alarms++;
+  chiming = playingHourNotification;
+  ringing = alarmClock.isAlarmActive();
+}
+
+static void runUntilRtc(const DateTime& when) {
+  while (fw.rtc.time().unixtime() < when.unixtime()) fw.step();
+}
+
+static void stallFor(uint64_t ms) {
+  host::advanceUs(ms * 1000);
+}
+
+static void jumpTo(const DateTime& when) {
+  fw.rtc.setTime(when);
+}
+
+TEST(stalls_and_jumps) {
+  Firmware::storeAlarm(0, 10, 30);
+  Firmware::storeAlarm(1, 10, 45);
+  fw.rtc.setTime(DateTime(2025, 5, 1, 9, 59, 0));
+  fw.beforeLoop = watch;
+  fw.powerOn();
+
+  // loop() stuck across the full hour: the chime still comes, once
+  runUntilRtc(DateTime(2025, 5, 1, 9, 59, 57));
+  CHECK_EQ(chimes, 0);
+  stallFor(8000);
+  fw.runForMs(5000);
+  CHECK_EQ(chimes, 1);
+
+  // A resync a few seconds back over that hour: no second chime
+  jumpTo(DateTime(2025, 5, 1, 9, 59, 58));
+  fw.runForMs(6000);
+  CHECK_EQ(chimes, 1);
+
+  // Forward jump with nothing to cross, then a stall over the 10:30 alarm
+  fw.runForMs(60000);
+  jumpTo(DateTime(2025, 5, 1, 10, 29, 50));
+  fw.runForMs(3000);
+  CHECK_EQ(alarms, 0);
+  stallFor(30000);
+  fw.runForMs(2000);
+  CHECK_EQ(alarms, 1);
+  CHECK(alarmClock.isAlarmActive());
+  fw.flick(Firmware::STICK_RIGHT);  // dismiss
+  CHECK(!alarmClock.isAlarmActive());
+
+  // A resync a few seconds back over the alarm that just rang: not again
+  jumpTo(DateTime(2025, 5, 1, 10, 29, 57));
+  fw.runForMs(6000);
+  CHECK_EQ(alarms, 1);
+  CHECK(!alarmClock.isAlarmActive());
+
+  // Jump over the 10:45 alarm, 30 s late: inside ALARM_CATCHUP_S, rings
+  fw.runForMs(5000);
+  jumpTo(DateTime(2025, 5, 1, 10, 45, 30));
+  fw.runForMs(3000);
+  CHECK_EQ(alarms, 2);
+  fw.flick(Firmware::STICK_RIGHT);
+  CHECK(!alarmClock.isAlarmActive());
+
+  // Jump over 11:00, 5 min late: past CHIME_CATCHUP_S, no chime
+  fw.runForMs(5000);
+  jumpTo(DateTime(2025, 5, 1, 11, 5, 0));
+  fw.runForMs(5000);
+  CHECK_EQ(chimes, 1);
+
+  // Back before 11:00: the hour is crossed for real this time - one chime
+  jumpTo(DateTime(2025, 5, 1, 10, 59, 50));
+  fw.runForMs(20000);
+  CHECK_EQ(chimes, 2);
+  CHECK_EQ(alarms, 2);
+
+  // Many short stalls around the next hour: still exactly one chime
+  runUntilRtc(DateTime(2025, 5, 1, 11, 59, 55));
+  for (int i = 0; i < 10; i++) {
+    stallFor(1700);
+    fw.step();
+  }
+  fw.runForMs(3000);
+  CHECK_EQ(chimes, 3);
+  CHECK_EQ(fw.panel.violations(), 0u);
+}
+
+int main(int argc, char** argv) {
+  return runTests(argc, argv);
+}
@@ -0,0 +1,112 @@
+// Golden I2C traces: the bus traffic of a few standard scenarios, recorded
+// from the Wire shim as a binary trace (.i2ct) and compared with the one
+// stored in v2/host/golden/. Any change to HDSPDisplay, the RTC access
+// pattern or the MCP23017 setup shows up here with its bus-time delta:
+//   boot    power-on to the clock on the panel, 3 s
+//   modes   the stick through every mode and back to the clock
+//   chime   12:59:58 - 13:00:05
+//   alarm   a 07:00 alarm from 06:59:58 until 5 s into the ringing
+// A traffic change that is meant to be: GENI_UPDATE_GOLDEN=1 rewrites the
+// golden file; the new trace is left in the build dir either way
+// (i2ctrace delta / dump compare the two).
+//
+//   sim_i2c_golden boot|modes|chime|alarm <golden dir>
+
+#include <cstring>
+
+#include "firmware.h"
+#include "check.h"
+#include "i2crecorder.h"
+
+static Firmware fw(DisplayPanel::PANEL_HDSP2111);
+
+static bool showsClock() {
+  const std::string& text = fw.panel.text();
+  return text.size() == 8 && text[2] == ':' && text[5] == ':';
+}
+
+static bool rtcReaches(const DateTime& t) {
+  return fw.rtc.time().unixtime() >= t.unixtime();
+}
+
+// The scenario's bus traffic, from its start
+static std::string runScenario(const std::string& name) {
+  uint64_t fromUs = 0;
+  if (name == "boot") {
+    fw.rtc.setTime(DateTime(2025, 5, 1, 12, 0, 0));
+    fw.powerOn();
+    fw.runForMs(3000);
+  } else if (name == "modes") {
+    fw.rtc.setTime(DateTime(2025, 5, 1, 12, 0, 0));
+    fw.powerOn();
+    CHECK(fw.runUntil(showsClock, 5000));
+    fw.runForMs(1000);
+    fromUs = host::nowUs();
+    int flicks = 0;
+    do {
+      fw.flick(Firmware::STICK_RIGHT, 150, 1500);
+    } while (currentMode != 0 && ++flicks < 30);
+    CHECK_EQ((int)currentMode, 0);
+    CHECK(fw.runUntil(showsClock, 5000));
+  } else if (name == "chime") {
+    fw.rtc.setTime(DateTime(2025, 5, 1, 12, 59, 50));
+    fw.powerOn();
+    CHECK(fw.runUntil([] { return rtcReaches(DateTime(2025, 5, 1, 12, 59, 58)); }, 10000));
+    fromUs = host::nowUs();
+    CHECK(fw.runUntil([] { return playingHourNotification; }, 3000));
+    CHECK(fw.runUntil([] { return rtcReaches(DateTime(2025, 5, 1, 13, 0, 5)); }, 10000));
+  } else if (name == "alarm") {
+    Firmware::storeAlarm(0, 7, 0);
+    fw.rtc.setTime(DateTime(2025, 5, 1, 6, 59, 50));
+    fw.powerOn();
+    CHECK(fw.runUntil([] { return rtcReaches(DateTime(2025, 5, 1, 6, 59, 58)); }, 10000));
+    fromUs = host::nowUs();
+    CHECK(fw.runUntil([] { return alarmClock.isAlarmActive(); }, 3000));
+    fw.runForMs(5000);
+    CHECK(alarmClock.isAlarmActive());
+  }
+  CHECK_EQ(fw.panel.violations(), 0u);
+  return i2ct::record(fromUs);
+}
+
+static std::string scenario, goldenDir;
+
+TEST(matches_the_golden_trace) {
+  host::setI2cLogging(true);
+  std::string trace = runScenario(scenario);
+  std::vector<i2ct::Record> now, golden;
+  std::string error;
+  CHECK(i2ct::parse(trace, now, error));
+  i2ct::save(scenario + ".i2ct", trace);
+  printf("%s: %zu transactions, %zu bytes of trace\n", scenario.c_str(), now.size(), trace.size());
+
+  std::string goldenPath = goldenDir + "/" + scenario + ".i2ct";
+  const char* update = getenv("GENI_UPDATE_GOLDEN");
+  if (update && *update == '1') {
+    CHECK(i2ct::save(goldenPath, trace));
+    printf("%s rewritten\n", goldenPath.c_str());
+    return;
+  }
+  std::string stored;
+  CHECK(i2ct::load(goldenPath, stored));
+  CHECK(i2ct::parse(stored, golden, error));
+  long firstDifference = i2ct::printDelta(golden, now);
+  if (firstDifference >= 0) {
+    printf("bus traffic changed against %s (new trace: %s.i2ct; GENI_UPDATE_GOLDEN=1 if intended)\n",
+           goldenPath.c_str(), scenario.c_str());
+  }
+  CHECK_EQ(firstDifference, -1L);
+}
+
+int main(int argc, char** argv) {
+  static const char* const SCENARIOS[] = { "boot", "modes", "chime", "alarm" };
+  bool known = false;
+  for (const char* s : SCENARIOS) known |= argc == 3 && !strcmp(argv[1], s);
+  if (!known) {
+    fprintf(stderr, "usage: sim_i2c_golden boot|modes|chime|alarm <golden dir>\n");
+    return 2;
+  }
+  scenario = argv[1];
+  goldenDir = argv[2];
+  return runTests(1, argv);
+}
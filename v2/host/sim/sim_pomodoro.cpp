@@ -0,0 +1,118 @@
+// A 25/5 pomodoro cycle on the whole firmware, accelerated: the default
+// 25 min work / 5 min break is started from POMODORO mode, the user goes
+// back to the clock, and the virtual clock runs through a full set (four
+// work phases, the fourth break long) and into the next one. Every phase
+// change has to preempt the clock with its message and the chime on the
+// second the phase ends, and hand the clock back afterwards.
+
+#include <chrono>
+
+#include "firmware.h"
+#include "check.h"
+
+static Firmware fw(DisplayPanel::PANEL_HDSP2111);
+
+struct Announcement {
+  uint32_t rtcEpoch;  // DS3231 time when the message went up
+  uint64_t us;
+  std::string text;
+};
+
+static std::vector<Announcement> announcements;
+
+// Rising edges of the phase change message; the text once the panel has
+// been rewritten (blank + 8 characters over I2C take a few loop() passes)
+static void watch(uint64_t nowUs) {
+  static bool announcing = false;
+  if (pomodoro.isAnnouncing() && !announcing) {
+    announcements.push_back({ fw.rtc.time().unixtime(), nowUs, "" });
+  }
+  announcing = pomodoro.isAnnouncing();
+  if (announcing && announcements.back().text.empty() && nowUs - announcements.back().us >= 200000) {
+    announcements.back().text = fw.panel.text();
+  }
+}
+
+// The chime's first note at or after 'fromUs', 0 if none
+static uint64_t chimeStartUs(uint64_t fromUs) {
+  for (const host::ToneChange& c : host::toneLog()) {
+    if (c.pin == board::BUZZER && c.us >= fromUs && c.freq == NOTIF_NOTES[0].freq) return c.us;
+  }
+  return 0;
+}
+
+static bool showsClock() {
+  const std::string& text = fw.panel.text();
+  return text.size() == 8 && text[2] == ':' && text[5] == ':';
+}
+
+TEST(twenty_five_five_cycle) {
+  fw.rtc.setTime(DateTime(2025, 5, 1, 10, 2, 0));
+  fw.beforeLoop = watch;
+  fw.powerOn();
+  CHECK(fw.runUntil(showsClock, 5000));
+
+  // Forward through the modes to POMODORO, past its title and the "SET WORK" title
+  for (int i = 0; i < 12 && currentMode != 8; i++) fw.flick(Firmware::STICK_RIGHT);
+  CHECK_EQ((int)currentMode, 8);
+  CHECK(fw.runUntil([] { return fw.panel.text() == "WORK 25m"; }, 10000));
+  fw.flick(Firmware::STICK_RIGHT);
+  CHECK(fw.runUntil([] { return fw.panel.text() == "BRK   5m"; }, 10000));
+  fw.flick(Firmware::STICK_RIGHT);  // start
+  CHECK(pomodoro.isRunning());
+  CHECK_EQ(announcements.size(), (size_t)1);
+  uint32_t start = pomodoro.getPhaseEndEpoch() - 25 * 60;
+
+  // Double CANCEL: back to the clock, the cycle keeps running
+  fw.runForMs(POMODORO_MESSAGE_MS + 500);
+  CHECK_STR(announcements[0].text.c_str(), "WORK 25m");
+  fw.flick(Firmware::STICK_LEFT, 150, 100);
+  fw.flick(Firmware::STICK_LEFT, 150, 1500);
+  CHECK_EQ((int)currentMode, 0);
+  CHECK(pomodoro.isRunning());
+  CHECK(fw.runUntil(showsClock, 5000));
+
+  // Accelerated: the idle loop steps 20 ms at a time (the second a phase
+  // ends is still seen through the DS3231's 1 Hz interrupt)
+  fw.idleStepUs = 20000;
+  auto wallStart = std::chrono::steady_clock::now();
+  uint64_t simStart = host::nowUs();
+
+  // W25 B5 W25 B5 W25 B5 W25 L20, then W25 again
+  struct Phase {
+    uint32_t minutes;
+    const char* text;
+  };
+  const Phase expected[] = {
+    { 25, "BREAK 5m" }, { 5, "WORK 25m" }, { 25, "BREAK 5m" }, { 5, "WORK 25m" },
+    { 25, "BREAK 5m" }, { 5, "WORK 25m" }, { 25, "LONG 20m" }, { 20, "WORK 25m" },
+  };
+  uint32_t phaseEnd = start;
+  for (const Phase& phase : expected) {
+    phaseEnd += phase.minutes * 60;
+    size_t seen = announcements.size();
+    while (fw.rtc.time().unixtime() < phaseEnd + 10) fw.step();
+    CHECK_EQ(announcements.size(), seen + 1);
+    if (announcements.size() != seen + 1) break;
+    const Announcement& a = announcements.back();
+    CHECK_STR(a.text.c_str(), phase.text);
+    CHECK_EQ(a.rtcEpoch, phaseEnd);  // on the second, not a loop() or an RTC read later
+    uint64_t chime = chimeStartUs(a.us - 1000000);
+    CHECK(chime >= a.us - 1000000 && chime <= a.us + 1000);
+    CHECK_EQ((int)currentMode, 0);  // preempted, not switched
+    CHECK(showsClock());            // and handed back after the message
+  }
+
+  // Into the second set: W1 again, 25 min from the long break's end
+  CHECK_EQ(pomodoro.getPhaseEndEpoch(), phaseEnd + 25 * 60);
+  CHECK_EQ(fw.panel.violations(), 0u);
+
+  double wallS = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+  double simS = (host::nowUs() - simStart) / 1e6;
+  printf("pomodoro: %.0f s simulated in %.2f s (x%.0f), %llu loops\n", simS, wallS, wallS > 0 ? simS / wallS : 0.0,
+         (unsigned long long)fw.loopCount());
+}
+
+int main(int argc, char** argv) {
+  return runTests(argc, argv);
+}
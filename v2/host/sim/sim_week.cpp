@@ -0,0 +1,381 @@
+// A week of the whole firmware on the virtual clock, in a few seconds. The
+// loop sleeps until the next thing that can happen - an NMEA burst, a
+// DS3231 INT, an esp_timer, a scripted input - instead of spinning through
+// every millisecond; around scripted input it steps 1 ms like the real loop.
+//
+// The world: a GPS module sending RMC + GGA once a second (true UTC) that
+// goes silent for six hours on Friday, a DS3231 that runs fast or slow and
+// starts off by half a minute, a daily 07:00 alarm that the user dismisses
+// (Saturday: snoozes first), and a Sunday with a DST change. Checked
+// against the true Hungarian time:
+//  - the chime sounds once whenever the local time passes a full hour
+//    (as close as the RTC is) - so 23 on the spring Sunday, and the autumn one's
+//    repeated hour doesn't chime again;
+//  - every alarm rings on its RTC second and stops on the user's input;
+//  - every GPS resync leaves the RTC on the true local second, the DST
+//    change reaches the RTC on its second, a silent module is no fix and
+//    nothing is written meanwhile;
+//  - once synced, the RTC is never more than the resync leaves alone - a
+//    second, plus how late in the GPS second it is read; no NVS writes.
+// Per simulated day: chimes, alarms, RTC writes, NVS writes, I2C bytes and
+// the time loop() spent blocked (delays + I2C transfers).
+//
+//   sim_week spring|autumn
+
+#include <chrono>
+#include <cstring>
+#include <map>
+
+#include "firmware.h"
+#include "check.h"
+
+static Firmware fw(DisplayPanel::PANEL_HDSP2111);
+
+// ---- True time ----
+
+struct Scenario {
+  const char* name;
+  DateTime startUtc;  // virtual time 0
+  DateTime dstChangeUtc;
+  double rtcDriftPpm;
+  int32_t rtcStartErrorS;
+  DateTime outageUtc;  // GPS silent from here for OUTAGE_S
+};
+
+const uint32_t OUTAGE_S = 6 * 3600;
+
+static Scenario scenario;
+
+static uint32_t utcAt(uint64_t us) {
+  return scenario.startUtc.unixtime() + (uint32_t)(us / 1000000);
+}
+
+static uint64_t usOfUtc(uint32_t utc) {
+  return (uint64_t)(utc - scenario.startUtc.unixtime()) * 1000000;
+}
+
+// Independent of gps.h: CEST from the last Sunday of March 01:00 UTC to the
+// last Sunday of October 01:00 UTC
+static DateTime lastSundayUtc1(int year, int month) {
+  DateTime day(year, month, 31, 1, 0, 0);
+  while (day.dayOfTheWeek() != 0) day = day - TimeSpan(1, 0, 0, 0);
+  return day;
+}
+
+static uint32_t localOf(uint32_t utc) {
+  DateTime t(utc);
+  bool dst = utc >= lastSundayUtc1(t.year(), 3).unixtime() && utc < lastSundayUtc1(t.year(), 10).unixtime();
+  return utc + (dst ? 7200 : 3600);
+}
+
+static uint32_t trueLocalNow() {
+  return localOf(utcAt(host::nowUs()));
+}
+
+static uint64_t usOfLocal(const DateTime& local) {
+  // Local -> UTC: try both offsets (the DST hour itself isn't scripted)
+  for (uint32_t offset : { 3600u, 7200u }) {
+    uint32_t utc = local.unixtime() - offset;
+    if (localOf(utc) == local.unixtime()) return usOfUtc(utc);
+  }
+  return 0;
+}
+
+static std::string fmt(uint32_t epoch) {
+  DateTime t(epoch);
+  char buf[24];
+  snprintf(buf, sizeof(buf), "%04d-%02d-%02d %02d:%02d:%02d", t.year(), t.month(), t.day(), t.hour(), t.minute(),
+           t.second());
+  return buf;
+}
+
+// ---- GPS module: RMC + GGA at every true UTC second ----
+
+static std::string nmea(const char* body) {
+  uint8_t sum = 0;
+  for (const char* p = body; *p; p++) sum ^= (uint8_t)*p;
+  char buf[128];
+  snprintf(buf, sizeof(buf), "$%s*%02X\r\n", body, sum);
+  return buf;
+}
+
+class GpsModule : public host::Device {
+public:
+  uint64_t nextEventUs() const override {
+    return next;
+  }
+  void onEvent(uint64_t nowUs) override {
+    next = nowUs + 1000000;
+    if (silent(nowUs)) return;
+    DateTime t(utcAt(nowUs));
+    char body[100];
+    snprintf(body, sizeof(body), "GPRMC,%02d%02d%02d.00,A,4729.8100,N,01903.1500,E,0.0,0.0,%02d%02d%02d,,,A",
+             t.hour(), t.minute(), t.second(), t.day(), t.month(), t.year() % 100);
+    std::string burst = nmea(body);
+    snprintf(body, sizeof(body), "GPGGA,%02d%02d%02d.00,4729.8100,N,01903.1500,E,1,08,1.0,110.0,M,40.0,M,,",
+             t.hour(), t.minute(), t.second());
+    burst += nmea(body);
+    host::uartInject(1, burst);
+    sentences += 2;
+  }
+  static bool silent(uint64_t us) {
+    uint64_t from = usOfUtc(scenario.outageUtc.unixtime());
+    return us >= from && us < from + OUTAGE_S * 1000000ULL;
+  }
+  uint64_t sentences = 0;
+
+private:
+  uint64_t next = 0;
+};
+
+static GpsModule gpsModule;
+
+// ---- Scripted user ----
+
+class Script : public host::Device {
+public:
+  void at(uint64_t us, std::function<void()> action) {
+    actions.insert({ us, action });
+  }
+  uint64_t nextEventUs() const override {
+    return actions.empty() ? UINT64_MAX : actions.begin()->first;
+  }
+  void onEvent(uint64_t nowUs) override {
+    while (!actions.empty() && actions.begin()->first <= nowUs) {
+      std::function<void()> action = actions.begin()->second;
+      actions.erase(actions.begin());
+      action();
+      fineUntilUs = nowUs + 2000000;  // debounce / gestures need the real 1 ms loop
+    }
+  }
+  uint64_t fineUntilUs = 0;
+
+private:
+  std::multimap<uint64_t, std::function<void()>> actions;
+};
+
+static Script user;
+
+static void flickAt(uint64_t us, Firmware::Stick dir) {
+  user.at(us, [dir] { fw.stick(dir); });
+  user.at(us + 150000, [] { fw.centreJoystick(); });
+}
+
+static void clickAt(uint64_t us) {
+  user.at(us, [] { fw.pressButton(); });
+  user.at(us + 120000, [] { fw.releaseButton(); });
+}
+
+// ---- Observations ----
+
+struct Ring {
+  uint32_t rtc;    // DS3231 local time at the rising edge
+  uint32_t truth;  // true local time
+  uint64_t us;
+};
+
+static std::vector<Ring> chimes, alarms;
+static std::vector<Ring> rtcWrites;  // rtc = the value written
+static std::vector<uint64_t> alarmStops;
+static int64_t maxRtcErrorUs = 0;    // once synced, outside the DST second
+static uint32_t gpsOkWhileSilent = 0;
+
+struct Day {
+  std::string date;
+  int chimes = 0, alarms = 0, rtcWrites = 0;
+  uint32_t nvsWrites = 0;
+  uint64_t i2cBytes = 0, busyUs = 0, loops = 0;
+  // counters at the start of the day
+  uint32_t nvs0 = 0;
+  uint64_t i2c0 = 0, busy0 = 0, loops0 = 0;
+};
+static std::vector<Day> days;
+
+static void closeDay() {
+  Day& d = days.back();
+  d.nvsWrites = fw.nvsWritesSinceBoot() - d.nvs0;
+  d.i2cBytes = host::i2cByteCount() - d.i2c0;
+  d.busyUs = host::busyUs() - d.busy0;
+  d.loops = fw.loopCount() - d.loops0;
+}
+
+static void openDay(uint32_t truth) {
+  Day d;
+  d.date = fmt(truth).substr(0, 10);
+  d.nvs0 = fw.nvsWritesSinceBoot();
+  d.i2c0 = host::i2cByteCount();
+  d.busy0 = host::busyUs();
+  d.loops0 = fw.loopCount();
+  days.push_back(d);
+  host::serialOutput().clear();
+}
+
+static void watch(uint64_t nowUs) {
+  static bool chiming = false, ringing = false;
+  static uint32_t writes = 0;
+  static uint32_t dayNumber = 0;
+
+  fw.idleStepUs = nowUs < user.fineUntilUs ? 1000 : 1000000;
+
+  uint32_t truth = trueLocalNow();
+  uint32_t rtcNow = fw.rtc.time().unixtime();
+  if (truth / 86400 != dayNumber) {
+    if (dayNumber) closeDay();
+    dayNumber = truth / 86400;
+    openDay(truth);
+  }
+  Day& day = days.back();
+
+  if (playingHourNotification && !chiming) {
+    chimes.push_back({ rtcNow, truth, nowUs });
+    day.chimes++;
+  }
+  if (alarmClock.isAlarmActive() && !ringing) {
+    alarms.push_back({ rtcNow, truth, nowUs });
+    day.alarms++;
+  }
+  if (!alarmClock.isAlarmActive() && ringing) alarmStops.push_back(nowUs);
+  if (fw.rtc.timeWrites() != writes) {
+    rtcWrites.push_back({ rtcNow, truth, nowUs });
+    day.rtcWrites++;
+  }
+  chiming = playingHourNotification;
+  ringing = alarmClock.isAlarmActive();
+  writes = fw.rtc.timeWrites();
+
+  // The loop that applies the DST step runs right after this - skip its second
+  uint64_t dstUs = usOfUtc(scenario.dstChangeUtc.unixtime());
+  if (!rtcWrites.empty() && !(nowUs >= dstUs && nowUs < dstUs + 1000000)) {
+    // The RTC second [rtcNow, rtcNow + 1) against the true instant: exact
+    // on the loop the DS3231 ticks (its INT wakes it), a lower bound between
+    int64_t truthUs = (int64_t)truth * 1000000 + (int64_t)(nowUs % 1000000);
+    int64_t aheadUs = (int64_t)rtcNow * 1000000 - truthUs;
+    int64_t behindUs = truthUs - ((int64_t)rtcNow + 1) * 1000000;
+    int64_t errorUs = aheadUs > behindUs ? aheadUs : behindUs;
+    if (errorUs > maxRtcErrorUs) maxRtcErrorUs = errorUs;
+  }
+  if (GpsModule::silent(nowUs - GPS_FIX_MAX_AGE_MS * 1000) && GpsModule::silent(nowUs) && gpsAvailable) {
+    gpsOkWhileSilent++;
+  }
+}
+
+// ---- The week ----
+
+const uint64_t WEEK_US = 7ULL * 86400 * 1000000;
+const uint64_t SECOND_US = 1000000;
+// An RTC a second behind is left alone when the resync reads it (see
+// updateTimeSource()), and the read is up to GPS_SYNC_MAX_AGE_MS after the
+// GPS second began - so drift can carry it that much past a second
+const uint64_t RTC_TOLERANCE_US = SECOND_US + GPS_SYNC_MAX_AGE_MS * 1000;
+
+static bool near(uint64_t us, uint64_t expectedUs, uint64_t toleranceUs) {
+  return us + toleranceUs >= expectedUs && us <= expectedUs + toleranceUs;
+}
+
+static void report(double wallS) {
+  printf("week,%s: %.1f s wall, %llu loops, %llu NMEA sentences\n", scenario.name, wallS,
+         (unsigned long long)fw.loopCount(), (unsigned long long)gpsModule.sentences);
+  printf("day,date,chimes,alarms,rtc_writes,nvs_writes,i2c_bytes,busy_ms,loops\n");
+  for (const Day& d : days) {
+    printf("day,%s,%d,%d,%d,%u,%llu,%llu,%llu\n", d.date.c_str(), d.chimes, d.alarms, d.rtcWrites, d.nvsWrites,
+           (unsigned long long)d.i2cBytes, (unsigned long long)(d.busyUs / 1000), (unsigned long long)d.loops);
+  }
+}
+
+TEST(week) {
+  Firmware::storeAlarm(0, 7, 0);
+  host::setI2cLogging(false);
+  fw.rtc.setTime(DateTime(localOf(scenario.startUtc.unixtime()) + scenario.rtcStartErrorS));
+  fw.rtc.setDriftPpm(scenario.rtcDriftPpm);
+  fw.addDevice(&gpsModule);
+  fw.addDevice(&user);
+  fw.beforeLoop = watch;
+
+  // Every morning: dismiss the alarm 20 s in (RIGHT); Saturday: snooze
+  // first (button) and dismiss the snoozed one
+  std::vector<uint64_t> alarmsDue, stopsDue;
+  DateTime firstDay(localOf(scenario.startUtc.unixtime()));
+  for (int d = 1; d <= 7; d++) {
+    DateTime alarm = DateTime(firstDay.year(), firstDay.month(), firstDay.day(), 7, 0, 0) + TimeSpan(d, 0, 0, 0);
+    DateTime input = alarm + TimeSpan(20);
+    alarmsDue.push_back(usOfLocal(alarm));
+    stopsDue.push_back(usOfLocal(input));
+    if (alarm.dayOfTheWeek() == 6) {
+      clickAt(usOfLocal(input));
+      DateTime snoozed = input + TimeSpan(ALARM_SNOOZE_SECONDS);
+      alarmsDue.push_back(usOfLocal(snoozed));
+      stopsDue.push_back(usOfLocal(snoozed + TimeSpan(20)));
+      flickAt(stopsDue.back(), Firmware::STICK_RIGHT);
+    } else {
+      flickAt(usOfLocal(input), Firmware::STICK_RIGHT);
+    }
+  }
+
+  auto wallStart = std::chrono::steady_clock::now();
+  fw.powerOn();
+  fw.runUntilUs(WEEK_US);
+  closeDay();
+  report(std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count());
+
+  // Chimes: wherever the true local time passes a full hour going forward
+  std::vector<uint64_t> chimesDue;
+  uint32_t start = scenario.startUtc.unixtime();
+  for (uint32_t utc = start / 3600 * 3600 + 3600; utc < start + WEEK_US / SECOND_US; utc += 3600) {
+    if (localOf(utc) > localOf(utc - 1)) chimesDue.push_back(usOfUtc(utc));
+  }
+  CHECK_EQ(chimes.size(), chimesDue.size());
+  for (size_t i = 0; i < chimes.size() && i < chimesDue.size(); i++) {
+    if (!near(chimes[i].us, chimesDue[i], RTC_TOLERANCE_US)) {
+      printf("chime %zu at %s, due %s\n", i, fmt(chimes[i].truth).c_str(), fmt(localOf(utcAt(chimesDue[i]))).c_str());
+      CHECK(false);
+    }
+  }
+
+  // Alarms ring on the second and stop on the input
+  CHECK_EQ(alarms.size(), alarmsDue.size());
+  CHECK_EQ(alarmStops.size(), stopsDue.size());
+  for (size_t i = 0; i < alarms.size() && i < alarmsDue.size(); i++) {
+    CHECK(near(alarms[i].us, alarmsDue[i], RTC_TOLERANCE_US));
+  }
+  for (size_t i = 0; i < alarmStops.size() && i < stopsDue.size(); i++) {
+    CHECK(alarmStops[i] >= stopsDue[i] && alarmStops[i] < stopsDue[i] + SECOND_US);
+  }
+
+  // GPS: the half-minute error is gone within seconds, every write is the
+  // true second, the DST step lands on its second, drift needs a few a day
+  CHECK(!rtcWrites.empty());
+  if (!rtcWrites.empty()) CHECK(rtcWrites[0].us < 10 * SECOND_US);
+  bool dstWritten = false;
+  uint64_t dstUs = usOfUtc(scenario.dstChangeUtc.unixtime());
+  uint64_t outageUs = usOfUtc(scenario.outageUtc.unixtime());
+  for (const Ring& w : rtcWrites) {
+    CHECK_EQ(w.rtc, w.truth);
+    CHECK(!(w.us >= outageUs && w.us < outageUs + OUTAGE_S * SECOND_US));
+    if (near(w.us, dstUs, SECOND_US)) dstWritten = true;
+  }
+  CHECK(dstWritten);
+  printf("week,%s: RTC at most %.3f s off the true time once synced\n", scenario.name, maxRtcErrorUs / 1e6);
+  CHECK(maxRtcErrorUs <= (int64_t)RTC_TOLERANCE_US);
+  CHECK_EQ(gpsOkWhileSilent, 0u);
+
+  for (const Day& d : days) {
+    CHECK(d.rtcWrites <= 3);
+    CHECK_EQ(d.nvsWrites, 0u);
+  }
+  CHECK_EQ(fw.panel.violations(), 0u);
+}
+
+int main(int argc, char** argv) {
+  if (argc != 2 || (strcmp(argv[1], "spring") && strcmp(argv[1], "autumn"))) {
+    fprintf(stderr, "usage: sim_week spring|autumn\n");
+    return 2;
+  }
+  if (!strcmp(argv[1], "spring")) {
+    scenario = { "spring", DateTime(2025, 3, 26, 12, 10, 0), DateTime(2025, 3, 30, 1, 0, 0), 20.0, 30,
+                 DateTime(2025, 3, 28, 9, 0, 0) };
+  } else {
+    scenario = { "autumn", DateTime(2025, 10, 22, 12, 10, 0), DateTime(2025, 10, 26, 1, 0, 0), -20.0, -30,
+                 DateTime(2025, 10, 24, 9, 0, 0) };
+  }
+  return runTests(1, argv);
+}
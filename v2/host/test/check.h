@@ -0,0 +1,100 @@
+#pragma once
+
+// Minimal test harness for the host build (no external deps):
+//   TEST(name) { CHECK(cond); CHECK_EQ(a, b); }
+//   int main(int argc, char** argv) { return runTests(argc, argv); }
+// Every test starts from host::reset() + an erased NVS. A failed check
+// reports and the test goes on; the exit code is the number of failed tests.
+// Arguments select tests by name substring.
+
+#include <stdio.h>
+#include <string.h>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "host.h"
+
+struct TestCase {
+  const char* name;
+  void (*fn)();
+};
+
+inline std::vector<TestCase>& testRegistry() {
+  static std::vector<TestCase> tests;
+  return tests;
+}
+
+inline int& testFailures() {
+  static int failures = 0;
+  return failures;
+}
+
+struct TestRegistrar {
+  TestRegistrar(const char* name, void (*fn)()) {
+    testRegistry().push_back({ name, fn });
+  }
+};
+
+#define TEST(name) \
+  static void test_##name(); \
+  static TestRegistrar registrar_##name(#name, &test_##name); \
+  static void test_##name()
+
+template <class T>
+std::string checkRepr(const T& v) {
+  std::ostringstream s;
+  s << v;
+  return s.str();
+}
+inline std::string checkRepr(const std::string& v) {
+  return "\"" + v + "\"";
+}
+inline std::string checkRepr(const char* v) {
+  return v ? "\"" + std::string(v) + "\"" : "null";
+}
+inline std::string checkRepr(uint8_t v) {
+  return std::to_string(v);
+}
+inline std::string checkRepr(int8_t v) {
+  return std::to_string(v);
+}
+
+inline void checkFailed(const char* file, int line, const std::string& what) {
+  fprintf(stderr, "%s:%d: FAILED %s\n", file, line, what.c_str());
+  testFailures()++;
+}
+
+#define CHECK(cond) \
+  do { \
+    if (!(cond)) checkFailed(__FILE__, __LINE__, #cond); \
+  } while (0)
+
+#define CHECK_EQ(actual, expected) \
+  do { \
+    auto checkA = (actual); \
+    auto checkE = (expected); \
+    if (!(checkA == checkE)) \
+      checkFailed(__FILE__, __LINE__, std::string(#actual " == " #expected ": got ") + checkRepr(checkA) + ", expected " + checkRepr(checkE)); \
+  } while (0)
+
+#define CHECK_STR(actual, expected) CHECK_EQ(std::string(actual), std::string(expected))
+
+inline int runTests(int argc, char** argv) {
+  int failedTests = 0, run = 0;
+  for (const TestCase& t : testRegistry()) {
+    bool selected = argc <= 1;
+    for (int i = 1; i < argc; i++) selected |= strstr(t.name, argv[i]) != nullptr;
+    if (!selected) continue;
+    host::reset();
+    host::nvsErase();
+    int before = testFailures();
+    t.fn();
+    run++;
+    bool ok = testFailures() == before;
+    if (!ok) failedTests++;
+    printf("%s %s\n", ok ? "[ OK ]" : "[FAIL]", t.name);
+  }
+  printf("%d/%d tests passed\n", run - failedTests, run);
+  return failedTests;
+}
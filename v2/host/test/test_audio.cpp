@@ -0,0 +1,135 @@
+// AudioSequencer priority arbitration on the virtual clock: which source
+// owns the buzzer, preemption by every higher priority, resume of the
+// interrupted note, and note timing that other sources can't disturb.
+
+#include <Arduino.h>
+#include "constants.h"
+#include "audio.h"
+
+#include "check.h"
+
+const byte PIN = 6;
+
+// Distinct frequencies per source so the log says who is playing
+const Note BEEP[] = { { 100, 50 } };
+const Note CHIME[] = { { 200, 300 }, { 201, 300 }, { 202, 300 } };
+const Note TIMER_RING[] = { { 300, 200 }, { 0, 100 } };
+const Note ALARM_RING[] = { { 400, 250 }, { 401, 250 } };
+
+// Buzzer frequency changes from 'fromUs' on, as (time, freq)
+static std::vector<std::pair<uint64_t, uint32_t>> changes(uint64_t fromUs = 0) {
+  std::vector<std::pair<uint64_t, uint32_t>> out;
+  for (const host::ToneChange& c : host::toneLog()) {
+    if (c.pin == PIN && c.us >= fromUs) out.push_back({ c.us, c.freq });
+  }
+  return out;
+}
+
+static void expectChanges(const std::vector<std::pair<uint64_t, uint32_t>>& expected, uint64_t fromUs = 0) {
+  std::vector<std::pair<uint64_t, uint32_t>> got = changes(fromUs);
+  CHECK_EQ(got.size(), expected.size());
+  for (size_t i = 0; i < got.size() && i < expected.size(); i++) {
+    CHECK_EQ(got[i].second, expected[i].second);
+    CHECK_EQ(got[i].first, expected[i].first);
+  }
+}
+
+TEST(single_source_plays_its_notes_on_time) {
+  AudioSequencer audio;
+  audio.begin(PIN);
+  host::clearToneLog();
+  audio.play(SOUND_CHIME, CHIME, 3);
+  host::advanceUs(2000000);
+  // play() kicks the note timer 1 us out
+  expectChanges({ { 1, 200 }, { 300001, 201 }, { 600001, 202 }, { 900001, 0 } });
+  CHECK(!audio.isPlaying(SOUND_CHIME));
+}
+
+TEST(each_higher_priority_preempts_and_the_lower_resumes) {
+  AudioSequencer audio;
+  audio.begin(PIN);
+  host::clearToneLog();
+
+  audio.play(SOUND_KEY_BEEP, BEEP, 1);
+  host::advanceUs(10000);
+  audio.play(SOUND_CHIME, CHIME, 3);  // 10 ms into the beep
+  host::advanceUs(100000);
+  audio.play(SOUND_TIMER, TIMER_RING, 2, true);  // 100 ms into chime note 0
+  host::advanceUs(50000);
+  audio.play(SOUND_ALARM, ALARM_RING, 2, true);  // 50 ms into the timer note
+  host::advanceUs(600000);                        // alarm: 250 + 250, then loops
+
+  CHECK(audio.isPlaying(SOUND_KEY_BEEP));  // preempted, not dropped
+  CHECK(audio.isPlaying(SOUND_CHIME));
+  CHECK(audio.isPlaying(SOUND_TIMER));
+  uint64_t t = host::nowUs();
+  audio.stop(SOUND_ALARM);
+  host::advanceUs(250000);  // timer note restarts: 200 on, 100 rest ... looping
+  audio.stop(SOUND_TIMER);
+  uint64_t t2 = host::nowUs();
+  host::advanceUs(1000000);  // chime note 0 restarts, then 1, 2; then the beep
+
+  expectChanges({
+    { 1, 100 },
+    { 10001, 200 },
+    { 110001, 300 },
+    { 160001, 400 },
+    { 410001, 401 },
+    { 660001, 400 },
+    { t + 1, 300 },
+    { t + 200001, 0 },
+    { t2 + 1, 200 },
+    { t2 + 300001, 201 },
+    { t2 + 600001, 202 },
+    { t2 + 900001, 100 },
+    { t2 + 950001, 0 },
+  });
+  CHECK(!audio.isPlaying(SOUND_KEY_BEEP));
+  CHECK(!audio.isPlaying(SOUND_CHIME));
+}
+
+TEST(lower_priority_requests_do_not_disturb_the_playing_note) {
+  AudioSequencer audio;
+  audio.begin(PIN);
+  host::clearToneLog();
+  audio.play(SOUND_ALARM, ALARM_RING, 2, true);
+  host::advanceUs(100000);
+  audio.play(SOUND_KEY_BEEP, BEEP, 1);  // queued under the alarm ...
+  host::advanceUs(50000);
+  audio.play(SOUND_CHIME, CHIME, 3);
+  host::advanceUs(50000);
+  audio.stop(SOUND_CHIME);  // ... and withdrawn again
+  host::advanceUs(400000);
+  // The alarm keeps its 250 ms grid
+  expectChanges({ { 1, 400 }, { 250001, 401 }, { 500001, 400 } });
+}
+
+TEST(replaying_a_source_restarts_it_from_the_first_note) {
+  AudioSequencer audio;
+  audio.begin(PIN);
+  host::clearToneLog();
+  audio.play(SOUND_CHIME, CHIME, 3);
+  host::advanceUs(450000);  // into note 1
+  audio.play(SOUND_CHIME, CHIME, 3);
+  host::advanceUs(2000000);
+  expectChanges({ { 1, 200 }, { 300001, 201 }, { 450001, 200 }, { 750001, 201 }, { 1050001, 202 }, { 1350001, 0 } });
+}
+
+TEST(stopping_a_preempted_source_is_silent) {
+  AudioSequencer audio;
+  audio.begin(PIN);
+  host::clearToneLog();
+  audio.play(SOUND_CHIME, CHIME, 3);
+  host::advanceUs(100000);
+  audio.play(SOUND_TIMER, TIMER_RING, 2, true);
+  host::advanceUs(50000);
+  audio.stop(SOUND_CHIME);  // under the timer: nothing changes on the pin
+  host::advanceUs(100000);
+  audio.stop(SOUND_TIMER);
+  host::advanceUs(1000000);
+  expectChanges({ { 1, 200 }, { 100001, 300 }, { 250001, 0 } });
+}
+
+int main(int argc, char** argv) {
+  return runTests(argc, argv);
+}
@@ -0,0 +1,118 @@
+// HDSPDisplay against the panel model: the non-blocking reset path (frame
+// queued, written in full by update()) and the changed-characters path of
+// displayText() must leave the same characters on the glass, on both panels.
+
+#include <Arduino.h>
+#include "constants.h"
+#include "HDSPDisplay.h"
+
+#include "mcp23017.h"
+#include "panel.h"
+#include "check.h"
+
+struct PanelRig {
+  Mcp23017 mcp;
+  DisplayPanel panel;
+  HDSPDisplay hdsp;
+
+  explicit PanelRig(DisplayPanel::Type type) : panel(type) {
+    mcp.onOutputs = [this](uint8_t gpa, uint8_t gpb) {
+      panel.onPins(gpa, gpb);
+    };
+    host::attachI2c(MCP23017_ADDR, &mcp);
+    hdsp.setClockType((uint8_t)type);
+    hdsp.begin();
+  }
+
+  // loop(): update() every millisecond until the reset sequence is through
+  void settle() {
+    for (int i = 0; i < 100 && (hdsp.isResetting() || i == 0); i++) {
+      hdsp.update();
+      host::advanceUs(1000);
+    }
+  }
+};
+
+static const DisplayPanel::Type TYPES[] = { DisplayPanel::PANEL_HDLY2416, DisplayPanel::PANEL_HDSP2111 };
+
+static const char* const FRAMES[] = {
+  "12:34:56", "12:34:57", "12:35:00", "2025. 05", " 01 Thu ", "    ", "TIMER 1 ", "00:00.0 ", "12:35:00",
+  "12",
+};
+
+// Panel contents after each frame, every frame written one way
+static std::vector<std::string> showFrames(DisplayPanel::Type type, bool forced, uint32_t& violations) {
+  host::reset();
+  PanelRig rig(type);
+  rig.hdsp.forceDisplayText((char*)"--------");
+  rig.settle();
+  std::vector<std::string> shown;
+  for (const char* frame : FRAMES) {
+    if (forced) rig.hdsp.forceDisplayText((char*)frame);
+    else rig.hdsp.displayText((char*)frame);
+    rig.settle();
+    shown.push_back(rig.panel.text());
+    CHECK_EQ(rig.panel.text(), (std::string(frame) + "        ").substr(0, 8));
+    CHECK_EQ(rig.panel.text(), std::string(rig.hdsp.getDisplayedText()));
+  }
+  violations = rig.panel.violations();
+  return shown;
+}
+
+TEST(reset_queue_and_changed_chars_show_the_same_frames) {
+  for (DisplayPanel::Type type : TYPES) {
+    uint32_t forcedViolations, changedViolations;
+    std::vector<std::string> full = showFrames(type, true, forcedViolations);
+    std::vector<std::string> partial = showFrames(type, false, changedViolations);
+    CHECK_EQ(full.size(), partial.size());
+    for (size_t i = 0; i < full.size() && i < partial.size(); i++) CHECK_EQ(partial[i], full[i]);
+    CHECK_EQ(forcedViolations, 0u);
+    CHECK_EQ(changedViolations, 0u);
+  }
+}
+
+TEST(frame_sequence_lands_on_the_panel) {
+  for (DisplayPanel::Type type : TYPES) {
+    host::reset();
+    PanelRig rig(type);
+    rig.hdsp.displayText((char*)"- GENI -");  // first frame: reset + queue
+    CHECK(rig.hdsp.isResetting());
+    rig.settle();
+    CHECK_STR(rig.panel.text(), "- GENI -");
+    uint32_t resets = rig.panel.resets();
+
+    uint32_t before = rig.panel.charWrites();
+    rig.hdsp.displayText((char*)"- GENI -");  // unchanged frame: nothing on the bus
+    CHECK_EQ(rig.panel.charWrites(), before);
+    rig.hdsp.displayText((char*)"- GENA -");
+    CHECK_EQ(rig.panel.charWrites(), before + 1);
+    CHECK_STR(rig.panel.text(), "- GENA -");
+    rig.hdsp.displayText((char*)"12");  // short text pads with blanks
+    CHECK_STR(rig.panel.text(), "12      ");
+    CHECK_EQ(rig.panel.resets(), resets);
+    CHECK_EQ(rig.panel.violations(), 0u);
+  }
+}
+
+TEST(latest_frame_queued_during_reset_wins) {
+  for (DisplayPanel::Type type : TYPES) {
+    host::reset();
+    PanelRig rig(type);
+    rig.hdsp.displayText((char*)"FIRST   ");
+    rig.settle();
+    rig.hdsp.forceDisplayText((char*)"SECOND  ");
+    rig.hdsp.update();
+    rig.hdsp.displayText((char*)"THIRD   ");  // still resetting: replaces the queued frame
+    CHECK(rig.hdsp.isResetting());
+    rig.settle();
+    CHECK_STR(rig.panel.text(), "THIRD   ");
+    CHECK_STR(rig.hdsp.getDisplayedText(), "THIRD   ");
+    // Nothing of SECOND ever reached the glass
+    for (const DisplayPanel::Frame& f : rig.panel.history()) CHECK(f.text.find("SECOND") == std::string::npos);
+    CHECK_EQ(rig.panel.violations(), 0u);
+  }
+}
+
+int main(int argc, char** argv) {
+  return runTests(argc, argv);
+}
@@ -0,0 +1,232 @@
+// GestureEngine on synthetic press/release timelines: update() runs every
+// millisecond like loop() does, every emitted gesture is recorded with the
+// millisecond it came out. The tables mirror the sketch's BROWSE / EDIT /
+// SETUP contexts.
+
+#include <Arduino.h>
+#include "constants.h"
+#include "gesture.h"
+
+#include <algorithm>
+
+#include "check.h"
+
+enum : byte {
+  G_CANCEL_SINGLE = 1,
+  G_CANCEL_DOUBLE,
+  G_SETTIME_ENTRY,
+  G_SETUP_SWITCH,
+  G_SETUP_CONFIRM,
+  G_CHIME_TUNE,
+};
+
+const GestureSpec BROWSE[] = {
+  { G_SETTIME_ENTRY, GIN_ADD, 3, TRIPLE_PRESS_WINDOW, TRIPLE_PRESS_WINDOW },
+  { G_CHIME_TUNE, GIN_ADD, 2, TRIPLE_PRESS_WINDOW, CHIME_TUNE_DOUBLE_PRESS_WINDOW },
+};
+const GestureSpec EDIT[] = {
+  { G_CANCEL_SINGLE, GIN_CANCEL, 1, CANCEL_DOUBLE_PRESS_WINDOW },
+  { G_CANCEL_DOUBLE, GIN_CANCEL, 2, CANCEL_DOUBLE_PRESS_WINDOW },
+};
+const GestureSpec SETUP[] = {
+  { G_SETUP_SWITCH, GIN_BUTTON, DISPLAY_SETUP_SWITCH_PRESSES, DISPLAY_SETUP_PRESS_WINDOW },
+  { G_SETUP_CONFIRM, GIN_BUTTON, 0, DISPLAY_SETUP_CONFIRM_HOLD },
+};
+
+struct Edge {
+  unsigned long ms;
+  byte input;
+  bool down;
+};
+
+struct Fired {
+  unsigned long ms;
+  byte id;
+  byte input;
+  byte clicks;
+};
+
+// Plays the edges in order, update() every ms from start to end
+static std::vector<Fired> play(GestureEngine& engine, std::vector<Edge> edges, unsigned long start,
+                               unsigned long end) {
+  std::stable_sort(edges.begin(), edges.end(), [start](const Edge& a, const Edge& b) {
+    return a.ms - start < b.ms - start;
+  });
+  std::vector<Fired> fired;
+  size_t next = 0;
+  for (unsigned long t = start;; t++) {
+    while (next < edges.size() && edges[next].ms == t) {
+      if (edges[next].down) engine.press(edges[next].input, t);
+      else engine.release(edges[next].input, t);
+      next++;
+    }
+    engine.update(t);
+    GestureEvent ev;
+    while (engine.nextEvent(ev)) fired.push_back({ t, ev.id, ev.input, ev.clicks });
+    if (t == end) break;
+  }
+  return fired;
+}
+
+// A tap: press at ms, release 80 ms later
+static void tap(std::vector<Edge>& edges, byte input, unsigned long ms) {
+  edges.push_back({ ms, input, true });
+  edges.push_back({ ms + 80, input, false });
+}
+
+TEST(triple_up_inside_three_seconds_enters_set_time) {
+  GestureEngine engine;
+  engine.setSpecs(BROWSE, 2);
+  std::vector<Edge> edges;
+  tap(edges, GIN_ADD, 100);
+  tap(edges, GIN_ADD, 1500);
+  tap(edges, GIN_ADD, 2900);
+  std::vector<Fired> fired = play(engine, edges, 0, 8000);
+  CHECK_EQ(fired.size(), (size_t)1);
+  if (fired.size() == 1) {
+    CHECK_EQ((int)fired[0].id, (int)G_SETTIME_ENTRY);
+    CHECK_EQ(fired[0].ms, 2900UL);  // on the third press, no window wait
+  }
+}
+
+TEST(triple_up_spread_over_more_than_three_seconds_does_nothing) {
+  GestureEngine engine;
+  engine.setSpecs(BROWSE, 2);
+  std::vector<Edge> edges;
+  tap(edges, GIN_ADD, 100);
+  tap(edges, GIN_ADD, 1700);
+  tap(edges, GIN_ADD, 3300);  // every gap < 3 s, but 3.2 s from the first
+  std::vector<Fired> fired = play(engine, edges, 0, 10000);
+  CHECK_EQ(fired.size(), (size_t)0);
+}
+
+TEST(quick_double_up_selects_the_tune_slow_one_does_nothing) {
+  GestureEngine engine;
+  engine.setSpecs(BROWSE, 2);
+  std::vector<Edge> edges;
+  tap(edges, GIN_ADD, 1000);  // quick double: when the series window is over
+  tap(edges, GIN_ADD, 1300);
+  tap(edges, GIN_ADD, 6000);  // 500 ms apart - a slow start of a triple
+  tap(edges, GIN_ADD, 6500);
+  std::vector<Fired> fired = play(engine, edges, 0, 12000);
+  CHECK_EQ(fired.size(), (size_t)1);
+  if (fired.size() == 1) {
+    CHECK_EQ((int)fired[0].id, (int)G_CHIME_TUNE);
+    CHECK_EQ(fired[0].ms, 1000UL + TRIPLE_PRESS_WINDOW + 1);
+  }
+}
+
+TEST(down_clicks_on_press_in_browse) {
+  GestureEngine engine;
+  engine.setSpecs(BROWSE, 2);
+  std::vector<Edge> edges;
+  tap(edges, GIN_SUBTRACT, 1000);
+  tap(edges, GIN_SUBTRACT, 1200);
+  std::vector<Fired> fired = play(engine, edges, 0, 2000);
+  CHECK_EQ(fired.size(), (size_t)2);
+  if (fired.size() == 2) {
+    CHECK_EQ((int)fired[0].id, (int)GESTURE_CLICK);
+    CHECK_EQ(fired[0].ms, 1000UL);  // chime on/off waits for nothing
+    CHECK_EQ(fired[1].ms, 1200UL);
+  }
+}
+
+TEST(cancel_single_and_double_in_edit_context) {
+  GestureEngine engine;
+  engine.setSpecs(EDIT, 2);
+  std::vector<Edge> edges;
+  tap(edges, GIN_CANCEL, 200);
+  tap(edges, GIN_CANCEL, 2000);
+  tap(edges, GIN_CANCEL, 2450);
+  std::vector<Fired> fired = play(engine, edges, 0, 4000);
+  CHECK_EQ(fired.size(), (size_t)2);
+  if (fired.size() == 2) {
+    CHECK_EQ((int)fired[0].id, (int)G_CANCEL_SINGLE);
+    CHECK_EQ(fired[0].ms, 200UL + CANCEL_DOUBLE_PRESS_WINDOW + 1);
+    CHECK_EQ((int)fired[1].id, (int)G_CANCEL_DOUBLE);
+    CHECK_EQ(fired[1].ms, 2450UL);
+  }
+}
+
+TEST(inputs_without_a_spec_click_on_press) {
+  GestureEngine engine;
+  engine.setSpecs(EDIT, 2);
+  std::vector<Edge> edges;
+  tap(edges, GIN_ADD, 300);
+  tap(edges, GIN_CONFIRM, 310);
+  std::vector<Fired> fired = play(engine, edges, 0, 1000);
+  CHECK_EQ(fired.size(), (size_t)2);
+  if (fired.size() == 2) {
+    CHECK_EQ((int)fired[0].id, (int)GESTURE_CLICK);
+    CHECK_EQ((int)fired[0].input, (int)GIN_ADD);
+    CHECK_EQ(fired[0].ms, 300UL);
+    CHECK_EQ((int)fired[1].input, (int)GIN_CONFIRM);
+    CHECK_EQ(fired[1].ms, 310UL);
+  }
+}
+
+TEST(setup_hold_confirms_at_the_hold_time) {
+  GestureEngine engine;
+  engine.setSpecs(SETUP, 2);
+  std::vector<Edge> edges = { { 500, GIN_BUTTON, true }, { 4000, GIN_BUTTON, false } };
+  std::vector<Fired> fired = play(engine, edges, 0, 6000);
+  CHECK_EQ(fired.size(), (size_t)1);  // the release after the hold is no click
+  if (fired.size() == 1) {
+    CHECK_EQ((int)fired[0].id, (int)G_SETUP_CONFIRM);
+    CHECK_EQ(fired[0].ms, 500UL + DISPLAY_SETUP_CONFIRM_HOLD);
+  }
+}
+
+TEST(setup_five_clicks_switch_counted_on_release) {
+  GestureEngine engine;
+  engine.setSpecs(SETUP, 2);
+  std::vector<Edge> edges;
+  for (int i = 0; i < 4; i++) tap(edges, GIN_BUTTON, 100 + i * 1000);
+  // A pause longer than the window restarts the count ...
+  for (int i = 0; i < 5; i++) tap(edges, GIN_BUTTON, 6000 + i * 1000);
+  std::vector<Fired> fired = play(engine, edges, 0, 12000);
+  CHECK_EQ(fired.size(), (size_t)1);
+  if (fired.size() == 1) {
+    CHECK_EQ((int)fired[0].id, (int)G_SETUP_SWITCH);
+    CHECK_EQ((int)fired[0].clicks, (int)DISPLAY_SETUP_SWITCH_PRESSES);
+    CHECK_EQ(fired[0].ms, 6000UL + 4 * 1000 + 80);  // ... and the fifth release ends it
+  }
+}
+
+TEST(switching_tables_drops_a_half_finished_series) {
+  GestureEngine engine;
+  engine.setSpecs(BROWSE, 2);
+  std::vector<Edge> edges;
+  tap(edges, GIN_ADD, 100);
+  tap(edges, GIN_ADD, 600);
+  std::vector<Fired> fired = play(engine, edges, 0, 800);
+  CHECK_EQ(fired.size(), (size_t)0);
+  engine.setSpecs(EDIT, 2);
+  engine.setSpecs(BROWSE, 2);
+  edges.clear();
+  tap(edges, GIN_ADD, 1000);  // would have been the third
+  fired = play(engine, edges, 801, 5000);
+  CHECK_EQ(fired.size(), (size_t)0);
+}
+
+// Two button presses fed in one loop, drained after: each click keeps the
+// edge of its own press (the reaction / stop games time from it)
+TEST(each_click_carries_its_own_press_edge) {
+  GestureEngine engine;
+  engine.setSpecs(BROWSE, 2);
+  engine.press(GIN_BUTTON, 100, 100123);
+  engine.release(GIN_BUTTON, 150);
+  engine.press(GIN_BUTTON, 180, 180456);
+  engine.update(200);
+  GestureEvent ev = {};
+  CHECK(engine.nextEvent(ev));
+  CHECK_EQ((int)ev.input, (int)GIN_BUTTON);
+  CHECK_EQ(ev.edgeUs, 100123u);
+  CHECK(engine.nextEvent(ev));
+  CHECK_EQ(ev.edgeUs, 180456u);
+  CHECK(!engine.nextEvent(ev));
+}
+
+int main(int argc, char** argv) {
+  return runTests(argc, argv);
+}
@@ -0,0 +1,331 @@
+// Every sketch header, in the sketch's include order, compiled unmodified in
+// one translation unit - plus the persistence / input / GPS basics
+
+#include <Arduino.h>  // the Arduino builder's implicit first include
+#include "constants.h"
+#include "HDSPDisplay.h"
+#include "i2ctrace.h"
+#include "gps.h"
+#include "gpsfilter.h"
+#include <Wire.h>
+#include <RTClib.h>
+#include <Preferences.h>
+#include "timer.h"
+#include "stopwatch.h"
+#include "pomodoro.h"
+#include "reminders.h"
+#include "reaction.h"
+#include "stopgame.h"
+#include "alarm.h"
+#include "settime.h"
+#include "Better-JoyStick.h"
+#include "boottimeline.h"
+#include "buttoninput.h"
+#include "gesture.h"
+#include "audio.h"
+#include "melodies.h"
+#include "settings.h"
+#include "clockevents.h"
+#include "rtcalarms.h"
+#include "bench.h"
+
+#include "check.h"
+
+TEST(settings_blob_round_trip) {
+  {
+    Preferences prefs;
+    prefs.begin("geniClock", false);
+    Settings settings;
+    settings.begin(&prefs, 0, 0);  // nothing stored: defaults, written right away
+    CHECK_EQ(settings.getNvsWriteCount(), 1u);
+    settings.setClockType(1);
+    settings.setChimeTune(2);
+    CHECK(settings.isDirty());
+    settings.update();  // not idle long enough yet
+    CHECK(settings.isDirty());
+    host::advanceUs(SETTINGS_IDLE_COMMIT_MS * 1000);
+    settings.update();
+    CHECK(!settings.isDirty());
+    CHECK_EQ(settings.getNvsWriteCount(), 2u);
+  }
+  uint32_t flashWrites = host::nvsWriteCount();
+  host::reset();  // reboot
+  Preferences prefs;
+  prefs.begin("geniClock", false);
+  Settings settings;
+  settings.begin(&prefs, 0, 0);
+  CHECK(settings.hasClockType());
+  CHECK_EQ((int)settings.get().clockType, 1);
+  CHECK_EQ((int)settings.get().chimeTune, 2);
+  CHECK_EQ(host::nvsWriteCount(), flashWrites);  // a clean boot writes nothing
+}
+
+TEST(settings_changed_back_after_boot_is_not_written) {
+  Preferences prefs;
+  prefs.begin("geniClock", false);
+  {
+    Settings settings;
+    settings.begin(&prefs, 0, 0);
+    settings.setChimeTune(2);
+    settings.commit();
+  }
+  Settings settings;
+  settings.begin(&prefs, 0, 0);
+  uint32_t writes = settings.getNvsWriteCount();
+  settings.setChimeTune(3);
+  settings.setChimeTune(2);
+  CHECK_EQ((int)settings.commit(), 0);
+  CHECK_EQ(settings.getNvsWriteCount(), writes);
+}
+
+TEST(settings_corrupt_blob_falls_back_to_defaults) {
+  Preferences prefs;
+  prefs.begin("geniClock", false);
+  {
+    Settings settings;
+    settings.begin(&prefs, 0, 0);
+    settings.setClockType(1);
+    settings.commit();
+  }
+  uint8_t blob[SETTINGS_BLOB_MAX];
+  size_t len = prefs.getBytes(SETTINGS_BLOB_KEY, blob, sizeof(blob));
+  CHECK(len > 8);
+  blob[6] ^= 0x40;
+  prefs.putBytes(SETTINGS_BLOB_KEY, blob, len);
+
+  Settings settings;
+  settings.begin(&prefs, 0, 0);
+  CHECK(!settings.hasClockType());
+  CHECK(host::serialOutput().find("defaults (blob corrupt)") != std::string::npos);
+}
+
+TEST(settings_migrates_legacy_keys_once) {
+  Preferences prefs;
+  prefs.begin("geniClock", false);
+  prefs.putInt("alarmHours", 6);
+  prefs.putInt("alarmMins", 45);
+  prefs.putBool("alarmOn", true);
+  prefs.putUChar("clockType", 1);
+  Settings settings;
+  settings.begin(&prefs, 0, 0);
+  CHECK_EQ((int)settings.get().alarms[0].hour, 6);
+  CHECK_EQ((int)settings.get().alarms[0].minute, 45);
+  CHECK(settings.get().alarms[0].enabled);
+  CHECK(settings.hasClockType());
+  CHECK(!prefs.isKey("alarmHours"));
+  CHECK(!prefs.isKey("clockType"));
+  CHECK(prefs.isKey(SETTINGS_BLOB_KEY));
+}
+
+TEST(button_input_debounces_bounces) {
+  ButtonInput button;
+  button.begin(JS_SW);
+  host::advanceUs(100000);
+  // Press with three bounce edges inside the lockout window
+  host::setPin(JS_SW, LOW);
+  host::advanceUs(300);
+  host::setPin(JS_SW, HIGH);
+  host::advanceUs(300);
+  host::setPin(JS_SW, LOW);
+  host::advanceUs(5000);
+  button.poll();
+  ButtonEvent ev{};
+  CHECK(button.nextEvent(ev));
+  CHECK_EQ((int)ev.type, (int)BTN_PRESS);
+  CHECK_EQ(ev.edgeUs, 100000u);
+  CHECK(!button.nextEvent(ev));
+
+  host::advanceUs(200000);
+  host::setPin(JS_SW, HIGH);
+  host::advanceUs(1000);
+  button.poll();
+  CHECK(button.nextEvent(ev));
+  CHECK_EQ((int)ev.type, (int)BTN_RELEASE);
+  CHECK(!button.isPressed());
+}
+
+TEST(alarm_double_cancel_puts_the_enable_toggle_back) {
+  Preferences prefs;
+  prefs.begin("geniClock", false);
+  Settings settings;
+  settings.begin(&prefs, 0, 0);
+  HDSPDisplay display;
+  AudioSequencer audio;
+  Alarm alarm(&display, &audio, &settings);
+  alarm.loadAlarmSettings();
+  alarm.setNow(DateTime(2025, 5, 1, 9, 0, 0).unixtime());
+  alarm.reset();
+  auto skipTitle = [&]() {
+    host::advanceUs(ALARM_SETTING_TITLE_DURATION * 1000);
+    alarm.update();
+  };
+
+  skipTitle();
+  for (int step = 0; step < 4; step++) {  // slot, hours, minutes, days
+    alarm.handleConfirmButton();
+    skipTitle();
+  }
+  alarm.handleAddButton();  // ALRM ON - saved right away
+  CHECK(settings.get().alarms[0].enabled);
+  CHECK(alarm.isAlarmEnabled());
+
+  alarm.handleCancelDoublePress();
+  CHECK(alarm.shouldExitAlarmMode());
+  CHECK(!settings.get().alarms[0].enabled);
+  CHECK(!alarm.isAlarmEnabled());
+}
+
+static std::string nmea(const std::string& body) {
+  uint8_t sum = 0;
+  for (char c : body) sum ^= (uint8_t)c;
+  char tail[8];
+  snprintf(tail, sizeof(tail), "*%02X\r\n", sum);
+  return "$" + body + tail;
+}
+
+TEST(gps_rmc_to_hungarian_local_time) {
+  GPS gps;
+  gps.begin(GPS_RX, GPS_TX);
+  int y, mo, d, dow, h, mi, s;
+
+  // Summer: CEST, UTC+2
+  host::uartInject(1, nmea("GPRMC,101530.00,A,4730.000,N,01903.000,E,0.0,0.0,150725,,,A"));
+  gps.update();
+  CHECK(gps.hasFix());
+  gps.getHungarianTime(y, mo, d, dow, h, mi, s);
+  CHECK_EQ(h, 12);
+  CHECK_EQ(mi, 15);
+  CHECK_EQ(s, 30);
+
+  // New Year's Eve 23:30 UTC -> next day, next year
+  host::advanceUs(GPS_CACHE_VALIDITY_MS * 1000);
+  host::uartInject(1, nmea("GPRMC,233000.00,A,4730.000,N,01903.000,E,0.0,0.0,311225,,,A"));
+  gps.update();
+  gps.getHungarianTime(y, mo, d, dow, h, mi, s);
+  CHECK_EQ(y, 2026);
+  CHECK_EQ(mo, 1);
+  CHECK_EQ(d, 1);
+  CHECK_EQ(h, 0);
+}
+
+// Fix at 'hhmmss' UTC on 'ddmmyy' -> local hour and weekday (0 = Sunday)
+static void gpsLocal(GPS& gps, const char* hhmmss, const char* ddmmyy, int& hour, int& dow) {
+  host::advanceUs(GPS_CACHE_VALIDITY_MS * 1000);
+  host::uartInject(1, nmea(std::string("GPRMC,") + hhmmss + ".00,A,4730.000,N,01903.000,E,0.0,0.0," + ddmmyy + ",,,A"));
+  gps.update();
+  int y, mo, d, mi, s;
+  gps.getHungarianTime(y, mo, d, dow, hour, mi, s);
+}
+
+TEST(gps_dst_changes_on_the_last_sunday_at_0100_utc) {
+  GPS gps;
+  gps.begin(GPS_RX, GPS_TX);
+  int h, dow;
+
+  // 2025-03-30 is the last Sunday of March - not the Friday before it
+  gpsLocal(gps, "005959", "300325", h, dow);
+  CHECK_EQ(h, 1);
+  CHECK_EQ(dow, 0);
+  CHECK_EQ(gps.getUtcOffsetHours(), 1);
+  gpsLocal(gps, "010000", "300325", h, dow);
+  CHECK_EQ(h, 3);
+  CHECK_EQ(gps.getUtcOffsetHours(), 2);
+  gpsLocal(gps, "120000", "280325", h, dow);
+  CHECK_EQ(dow, 5);
+  CHECK_EQ(h, 13);
+  CHECK_EQ(gps.getUtcOffsetHours(), 1);
+
+  // 2025-10-26: 02:59:59 CEST, then 02:00:00 CET again
+  gpsLocal(gps, "005959", "261025", h, dow);
+  CHECK_EQ(h, 2);
+  CHECK_EQ(dow, 0);
+  CHECK_EQ(gps.getUtcOffsetHours(), 2);
+  gpsLocal(gps, "010000", "261025", h, dow);
+  CHECK_EQ(h, 2);
+  CHECK_EQ(gps.getUtcOffsetHours(), 1);
+
+  // Weekdays across a century and a leap day
+  gpsLocal(gps, "120000", "290224", h, dow);
+  CHECK_EQ(dow, 4);
+  gpsLocal(gps, "120000", "010100", h, dow);
+  CHECK_EQ(dow, 6);
+}
+
+TEST(gps_fix_goes_stale_when_the_module_falls_silent) {
+  GPS gps;
+  gps.begin(GPS_RX, GPS_TX);
+  host::uartInject(1, nmea("GPRMC,101530.00,A,4730.000,N,01903.000,E,0.0,0.0,150725,,,A"));
+  gps.update();
+  CHECK(gps.hasFix());
+  CHECK(gps.getFixAgeMs() < GPS_SYNC_MAX_AGE_MS);
+
+  host::advanceUs((GPS_FIX_MAX_AGE_MS - 1) * 1000);
+  CHECK(gps.hasFix());
+  host::advanceUs(1000);
+  CHECK(!gps.hasFix());
+  CHECK_EQ(gps.getUtcOffsetHours(), 0);
+  int y, mo, d, dow, h, mi, s;
+  gps.getHungarianTime(y, mo, d, dow, h, mi, s);
+  CHECK_EQ(y, 0);
+}
+
+TEST(gps_filter_takes_the_dst_step_at_once) {
+  GpsTimeFilter filter;
+  DateTime rtc(2025, 3, 30, 2, 0, 0);  // CET, one second after 01:59:59
+  // 03:00:00 CEST: +1 h, expected by the caller
+  CHECK(filter.accept(2025, 3, 30, 3, 0, 0, rtc.unixtime(), 3600));
+  // The same step unannounced needs the confirmations
+  CHECK(!filter.accept(2025, 3, 30, 3, 0, 0, rtc.unixtime()));
+  CHECK(filter.isConfirming());
+}
+
+// Fix and RTC both 'elapsedS' on from the start, fix 'offsetS' ahead
+static bool acceptStep(GpsTimeFilter& filter, uint32_t rtcStart, int64_t offsetS, uint32_t elapsedS, bool rtcValid) {
+  DateTime fix(rtcStart + offsetS + elapsedS);
+  return filter.accept(fix.year(), fix.month(), fix.day(), fix.hour(), fix.minute(), fix.second(),
+                       rtcValid ? rtcStart + elapsedS : 0);
+}
+
+TEST(gps_filter_holds_a_big_step_against_a_running_rtc) {
+  uint32_t rtc = DateTime(2025, 5, 1, 12, 0, 0).unixtime();
+  int64_t offset = (int64_t)DateTime(2031, 1, 1, 0, 0, 0).unixtime() - rtc;  // a module on its default date
+
+  // Three agreeing fixes are not enough; ten minutes of them are
+  GpsTimeFilter filter;
+  uint32_t start = millis() / 1000;
+  uint32_t elapsed = 0;
+  while (!acceptStep(filter, rtc, offset, elapsed, true) && elapsed < 3600) {
+    host::advanceUs(GPS_CONFIRM_RECHECK_MS * 1000);
+    elapsed = millis() / 1000 - start;
+  }
+  CHECK(elapsed >= GPS_BIG_STEP_CONFIRM_MS / 1000);
+  CHECK(elapsed < GPS_BIG_STEP_CONFIRM_MS / 1000 + GPS_CONFIRM_RECHECK_MS / 1000 + 1);
+
+  // A drifted-off hour, or an RTC that lost power: the fixes alone decide
+  GpsTimeFilter quick;
+  CHECK(!acceptStep(quick, rtc, 3600, 0, true));
+  CHECK(!acceptStep(quick, rtc, 3600, 2, true));
+  CHECK(acceptStep(quick, rtc, 3600, 4, true));
+  for (uint32_t s = 0; s <= 4; s += 2) {  // against millis() - it has to move along
+    CHECK_EQ(acceptStep(quick, rtc, offset, s, false), s == 4);
+    host::advanceUs(2000000);
+  }
+}
+
+TEST(clock_scheduler_fires_the_hour_once) {
+  ClockScheduler events;
+  events.setPeriodic(CLOCK_EVENT_HOUR_CHIME, 3600, CHIME_CATCHUP_S);
+  uint32_t t = DateTime(2025, 5, 1, 9, 59, 58).unixtime();
+  unsigned long ms = 0;
+  int fired = 0;
+  for (int i = 0; i < 5; i++, t++, ms += 1000) {
+    events.advance(t, ms);
+    ClockEventId id;
+    while (events.nextEvent(id)) fired += id == CLOCK_EVENT_HOUR_CHIME;
+  }
+  CHECK_EQ(fired, 1);
+}
+
+int main(int argc, char** argv) {
+  return runTests(argc, argv);
+}
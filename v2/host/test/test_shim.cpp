@@ -0,0 +1,310 @@
+// The HAL shims and hardware models themselves - everything else builds on them
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include <RTClib.h>
+#include <TinyGPSPlus.h>
+#include <Wire.h>
+
+#include "check.h"
+#include "ds3231.h"
+#include "mcp23017.h"
+
+static std::vector<std::pair<int, uint64_t>> fired;
+static void recordFire(void* arg) {
+  fired.push_back({ (int)(intptr_t)arg, host::nowUs() });
+}
+
+static esp_timer_handle_t makeTimer(int id) {
+  esp_timer_create_args_t args = {};
+  args.callback = &recordFire;
+  args.arg = (void*)(intptr_t)id;
+  esp_timer_handle_t h = nullptr;
+  esp_timer_create(&args, &h);
+  return h;
+}
+
+TEST(esp_timers_fire_in_deadline_order_at_their_deadline) {
+  fired.clear();
+  esp_timer_handle_t a = makeTimer(1), b = makeTimer(2);
+  CHECK_EQ(esp_timer_start_once(a, 500), ESP_OK);
+  CHECK_EQ(esp_timer_start_once(b, 200), ESP_OK);
+  CHECK_EQ(esp_timer_start_once(b, 300), ESP_ERR_INVALID_STATE);  // already running
+  host::advanceUs(1000);
+  CHECK_EQ(fired.size(), (size_t)2);
+  CHECK_EQ(fired[0].first, 2);
+  CHECK_EQ(fired[0].second, (uint64_t)200);
+  CHECK_EQ(fired[1].first, 1);
+  CHECK_EQ(fired[1].second, (uint64_t)500);
+  CHECK_EQ(host::nowUs(), (uint64_t)1000);
+  CHECK_EQ(host::busyUs(), (uint64_t)0);
+}
+
+TEST(delay_is_busy_time_and_timers_fire_inside_it) {
+  fired.clear();
+  esp_timer_handle_t a = makeTimer(7);
+  esp_timer_start_once(a, 300);
+  delay(2);
+  CHECK_EQ(fired.size(), (size_t)1);
+  CHECK_EQ(fired[0].second, (uint64_t)300);
+  CHECK_EQ(millis(), 2UL);
+  CHECK_EQ(host::busyUs(), (uint64_t)2000);
+  CHECK_EQ(esp_timer_stop(a), ESP_ERR_INVALID_STATE);  // one-shot already expired
+}
+
+TEST(millis_wraps_like_the_32_bit_counter) {
+  host::reset(0xFFFFFFFFULL * 1000 - 500);
+  CHECK_EQ(millis(), 0xFFFFFFFEUL);
+  host::advanceUs(2500);
+  CHECK_EQ(millis(), 1UL);
+  CHECK(esp_timer_get_time() > (int64_t)0xFFFFFFFFULL);
+}
+
+static int isrCalls = 0;
+static void countIsr() {
+  isrCalls++;
+}
+
+TEST(pin_edges_fire_the_attached_isr) {
+  isrCalls = 0;
+  pinMode(3, INPUT_PULLUP);
+  CHECK_EQ(digitalRead(3), HIGH);
+  attachInterrupt(digitalPinToInterrupt(3), countIsr, FALLING);
+  host::setPin(3, LOW);
+  CHECK_EQ(isrCalls, 1);
+  host::setPin(3, LOW);  // no edge
+  host::releasePin(3);   // back to the pull-up: rising, not counted
+  CHECK_EQ(isrCalls, 1);
+  CHECK_EQ(digitalRead(3), HIGH);
+  attachInterrupt(3, countIsr, CHANGE);
+  host::setPin(3, LOW);
+  host::setPin(3, HIGH);
+  CHECK_EQ(isrCalls, 3);
+  detachInterrupt(3);
+  host::setPin(3, LOW);
+  CHECK_EQ(isrCalls, 3);
+}
+
+TEST(adc_continuous_frames_are_flagged_at_the_frame_rate) {
+  isrCalls = 0;
+  uint8_t pins[] = { 1, 2 };
+  host::setAnalog(1, 4095);
+  CHECK(analogContinuous(pins, 2, 16, 8000, countIsr));
+  CHECK(analogContinuousStart());
+  host::advanceUs(3999);
+  CHECK_EQ(isrCalls, 0);
+  host::advanceUs(1);
+  CHECK_EQ(isrCalls, 1);
+  host::advanceUs(100000);  // many frames, one flag
+  CHECK_EQ(isrCalls, 2);
+  adc_continuous_data_t* frame = nullptr;
+  CHECK(analogContinuousRead(&frame, 0));
+  CHECK_EQ(frame[0].pin, (uint8_t)1);
+  CHECK_EQ(frame[0].avg_read_raw, 4095);
+
+  host::reset();
+  host::setAdcContinuousAvailable(false);
+  CHECK(!analogContinuous(pins, 2, 16, 8000, countIsr));
+}
+
+TEST(buzzer_changes_are_logged) {
+  ledcAttach(6, 2000, 10);
+  ledcWriteTone(6, 0);  // already silent - not a change
+  host::advanceUs(10);
+  ledcWriteTone(6, 880);
+  host::advanceUs(1000);
+  ledcWriteTone(6, 0);
+  tone(6, 440, 5);
+  host::advanceUs(10000);
+  const std::vector<host::ToneChange>& log = host::toneLog();
+  CHECK_EQ(log.size(), (size_t)4);
+  CHECK_EQ(log[0].freq, 880u);
+  CHECK_EQ(log[0].us, (uint64_t)10);
+  CHECK_EQ(log[1].freq, 0u);
+  CHECK_EQ(log[2].freq, 440u);
+  CHECK_EQ(log[3].freq, 0u);
+  CHECK_EQ(log[3].us - log[2].us, (uint64_t)5000);
+}
+
+TEST(preferences_survive_reset_and_count_real_writes) {
+  {
+    Preferences p;
+    CHECK(p.begin("geniClock", false));
+    CHECK_EQ(p.putUChar("clockType", 1), (size_t)1);
+    CHECK_EQ(p.putUChar("clockType", 1), (size_t)1);  // same value - no flash write
+    uint8_t blob[5] = { 1, 2, 3, 4, 5 };
+    CHECK_EQ(p.putBytes("blob", blob, 5), (size_t)5);
+  }
+  CHECK_EQ(host::nvsWriteCount(), 2u);
+  host::reset();
+  Preferences p;
+  p.begin("geniClock", true);
+  CHECK(p.isKey("clockType"));
+  CHECK_EQ(p.getUChar("clockType", 9), (uint8_t)1);
+  CHECK_EQ(p.getInt("clockType", -1), -1);  // stored as a different type
+  CHECK_EQ(p.getBytesLength("blob"), (size_t)5);
+  uint8_t small[4];
+  CHECK_EQ(p.getBytes("blob", small, 4), (size_t)0);
+  CHECK_EQ(p.putUChar("x", 1), (size_t)0);  // read-only
+  host::nvsErase();
+  CHECK(!p.isKey("clockType"));
+}
+
+TEST(wire_transfers_take_bus_time_and_reach_the_device) {
+  Mcp23017 mcp;
+  host::attachI2c(0x20, &mcp);
+  std::vector<std::pair<uint64_t, uint8_t>> portA;
+  mcp.onOutputs = [&](uint8_t a, uint8_t) {
+    portA.push_back({ host::nowUs(), a });
+  };
+  Wire.begin(4, 5);
+  uint8_t iodir[3] = { Mcp23017::IODIRA, 0x00, 0x00 };
+  Wire.beginTransmission(0x20);
+  Wire.write(iodir, 3);
+  CHECK_EQ(Wire.endTransmission(), (uint8_t)0);
+  // START + address + 3 bytes + STOP at 100 kHz
+  CHECK_EQ(host::nowUs(), (uint64_t)(10 + 9 + 9 + 9 + 1) * 10);
+
+  uint8_t olat[3] = { Mcp23017::OLATA, 0x11, 0x22 };
+  Wire.beginTransmission(0x20);
+  Wire.write(olat, 3);
+  Wire.endTransmission();
+  CHECK_EQ(mcp.portA(), (uint8_t)0x11);
+  CHECK_EQ(mcp.portB(), (uint8_t)0x22);
+  CHECK_EQ(portA.back().second, (uint8_t)0x11);
+
+  Wire.beginTransmission(0x21);
+  CHECK_EQ(Wire.endTransmission(), (uint8_t)2);  // nobody home
+  CHECK_EQ(host::i2cTransactionCount(), (uint64_t)3);
+  CHECK_EQ(host::i2cLog()[1].data.size(), (size_t)3);
+  CHECK_EQ(host::busyUs(), host::nowUs());
+}
+
+TEST(ds3231_keeps_time_through_rtclib) {
+  Ds3231 chip;
+  host::attachI2c(0x68, &chip);
+  Wire.begin();
+  RTC_DS3231 rtc;
+  CHECK(rtc.begin());
+  CHECK(rtc.lostPower());
+  rtc.adjust(DateTime(2025, 3, 30, 1, 59, 58));
+  CHECK(!rtc.lostPower());
+  host::advanceUs(2500000);
+  DateTime now = rtc.now();
+  CHECK_EQ((int)now.hour(), 2);
+  CHECK_EQ((int)now.minute(), 0);
+  CHECK_EQ((int)now.second(), 0);
+  CHECK_EQ((int)now.dayOfTheWeek(), 0);  // Sunday
+  CHECK_EQ(chip.timeWrites(), 1u);
+  CHECK(rtc.getTemperature() == 25.25f);
+
+  chip.setDriftPpm(100);  // 100 ppm fast: +1 s every 10000 s
+  uint32_t before = rtc.now().unixtime();
+  host::advanceUs(10000ULL * 1000000);
+  CHECK_EQ(rtc.now().unixtime() - before, 10001u);
+}
+
+TEST(ds3231_alarm2_pulls_int_until_cleared) {
+  Ds3231 chip;
+  host::attachI2c(0x68, &chip);
+  host::attachDevice(&chip);
+  Wire.begin();
+  RTC_DS3231 rtc;
+  rtc.begin();
+  rtc.adjust(DateTime(2025, 1, 1, 12, 59, 58));
+  chip.connectInt(10);
+  isrCalls = 0;
+  pinMode(10, INPUT_PULLUP);
+  attachInterrupt(10, countIsr, FALLING);
+
+  rtc.writeSqwPinMode(DS3231_OFF);
+  CHECK(rtc.setAlarm2(DateTime(2000, 1, 1, 0, 0, 0), DS3231_A2_Minute));
+  host::advanceUs(1000000);
+  CHECK_EQ(isrCalls, 0);
+  host::advanceUs(1500000);  // 13:00:00 passed
+  CHECK_EQ(isrCalls, 1);
+  CHECK(rtc.alarmFired(2));
+  CHECK(!rtc.alarmFired(1));
+  CHECK_EQ(digitalRead(10), LOW);
+  rtc.clearAlarm(2);
+  CHECK_EQ(digitalRead(10), HIGH);
+  host::advanceUs(3600ULL * 1000000);  // next full hour
+  CHECK_EQ(isrCalls, 2);
+  CHECK_EQ(chip.alarmMatches(2), 2u);
+}
+
+TEST(ds3231_alarm1_date_match) {
+  Ds3231 chip;
+  host::attachI2c(0x68, &chip);
+  host::attachDevice(&chip);
+  chip.connectInt(10);
+  chip.setTime(DateTime(2025, 6, 1, 6, 59, 0));
+  Wire.begin();
+  RTC_DS3231 rtc;
+  rtc.begin();
+  rtc.writeSqwPinMode(DS3231_OFF);
+  rtc.setAlarm1(DateTime(2025, 6, 1, 7, 0, 0), DS3231_A1_Date);
+  host::advanceUs(59500000);
+  CHECK(!rtc.alarmFired(1));
+  host::advanceUs(1000000);
+  CHECK(rtc.alarmFired(1));
+  CHECK_EQ(digitalRead(10), LOW);
+  rtc.disableAlarm(1);  // A1IE off releases INT, the flag stays
+  CHECK_EQ(digitalRead(10), HIGH);
+  CHECK(rtc.alarmFired(1));
+}
+
+TEST(datetime_matches_rtclib_arithmetic) {
+  DateTime t(2024, 2, 29, 23, 59, 59);
+  CHECK(t.isValid());
+  CHECK_EQ(t.unixtime(), 1709251199u);
+  DateTime next = t + TimeSpan(1);
+  CHECK_EQ((int)next.month(), 3);
+  CHECK_EQ((int)next.day(), 1);
+  CHECK(!DateTime(2023, 2, 29, 0, 0, 0).isValid());
+  CHECK_EQ((int)DateTime(0u).year(), 2106);  // pre-2000 epochs wrap, as in the library
+}
+
+static std::string nmea(const std::string& body) {
+  uint8_t sum = 0;
+  for (char c : body) sum ^= (uint8_t)c;
+  char tail[8];
+  snprintf(tail, sizeof(tail), "*%02X\r\n", sum);
+  return "$" + body + tail;
+}
+
+TEST(tinygps_commits_only_checksum_valid_sentences) {
+  TinyGPSPlus gps;
+  std::string good = nmea("GPRMC,123519.00,A,4730.000,N,01903.000,E,010.0,0.0,300325,,,A");
+  std::string bad = good;
+  bad[10] = '9';
+  for (char c : bad) gps.encode(c);
+  CHECK(!gps.date.isValid());
+  CHECK_EQ(gps.failedChecksum(), 1u);
+  int complete = 0;
+  for (char c : good) complete += gps.encode(c);
+  CHECK_EQ(complete, 1);
+  CHECK(gps.location.isValid() && gps.date.isValid() && gps.time.isValid());
+  CHECK_EQ((int)gps.date.year(), 2025);
+  CHECK_EQ((int)gps.date.month(), 3);
+  CHECK_EQ((int)gps.date.day(), 30);
+  CHECK_EQ((int)gps.time.hour(), 12);
+  CHECK_EQ((int)gps.time.second(), 19);
+  CHECK(fabs(gps.location.lat() - 47.5) < 1e-6);
+  CHECK(fabs(gps.speed.kmph() - 18.52) < 1e-6);
+  CHECK_EQ(gps.charsProcessed(), (uint32_t)(good.size() + bad.size()));
+}
+
+TEST(uart_rx_fifo_drops_overflow) {
+  host::uartInject(1, std::string(300, 'x'));
+  CHECK_EQ(host::uartPending(1), (size_t)256);
+  CHECK_EQ(host::uartDropped(1), 44u);
+  HardwareSerial uart(1);
+  CHECK_EQ(uart.read(), (int)'x');
+  Serial.printf("%d-%s", 5, "ok");
+  CHECK_STR(host::serialOutput(), "5-ok");
+}
+
+int main(int argc, char** argv) {
+  return runTests(argc, argv);
+}
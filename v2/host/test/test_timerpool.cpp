@@ -0,0 +1,137 @@
+// TimerPool countdowns under a jittery loop(): every tick() is followed by
+// a random 0..40 ms of blocking work, yet the ring starts on the deadline's
+// microsecond (plus the sequencer's 1 us kick) and the remaining time never
+// accumulates the lateness.
+
+#include <Arduino.h>
+#include "constants.h"
+#include "audio.h"
+#include "melodies.h"
+#include "timerpool.h"
+
+#include "check.h"
+
+const byte PIN = 6;
+const uint32_t RING_FIRST = 1200;  // RING_NOTES[0]
+
+struct Jitter {
+  uint32_t state = 12345;
+  uint32_t nextUs() {
+    state = state * 1103515245u + 12345u;
+    return (state >> 8) % 40000;
+  }
+};
+
+// loop(): tick(), then some blocking work of random length
+static void runJittery(TimerPool& pool, Jitter& jitter, uint64_t untilUs) {
+  while (host::nowUs() < untilUs) {
+    pool.tick();
+    delayMicroseconds(jitter.nextUs());
+  }
+}
+
+// When the buzzer first went to the ring tune at or after 'fromUs'
+static uint64_t ringStartUs(uint64_t fromUs = 0) {
+  for (const host::ToneChange& c : host::toneLog()) {
+    if (c.pin == PIN && c.us >= fromUs && c.freq == RING_FIRST) return c.us;
+  }
+  return 0;
+}
+
+TEST(ring_starts_on_the_deadline_despite_loop_jitter) {
+  AudioSequencer audio;
+  audio.begin(PIN);
+  TimerPool pool(&audio);
+  pool.begin();
+  Jitter jitter;
+
+  runJittery(pool, jitter, 1234567);
+  uint64_t startUs = host::nowUs();
+  pool.set(0, 10 * 1000000LL);
+  pool.start(0);
+  runJittery(pool, jitter, startUs + 10 * 1000000ULL + 100000);
+
+  CHECK_EQ(ringStartUs(), startUs + 10 * 1000000ULL + 1);
+  CHECK_EQ((int)pool.getState(0), (int)PTIMER_RINGING);
+  CHECK(pool.isRinging());
+  pool.dismissRinging();
+  host::advanceUs(1000);
+  CHECK_EQ(host::currentTone(PIN), 0u);
+}
+
+TEST(an_hour_ends_on_time_and_counts_down_exactly) {
+  AudioSequencer audio;
+  audio.begin(PIN);
+  TimerPool pool(&audio);
+  pool.begin();
+  Jitter jitter;
+
+  pool.set(1, 3600 * 1000000LL);
+  pool.start(1);
+  uint64_t deadline = host::nowUs() + 3600 * 1000000ULL;
+  runJittery(pool, jitter, deadline - 2000000);
+  // What the display derives H:M:S from: exact, no per-second rounding carried along
+  CHECK_EQ(pool.getRemainingUs(1), (int64_t)(deadline - host::nowUs()));
+  runJittery(pool, jitter, deadline + 50000);
+  CHECK_EQ(ringStartUs(), deadline + 1);
+}
+
+TEST(several_timers_each_ring_on_their_deadline) {
+  AudioSequencer audio;
+  audio.begin(PIN);
+  TimerPool pool(&audio);
+  pool.begin();
+  Jitter jitter;
+
+  pool.set(0, 5 * 1000000LL);
+  pool.set(1, 2 * 1000000LL);
+  pool.set(2, 8 * 1000000LL);
+  pool.start(0);
+  pool.start(1);
+  pool.start(2);
+  uint64_t t0 = host::nowUs();
+
+  runJittery(pool, jitter, t0 + 2500000);
+  CHECK_EQ(ringStartUs(), t0 + 2000000 + 1);  // timer 1 first
+  CHECK_EQ(pool.firstRinging(), 1);
+  pool.dismissRinging();
+
+  // Timer 0 paused for 1 s on the way: its deadline moves by exactly that
+  runJittery(pool, jitter, t0 + 3000000);
+  uint64_t pausedAt = host::nowUs();
+  pool.pause(0);
+  runJittery(pool, jitter, pausedAt + 1000000);
+  uint64_t resumedAt = host::nowUs();
+  pool.start(0);
+  uint64_t deadline0 = t0 + 5000000 + (resumedAt - pausedAt);
+
+  runJittery(pool, jitter, t0 + 7500000);
+  CHECK_EQ(ringStartUs(t0 + 2500000), deadline0 + 1);
+  CHECK_EQ(pool.firstRinging(), 0);
+  pool.dismissRinging();
+
+  runJittery(pool, jitter, t0 + 9000000);
+  CHECK_EQ(ringStartUs(t0 + 7500000), t0 + 8000000 + 1);
+  pool.dismissRinging();
+}
+
+TEST(cleared_before_the_deadline_never_rings) {
+  AudioSequencer audio;
+  audio.begin(PIN);
+  TimerPool pool(&audio);
+  pool.begin();
+  Jitter jitter;
+
+  pool.set(3, 1000000);
+  pool.start(3);
+  runJittery(pool, jitter, 900000);
+  pool.clear(3);
+  runJittery(pool, jitter, 3000000);
+  CHECK_EQ(ringStartUs(), 0u);
+  CHECK(!pool.isRinging());
+  CHECK_EQ(pool.getRunningCount(), 0);
+}
+
+int main(int argc, char** argv) {
+  return runTests(argc, argv);
+}
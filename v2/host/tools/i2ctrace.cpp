@@ -0,0 +1,104 @@
+// Binary I2C traces (.i2ct, i2ctrace.h) on the command line:
+//
+//   i2ctrace dump <trace>                 one line per transaction, for diff(1):
+//                                         start us,bus us,addr,W|R,status,len,kept bytes hex
+//   i2ctrace delta <old> <new>            per address transactions / bytes / bus time,
+//                                         new against old, and the first transaction
+//                                         that differs; exit 1 if they differ
+//   i2ctrace fromlog <serial log> <prefix>
+//                                         the board's I2CTRACE / I2CB report blocks
+//                                         -> <prefix>-<n>-<label>.i2ct
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "i2crecorder.h"
+
+static bool loadTrace(const char* path, std::vector<i2ct::Record>& records) {
+  std::string bytes, error;
+  if (!i2ct::load(path, bytes)) {
+    std::cerr << "i2ctrace: cannot read " << path << "\n";
+    return false;
+  }
+  if (!i2ct::parse(bytes, records, error)) {
+    std::cerr << "i2ctrace: " << path << ": " << error << "\n";
+    return false;
+  }
+  return true;
+}
+
+static int base64Value(char c) {
+  if (c >= 'A' && c <= 'Z') return c - 'A';
+  if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+  if (c >= '0' && c <= '9') return c - '0' + 52;
+  if (c == '+') return 62;
+  if (c == '/') return 63;
+  return -1;
+}
+
+static void appendBase64(const std::string& text, std::string& out) {
+  uint32_t bits = 0;
+  int count = 0;
+  for (char c : text) {
+    int v = base64Value(c);
+    if (v < 0) continue;  // '=' padding, stray '\r'
+    bits = bits << 6 | v;
+    count += 6;
+    if (count >= 8) {
+      count -= 8;
+      out += (char)(bits >> count & 0xFF);
+    }
+  }
+}
+
+static int fromLog(const char* logPath, const std::string& prefix) {
+  std::ifstream in(logPath);
+  if (!in) {
+    std::cerr << "i2ctrace: cannot read " << logPath << "\n";
+    return 1;
+  }
+  std::vector<std::pair<std::string, std::string>> blocks;  // label, trace
+  for (std::string line; std::getline(in, line);) {
+    size_t at = line.find("I2CTRACE,");  // a log line may carry a timestamp prefix
+    if (at != std::string::npos) {
+      std::string label = line.substr(at + 9);
+      blocks.push_back({ label.substr(0, label.find(',')), "" });
+      continue;
+    }
+    at = line.find("I2CB,");
+    if (at != std::string::npos && !blocks.empty()) appendBase64(line.substr(at + 5), blocks.back().second);
+  }
+  int n = 0;
+  for (const auto& [label, trace] : blocks) {
+    std::string path = prefix + "-" + std::to_string(n++) + "-" + label + ".i2ct";
+    std::vector<i2ct::Record> records;
+    std::string error;
+    if (!i2ct::parse(trace, records, error)) std::cerr << "i2ctrace: " << path << ": " << error << "\n";
+    if (!i2ct::save(path, trace)) {
+      std::cerr << "i2ctrace: cannot write " << path << "\n";
+      return 1;
+    }
+    std::cout << path << ": " << records.size() << " transactions\n";
+  }
+  return 0;
+}
+
+int main(int argc, char** argv) {
+  std::string command = argc > 1 ? argv[1] : "";
+  if (command == "dump" && argc == 3) {
+    std::vector<i2ct::Record> records;
+    if (!loadTrace(argv[2], records)) return 1;
+    for (const i2ct::Record& r : records) std::cout << i2ct::dumpLine(r) << "\n";
+    return 0;
+  }
+  if (command == "delta" && argc == 4) {
+    std::vector<i2ct::Record> before, after;
+    if (!loadTrace(argv[2], before) || !loadTrace(argv[3], after)) return 1;
+    return i2ct::printDelta(before, after) < 0 ? 0 : 1;
+  }
+  if (command == "fromlog" && argc == 4) return fromLog(argv[2], argv[3]);
+  std::cerr << "usage: i2ctrace dump <trace> | delta <old> <new> | fromlog <serial log> <prefix>\n";
+  return 2;
+}
@@ -0,0 +1,63 @@
+// The Arduino builder's .ino -> .cpp step, for the host build: prepend
+// #include <Arduino.h>, declare every top-level function before the first
+// one is defined, and keep #line markers so diagnostics point into the .ino.
+//
+//   ino2cpp <sketch.ino> <out.cpp>
+
+#include <fstream>
+#include <iostream>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+int main(int argc, char** argv) {
+  if (argc != 3) {
+    std::cerr << "usage: ino2cpp <sketch.ino> <out.cpp>\n";
+    return 2;
+  }
+  std::ifstream in(argv[1]);
+  if (!in) {
+    std::cerr << "ino2cpp: cannot read " << argv[1] << "\n";
+    return 1;
+  }
+  std::vector<std::string> lines;
+  for (std::string line; std::getline(in, line);) lines.push_back(line);
+
+  // Definitions start in column 0 with the opening brace on the same line
+  // (the sketch's style): "<type> name(<params>) {"
+  const std::regex definition(R"(^([A-Za-z_][\w:<>,\s\*&]*?[\s\*&]+)([A-Za-z_]\w*)\s*\(([^;{}()]*)\)\s*\{.*$)");
+  const std::regex defaults(R"(\s*=\s*[^,]+)");
+  const std::regex keyword(R"(^(if|else|while|for|switch|return|do|case|struct|class|enum|union|typedef|namespace)\b)");
+
+  std::vector<std::string> prototypes;
+  size_t firstDefinition = lines.size();
+  for (size_t i = 0; i < lines.size(); i++) {
+    std::smatch m;
+    if (lines[i].empty() || lines[i][0] == '#' || std::regex_search(lines[i], keyword)) continue;
+    if (!std::regex_match(lines[i], m, definition)) continue;
+    std::string ret = m[1].str();
+    if (ret.find('=') != std::string::npos) continue;
+    prototypes.push_back(ret + m[2].str() + "(" + std::regex_replace(m[3].str(), defaults, "") + ");");
+    if (firstDefinition == lines.size()) firstDefinition = i;
+  }
+
+  std::ostringstream out;
+  std::string path = argv[1];
+  out << "#include <Arduino.h>\n#line 1 \"" << path << "\"\n";
+  for (size_t i = 0; i < lines.size(); i++) {
+    if (i == firstDefinition) {
+      for (const std::string& p : prototypes) out << p << "\n";
+      out << "#line " << (i + 1) << " \"" << path << "\"\n";
+    }
+    out << lines[i] << "\n";
+  }
+
+  // Only touch the output when it changed - keeps incremental builds quiet
+  std::ifstream old(argv[2]);
+  std::stringstream previous;
+  previous << old.rdbuf();
+  if (old && previous.str() == out.str()) return 0;
+  std::ofstream(argv[2]) << out.str();
+  return 0;
+}